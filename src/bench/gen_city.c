@@ -0,0 +1,336 @@
+// Gerador determinístico de cidades sintéticas para o benchmark do siguel.
+// Gera <nome>.geo, <nome>.pm, <nome>.ec, <nome>.via, os polígonos e um .qry por família de consultas.
+//
+// Uso: gen_city -o <dir> -n <nome> [-scale S] [-qx N] [-qy N] [-ppl N] [-com N] [-prd P]
+//               [-mur N] [-nq N] [-seed N]
+//   -scale  multiplica o número de quadras da cidade base (20 x 20 quadras)
+//   -qx/-qy quadras em cada eixo (sobrepõe -scale); o grafo tem (qx + 1) * (qy + 1) vértices
+//   -ppl    pessoas por quadra (padrão 8)
+//   -com    estabelecimentos comerciais por quadra (padrão 2)
+//   -prd    porcentagem de faces de quadra com prédio (padrão 60)
+//   -mur    muros a cada 10 quadras (padrão 2)
+//   -nq     consultas por família (padrão 50)
+//   -seed   semente do gerador (padrão 7)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define BASE_SIDE 20
+#define BLOCK_W 100
+#define BLOCK_H 80
+#define STEP_X 120
+#define STEP_Y 100
+
+static unsigned long long seed = 7;
+
+// Gerador congruencial linear (mesmos números em qualquer plataforma)
+static unsigned int _next() {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned int) (seed >> 33);
+}
+
+static int _randInt(int lo, int hi) {
+    return lo + (int) (_next() % (unsigned int) (hi - lo + 1));
+}
+
+static double _randDouble() {
+    return _next() / (double) 0x7FFFFFFF;
+}
+
+static FILE *_open(char *dir, char *name, char *ext) {
+    char path[512];
+    snprintf(path, 512, "%s/%s%s", dir, name, ext);
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        exit(1);
+    }
+    return file;
+}
+
+static void _cpf(char *out, int i) {
+    unsigned int v = (unsigned int) i * 7919u % 1000000000u;
+    sprintf(out, "%03u.%03u.%03u-%02u", v / 1000000, v / 1000 % 1000, v % 1000, (unsigned int) i % 100);
+}
+
+static void _cnpj(char *out, int i) {
+    sprintf(out, "%02d.%03d.%03d/0001-%02d", i / 1000000 % 100, i / 1000 % 1000, i % 1000, i % 97);
+}
+
+static const char faces[4] = {'N', 'S', 'L', 'O'};
+static const int nums[4] = {20, 50, 40, 30};
+static const char *names[] = {"Ana", "Bia", "Caio", "Davi", "Eva", "Fabio", "Gil", "Heitor", "Iara", "Joao"};
+static const char *types[] = {"rest", "farm", "pad", "merc", "bar"};
+static const char *colors[] = {"red", "blue", "green", "pink", "gold", "purple"};
+
+static void _randomFace(char *face, int *num) {
+    int k = _randInt(0, 3);
+    *face = faces[k];
+    *num = nums[k];
+}
+
+int main(int argc, char *argv[]) {
+    char *dir = NULL, *name = NULL;
+    double scale = 1;
+    int qx = -1, qy = -1, ppl = 8, com = 2, prd = 60, mur = 2, nq = 50;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printf("O argumento '%s' requer um valor!\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "-o") == 0) dir = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0) name = argv[++i];
+        else if (strcmp(argv[i], "-scale") == 0) scale = atof(argv[++i]);
+        else if (strcmp(argv[i], "-qx") == 0) qx = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-qy") == 0) qy = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-ppl") == 0) ppl = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-com") == 0) com = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-prd") == 0) prd = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-mur") == 0) mur = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-nq") == 0) nq = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-seed") == 0) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            printf("Comando não reconhecido: '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (dir == NULL || name == NULL) {
+        printf("Uso: %s -o <dir> -n <nome> [-scale S] [-qx N] [-qy N] [-ppl N] [-com N] "
+               "[-prd P] [-mur N] [-nq N] [-seed N]\n", argv[0]);
+        return 1;
+    }
+
+    int side = (int) (BASE_SIDE * sqrt(scale) + 0.5);
+    if (qx <= 0)
+        qx = side;
+    if (qy <= 0)
+        qy = side;
+    int nBlocks = qx * qy;
+    int nPeople = nBlocks * ppl;
+    int nCommerces = nBlocks * com;
+    double width = qx * STEP_X + 20, height = qy * STEP_Y + 20;
+
+    /* ---------- .geo ---------- */
+    FILE *geo = _open(dir, name, ".geo");
+    fprintf(geo, "nx 1000 1000 1000 1000 1000 1000 1000\n");
+    fprintf(geo, "cq green black 2\nch red black 1\ncr blue black 1\ncs yellow black 1\n");
+    for (int i = 0; i < 20; i++) {
+        if (i % 2 == 0)
+            fprintf(geo, "c %d %d %.1lf %.1lf %.1lf red blue\n", i, _randInt(5, 40), width * _randDouble(),
+                    height * _randDouble(), 5 + 20 * _randDouble());
+        else
+            fprintf(geo, "r %d %d %.1lf %.1lf %.1lf %.1lf red blue\n", i, _randInt(5, 40), width * _randDouble(),
+                    height * _randDouble(), 10 + 40 * _randDouble(), 10 + 40 * _randDouble());
+    }
+    fprintf(geo, "t 5 5 cidade sintetica\n");
+
+    for (int i = 0; i < qx; i++) {
+        for (int j = 0; j < qy; j++)
+            fprintf(geo, "q b%d.%d %d %d %d %d\n", i, j, 20 + i * STEP_X, 20 + j * STEP_Y, BLOCK_W, BLOCK_H);
+    }
+
+    // Equipamentos nos cruzamentos
+    int nHydrants = 0, nTLights = 0, nCTowers = 0;
+    for (int i = 0; i <= qx; i++) {
+        for (int j = 0; j <= qy; j++) {
+            int x = i * STEP_X + 10, y = j * STEP_Y + 10;
+            double r = _randDouble();
+            if (r < 0.3)
+                fprintf(geo, "h h%d %d %d\n", nHydrants++, x + 3, y + 2);
+            else if (r < 0.5)
+                fprintf(geo, "s s%d %d %d\n", nTLights++, x - 2, y + 3);
+            else if (r < 0.6)
+                fprintf(geo, "rb t%d %d %d\n", nCTowers++, x + 1, y - 3);
+        }
+    }
+    int nEquips = nHydrants + nTLights + nCTowers;
+
+    for (int i = 0; i < qx; i++) {
+        for (int j = 0; j < qy; j++) {
+            for (int k = 0; k < 4; k++) {
+                if (_randInt(0, 99) < prd)
+                    fprintf(geo, "prd b%d.%d %c %d 10 10 5\n", i, j, faces[k], nums[k]);
+            }
+        }
+    }
+
+    int nWalls = nBlocks * mur / 10;
+    for (int k = 0; k < nWalls; k++) {
+        int x = _randInt(0, qx * STEP_X), y = _randInt(0, qy * STEP_Y);
+        fprintf(geo, "mur %d %d %d %d\n", x, y, x + _randInt(5, 40), y);
+    }
+    fclose(geo);
+
+    /* ---------- .pm ---------- */
+    FILE *pm = _open(dir, name, ".pm");
+    char cpf[24], cnpj[32];
+    for (int p = 0; p < nPeople; p++) {
+        _cpf(cpf, p);
+        fprintf(pm, "p %s %s %s %c %02d/%02d/%d\n", cpf, names[_randInt(0, 9)], names[_randInt(0, 9)],
+                _randInt(0, 1) ? 'm' : 'f', _randInt(1, 28), _randInt(1, 12), _randInt(1930, 2019));
+    }
+    for (int p = 0; p < nPeople; p++) {
+        char face;
+        int num;
+        _cpf(cpf, p);
+        _randomFace(&face, &num);
+        fprintf(pm, "m %s b%d.%d %c %d ap%d\n", cpf, _randInt(0, qx - 1), _randInt(0, qy - 1), face, num, p % 10);
+    }
+    fclose(pm);
+
+    /* ---------- .ec ---------- */
+    FILE *ec = _open(dir, name, ".ec");
+    fprintf(ec, "t rest Restaurante\nt farm Farmacia\nt pad Padaria\nt merc Mercado\nt bar Bar\n");
+    for (int c = 0; c < nCommerces; c++) {
+        char face;
+        int num;
+        _cnpj(cnpj, c);
+        _cpf(cpf, _randInt(0, nPeople - 1));
+        _randomFace(&face, &num);
+        fprintf(ec, "e %s %s %s b%d.%d %c %d Loja %d\n", cnpj, cpf, types[_randInt(0, 4)],
+                _randInt(0, qx - 1), _randInt(0, qy - 1), face, num, c);
+    }
+    fclose(ec);
+
+    /* ---------- .via ---------- */
+    FILE *via = _open(dir, name, ".via");
+    for (int i = 0; i <= qx; i++) {
+        for (int j = 0; j <= qy; j++)
+            fprintf(via, "v v%d_%d %d %d\n", i, j, i * STEP_X + 10, j * STEP_Y + 10);
+    }
+    char left[32], right[32];
+    #define BLK(s, i, j) (((i) >= 0 && (i) < qx && (j) >= 0 && (j) < qy) ? \
+                          (sprintf(s, "b%d.%d", i, j), s) : strcpy(s, "-"))
+    for (int i = 0; i <= qx; i++) {
+        for (int j = 0; j <= qy; j++) {
+            if (i < qx) {
+                int speed = 10 * (1 << _randInt(0, 2));
+                BLK(left, i, j);
+                BLK(right, i, j - 1);
+                fprintf(via, "e v%d_%d v%d_%d %s %s %d %d rua_h%d\n", i, j, i + 1, j, left, right, STEP_X, speed, j);
+                fprintf(via, "e v%d_%d v%d_%d %s %s %d %d rua_h%d\n", i + 1, j, i, j, right, left, STEP_X, speed, j);
+            }
+            if (j < qy) {
+                int speed = 10 * (1 << _randInt(0, 2));
+                BLK(left, i - 1, j);
+                BLK(right, i, j);
+                fprintf(via, "e v%d_%d v%d_%d %s %s %d %d av_%d\n", i, j, i, j + 1, left, right, STEP_Y, speed, i);
+                fprintf(via, "e v%d_%d v%d_%d %s %s %d %d av_%d\n", i, j + 1, i, j, right, left, STEP_Y, speed, i);
+            }
+        }
+    }
+    #undef BLK
+    fclose(via);
+
+    /* ---------- Polígonos ---------- */
+    // Um polígono grande (cerca de um quarto da cidade) e um pequeno com muitos vértices
+    FILE *poly = _open(dir, name, "-pol1.txt");
+    fprintf(poly, "%.1lf %.1lf\n%.1lf %.1lf\n%.1lf %.1lf\n%.1lf %.1lf\n%.1lf %.1lf\n",
+            width * 0.1, height * 0.1, width * 0.6, height * 0.12, width * 0.55, height * 0.5,
+            width * 0.3, height * 0.6, width * 0.08, height * 0.4);
+    fclose(poly);
+    poly = _open(dir, name, "-pol2.txt");
+    double cx = width / 2, cy = height / 2, radius = fmin(width, height) / 8;
+    for (int k = 0; k < 64; k++) {
+        double angle = 2 * M_PI * k / 64, r = radius * (k % 2 == 0 ? 1 : 0.7);
+        fprintf(poly, "%.2lf %.2lf\n", cx + r * cos(angle), cy + r * sin(angle));
+    }
+    fclose(poly);
+
+    /* ---------- Consultas, um arquivo por família ---------- */
+    // Leitura: consultas que não alteram a cidade
+    FILE *qry = _open(dir, name, "-leitura.qry");
+    for (int k = 0; k < nq; k++) {
+        char face;
+        int num;
+        _randomFace(&face, &num);
+        switch (k % 10) {
+            case 0: fprintf(qry, "o? %d %d\n", _randInt(0, 19), _randInt(0, 19)); break;
+            case 1: fprintf(qry, "i? %d %.1lf %.1lf\n", _randInt(0, 19), width * _randDouble(), height * _randDouble()); break;
+            case 2: fprintf(qry, "crd? b%d.%d\n", _randInt(0, qx - 1), _randInt(0, qy - 1)); break;
+            case 3: fprintf(qry, "cbq %.1lf %.1lf %d %s\n", width * _randDouble(), height * _randDouble(),
+                            _randInt(50, 400), colors[_randInt(0, 5)]); break;
+            case 4: _cpf(cpf, _randInt(0, nPeople - 1)); fprintf(qry, "dm? %s\n", cpf); break;
+            case 5: _cnpj(cnpj, _randInt(0, nCommerces - 1)); fprintf(qry, "de? %s\n", cnpj); break;
+            case 6: fprintf(qry, "m? b%d.%d\n", _randInt(0, qx - 1), _randInt(0, qy - 1)); break;
+            case 7: fprintf(qry, "fi %.1lf %.1lf %d %d\n", width * _randDouble(), height * _randDouble(),
+                            _randInt(1, 5), _randInt(50, 300)); break;
+            case 8: fprintf(qry, "fh %c%d b%d.%d %c %d\n", _randInt(0, 1) ? '+' : '-', _randInt(1, 5),
+                            _randInt(0, qx - 1), _randInt(0, qy - 1), face, num); break;
+            case 9: fprintf(qry, "fs %d b%d.%d %c %d\n", _randInt(1, 5), _randInt(0, qx - 1),
+                            _randInt(0, qy - 1), face, num); break;
+        }
+    }
+    fclose(qry);
+
+    // Polígonos
+    qry = _open(dir, name, "-poligono.qry");
+    for (int k = 0; k < nq; k++) {
+        int pol = k % 2 + 1;
+        switch (k % 3) {
+            case 0: fprintf(qry, "mplg? %s-pol%d.txt\n", name, pol); break;
+            case 1: fprintf(qry, "eplg? %s-pol%d.txt %s\n", name, pol, types[_randInt(0, 4)]); break;
+            case 2: fprintf(qry, "eplg? %s-pol%d.txt *\n", name, pol); break;
+        }
+    }
+    fclose(qry);
+
+    // Caminhos: registradores em endereços e pontos aleatórios
+    qry = _open(dir, name, "-caminho.qry");
+    for (int k = 0; k < nq; k++) {
+        char face;
+        int num;
+        _randomFace(&face, &num);
+        fprintf(qry, "@e? R1 b%d.%d %c %d\n", _randInt(0, qx - 1), _randInt(0, qy - 1), face, num);
+        fprintf(qry, "@xy R2 %.1lf %.1lf\n", width * _randDouble(), height * _randDouble());
+        fprintf(qry, "p? rota%d R1 R2 red blue\n", k);
+    }
+    fclose(qry);
+
+    // Visibilidade (custo alto, poucas linhas)
+    qry = _open(dir, name, "-visibilidade.qry");
+    for (int k = 0; k < nq / 10 + 1; k++) {
+        if (k % 2 == 0)
+            fprintf(qry, "brl %.1lf %.1lf\n", width * _randDouble(), height * _randDouble());
+        else
+            fprintf(qry, "brn %.1lf %.1lf %s-brn%d.txt\n", width * _randDouble(), height * _randDouble(), name, k);
+    }
+    fclose(qry);
+
+    // Alterações: translações e mudanças de endereço
+    qry = _open(dir, name, "-alteracao.qry");
+    for (int k = 0; k < nq; k++) {
+        char face;
+        int num;
+        _randomFace(&face, &num);
+        switch (k % 3) {
+            case 0: fprintf(qry, "trns %.1lf %.1lf %.1lf %.1lf %d %d\n", width * _randDouble(), height * _randDouble(),
+                            width * 0.2, height * 0.2, _randInt(-5, 5), _randInt(-5, 5)); break;
+            case 1: _cpf(cpf, _randInt(0, nPeople - 1));
+                    fprintf(qry, "mud %s b%d.%d %c %d apx\n", cpf, _randInt(0, qx - 1), _randInt(0, qy - 1), face, num); break;
+            case 2: fprintf(qry, "cbq %.1lf %.1lf %d red\n", width * _randDouble(), height * _randDouble(), _randInt(50, 300)); break;
+        }
+    }
+    fclose(qry);
+
+    // Remoções (separadas das mudanças de endereço, que não podem apontar para quadras removidas)
+    qry = _open(dir, name, "-remocao.qry");
+    for (int k = 0; k < nq; k++) {
+        if (k % 2 == 0)
+            fprintf(qry, "dq L%d h%d %d\n", _randInt(1, 2), _randInt(0, nHydrants - 1), _randInt(50, 200));
+        else
+            fprintf(qry, "del b%d.%d\n", _randInt(0, qx - 1), _randInt(0, qy - 1));
+    }
+    fclose(qry);
+
+    printf("%s: %d quadras, %d equipamentos, %d muros, %d pessoas, %d comércios, %d vértices\n",
+           name, nBlocks, nEquips, nWalls, nPeople, nCommerces, (qx + 1) * (qy + 1));
+    return 0;
+}
@@ -0,0 +1,52 @@
+#!/bin/sh
+# Benchmark do siguel: gera cidades sintéticas em várias escalas e mede o carregamento,
+# o SVG base e cada família de consultas (usando o resumo do -stats).
+#
+# Uso (a partir de src/): sh bench/run_bench.sh
+# Variáveis: SCALES (padrão "1 10 100"), NQ (consultas por família, padrão 50), OUT (padrão bench_out)
+
+SCALES=${SCALES:-"1 10 100"}
+NQ=${NQ:-50}
+OUT=${OUT:-bench_out}
+SIGUEL=./siguel
+GEN=bench/gen_city
+FAMILIES="leitura poligono caminho visibilidade alteracao remocao"
+
+if [ ! -x "$SIGUEL" ] || [ ! -x "$GEN" ]; then
+    echo "Compile antes com 'make bench'"
+    exit 1
+fi
+
+mkdir -p "$OUT"
+SUMMARY="$OUT/resumo.txt"
+printf "%-8s %-14s %12s %8s\n" "escala" "etapa" "total(ms)" "linhas" > "$SUMMARY"
+
+for scale in $SCALES; do
+    dir="$OUT/x$scale"
+    rm -rf "$dir"
+    mkdir -p "$dir/saida"
+    $GEN -o "$dir" -n cidade -scale "$scale" -nq "$NQ" || exit 1
+
+    for family in $FAMILIES; do
+        stats="stats-$family.txt"
+        if ! $SIGUEL -e "$dir" -f cidade.geo -pm cidade.pm -ec cidade.ec -v cidade.via \
+                -q "cidade-$family.qry" -o "$dir/saida" -stats "$stats" > "$dir/saida/$family.log" 2>&1; then
+            echo "Falha: escala $scale, família $family (veja $dir/saida/$family.log)"
+            continue
+        fi
+
+        # Carregamento e SVG base são medidos apenas uma vez por escala
+        if [ "$family" = "leitura" ]; then
+            awk -v s="$scale" '$1 ~ /^\(/ { printf "%-8s %-14s %12.3f %8d\n", s, $1, $3, $2 }' \
+                "$dir/saida/$stats" >> "$SUMMARY"
+        fi
+        # Soma das linhas de consulta (tudo que não é etapa de carregamento)
+        awk -v s="$scale" -v f="$family" '
+            /^Linhas mais lentas/ { exit }
+            NR > 1 && NF > 0 && $1 !~ /^\(/ { total += $3; n += $2 }
+            END { printf "%-8s %-14s %12.3f %8d\n", s, f, total, n }' \
+            "$dir/saida/$stats" >> "$SUMMARY"
+    done
+done
+
+cat "$SUMMARY"
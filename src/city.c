@@ -0,0 +1,272 @@
+#include "city.h"
+
+typedef struct city_t {
+    RBTree objTree;
+    RBTree textTree;
+    RBTree blockTree;
+    RBTree hydTree;
+    RBTree cTowerTree;
+    RBTree tLightTree;
+    RBTree buildingTree;
+    RBTree wallTree;
+    RBTree nodeTree;
+
+    HashTable blockTable;
+    HashTable objTable;
+    HashTable hydTable;
+    HashTable cTowerTable;
+    HashTable tLightTable;
+    HashTable commTypeTable;
+    HashTable commerceTable;
+    IntTable personTable;
+    HashTable nodeTable;
+
+    unsigned long version;
+    unsigned long graphVersion;
+    unsigned long equipVersion;
+    int nodeCount;
+    int landmarkCount;
+    Landmarks landmarks;
+    int partitionCellSize;
+    RoutePartition partition;
+    PathTreeCache pathTreeCache;
+    int searchThreads;
+    FacilityMapCache facilityMaps;
+} *CityImpl;
+
+City City_Create() {
+    CityImpl city = malloc(sizeof(struct city_t));
+
+    city->objTree = RBTree_Create(Point_Compare);
+    city->textTree = RBTree_Create(Point_Compare);
+    city->blockTree = RBTree_Create(Point_Compare);
+    city->hydTree = RBTree_Create(Point_Compare);
+    city->cTowerTree = RBTree_Create(Point_Compare);
+    city->tLightTree = RBTree_Create(Point_Compare);
+    city->buildingTree = RBTree_Create(Point_Compare);
+    city->wallTree = RBTree_Create(Point_Compare);
+    city->nodeTree = RBTree_Create(Point_Compare);
+
+    city->blockTable = HashTable_Create(1001);
+    city->objTable = HashTable_Create(1001);
+    city->hydTable = HashTable_Create(1001);
+    city->cTowerTable = HashTable_Create(1001);
+    city->tLightTable = HashTable_Create(1001);
+
+    city->commTypeTable = HashTable_Create(1001);
+    city->commerceTable = HashTable_Create(1001);
+    city->personTable = IntTable_Create(1024);
+
+    city->nodeTable = HashTable_Create(1001);
+
+    city->version = 0;
+    city->graphVersion = 0;
+    city->equipVersion = 0;
+    city->nodeCount = 0;
+    city->landmarkCount = 0;
+    city->landmarks = NULL;
+    city->partitionCellSize = 0;
+    city->partition = NULL;
+    city->pathTreeCache = PathTreeCache_Create(CITY_PATH_TREES);
+    city->searchThreads = 0;
+    city->facilityMaps = FacilityMapCache_Create(CITY_FACILITY_MAPS);
+    return city;
+}
+
+void City_Destroy(City cityVoid) {
+    CityImpl city = (CityImpl) cityVoid;
+
+    HashTable_Destroy(city->blockTable, NULL);
+    HashTable_Destroy(city->objTable, NULL);
+    HashTable_Destroy(city->hydTable, NULL);
+    HashTable_Destroy(city->cTowerTable, NULL);
+    HashTable_Destroy(city->tLightTable, NULL);
+
+    HashTable_Destroy(city->commTypeTable, CommerceType_Destroy);
+    HashTable_Destroy(city->commerceTable, Commerce_Destroy);
+    IntTable_Destroy(city->personTable, Person_Destroy);
+
+    HashTable_Destroy(city->nodeTable, GraphNode_Destroy);
+
+    RBTree_Destroy(city->objTree, Object_Destroy);
+    RBTree_Destroy(city->textTree, Text_Destroy);
+    RBTree_Destroy(city->blockTree, Block_Destroy);
+    RBTree_Destroy(city->hydTree, Equip_Destroy);
+    RBTree_Destroy(city->cTowerTree, Equip_Destroy);
+    RBTree_Destroy(city->tLightTree, Equip_Destroy);
+    RBTree_Destroy(city->buildingTree, Building_Destroy);
+    RBTree_Destroy(city->wallTree, Wall_Destroy);
+    RBTree_Destroy(city->nodeTree, NULL);
+    if (city->landmarks != NULL)
+        Landmarks_Destroy(city->landmarks);
+    if (city->partition != NULL)
+        RoutePartition_Destroy(city->partition);
+    PathTreeCache_Destroy(city->pathTreeCache);
+    FacilityMapCache_Destroy(city->facilityMaps);
+
+    free(city);
+}
+
+unsigned long City_GetVersion(City city) {
+    return ((CityImpl) city)->version;
+}
+
+void City_AdvanceVersion(City city) {
+    ((CityImpl) city)->version++;
+}
+
+unsigned long City_GetGraphVersion(City city) {
+    return ((CityImpl) city)->graphVersion;
+}
+
+void City_AdvanceGraphVersion(City city) {
+    ((CityImpl) city)->graphVersion++;
+}
+
+unsigned long City_GetEquipVersion(City city) {
+    return ((CityImpl) city)->equipVersion;
+}
+
+void City_AdvanceEquipVersion(City city) {
+    ((CityImpl) city)->equipVersion++;
+}
+
+int City_NewNodeIndex(City city) {
+    return ((CityImpl) city)->nodeCount++;
+}
+
+int City_GetNodeCount(City city) {
+    return ((CityImpl) city)->nodeCount;
+}
+
+void City_SetLandmarkCount(City city, int count) {
+    ((CityImpl) city)->landmarkCount = count;
+}
+
+int City_GetLandmarkCount(City city) {
+    return ((CityImpl) city)->landmarkCount;
+}
+
+void City_SetLandmarks(City cityVoid, Landmarks landmarks) {
+    CityImpl city = (CityImpl) cityVoid;
+    if (city->landmarks != NULL)
+        Landmarks_Destroy(city->landmarks);
+    city->landmarks = landmarks;
+}
+
+Landmarks City_GetLandmarks(City city) {
+    return ((CityImpl) city)->landmarks;
+}
+
+void City_SetPartitionCellSize(City city, int cellSize) {
+    ((CityImpl) city)->partitionCellSize = cellSize;
+}
+
+int City_GetPartitionCellSize(City city) {
+    return ((CityImpl) city)->partitionCellSize;
+}
+
+void City_SetRoutePartition(City cityVoid, RoutePartition partition) {
+    CityImpl city = (CityImpl) cityVoid;
+    if (city->partition != NULL)
+        RoutePartition_Destroy(city->partition);
+    city->partition = partition;
+}
+
+RoutePartition City_GetRoutePartition(City city) {
+    return ((CityImpl) city)->partition;
+}
+
+void City_SetPathTreeCapacity(City cityVoid, int capacity) {
+    CityImpl city = (CityImpl) cityVoid;
+    PathTreeCache_Destroy(city->pathTreeCache);
+    city->pathTreeCache = PathTreeCache_Create(capacity);
+}
+
+PathTreeCache City_GetPathTreeCache(City city) {
+    return ((CityImpl) city)->pathTreeCache;
+}
+
+void City_SetSearchThreads(City city, int threads) {
+    ((CityImpl) city)->searchThreads = threads;
+}
+
+int City_GetSearchThreads(City city) {
+    return ((CityImpl) city)->searchThreads;
+}
+
+FacilityMapCache City_GetFacilityMaps(City city) {
+    return ((CityImpl) city)->facilityMaps;
+}
+
+RBTree City_GetObjTree(City city) {
+    return ((CityImpl) city)->objTree;
+}
+
+HashTable City_GetObjTable(City city) {
+    return ((CityImpl) city)->objTable;
+}
+
+RBTree City_GetTextTree(City city) {
+    return ((CityImpl) city)->textTree;
+}
+
+RBTree City_GetBlockTree(City city) {
+    return ((CityImpl) city)->blockTree;
+}
+
+HashTable City_GetBlockTable(City city) {
+    return ((CityImpl) city)->blockTable;
+}
+
+RBTree City_GetHydTree(City city) {
+    return ((CityImpl) city)->hydTree;
+}
+
+RBTree City_GetCTowerTree(City city) {
+    return ((CityImpl) city)->cTowerTree;
+}
+
+RBTree City_GetTLightTree(City city) {
+    return ((CityImpl) city)->tLightTree;
+}
+
+RBTree City_GetBuildingTree(City city) {
+    return ((CityImpl) city)->buildingTree;
+}
+
+RBTree City_GetWallTree(City city) {
+    return ((CityImpl) city)->wallTree;
+}
+
+RBTree City_GetNodeTree(City city) {
+    return ((CityImpl) city)->nodeTree;
+}
+
+HashTable City_GetHydTable(City city) {
+    return ((CityImpl) city)->hydTable;
+}
+
+HashTable City_GetCTowerTable(City city) {
+    return ((CityImpl) city)->cTowerTable;
+}
+
+HashTable City_GetTLightTable(City city) {
+    return ((CityImpl) city)->tLightTable;
+}
+
+HashTable City_GetCommTypeTable(City city) {
+    return ((CityImpl) city)->commTypeTable;
+}
+
+HashTable City_GetCommerceTable(City city) {
+    return ((CityImpl) city)->commerceTable;
+}
+
+IntTable City_GetPersonTable(City city) {
+    return ((CityImpl) city)->personTable;
+}
+
+HashTable City_GetNodeTable(City city) {
+    return ((CityImpl) city)->nodeTable;
+}
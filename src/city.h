@@ -0,0 +1,137 @@
+#ifndef CITY_H
+#define CITY_H
+
+#include "modules/aux/graph_node.h"
+#include "modules/aux/facility_map.h"
+#include "modules/aux/landmarks.h"
+#include "modules/aux/path_tree.h"
+#include "modules/aux/route_partition.h"
+#include "modules/data_structures/hash_table.h"
+#include "modules/data_structures/int_table.h"
+#include "modules/data_structures/redblack_tree.h"
+#include "modules/sig/object.h"
+#include "modules/sig/text.h"
+#include "modules/sig/block.h"
+#include "modules/sig/equipment.h"
+#include "modules/sig/building.h"
+#include "modules/sig/wall.h"
+#include "modules/sig/commerce_type.h"
+
+// Cidade: dona de todas as árvores e tabelas (formas, quadras, equipamentos, prédios, muros,
+// pessoas, estabelecimentos e o grafo de ruas). Carregadores, consultas, busca de caminhos e
+// escrita de SVG recebem a cidade explicitamente, então várias cidades podem coexistir.
+//
+// Segurança entre threads: uma cidade não tem trava própria. Operações de leitura (buscas e
+// percursos nas árvores e tabelas, consultas de isReadOnlyCommand e a busca de caminhos, que
+// guarda seu estado fora dos vértices) podem rodar ao mesmo tempo em várias threads, desde que
+// nenhuma outra thread altere a mesma cidade nesse intervalo. Quem altera precisa de acesso
+// exclusivo (o servidor usa uma trava leitores/escritor para isso)
+typedef void *City;
+
+// Árvores de caminhos mínimos guardadas por padrão (ver PathTreeCache)
+#define CITY_PATH_TREES 8
+
+// Posições do cache de mapas de equipamento mais próximo: tipo (hidrante, semáforo, rádio-base)
+// e métrica
+#define CITY_FACILITY_MAPS 6
+
+City City_Create();
+
+void City_Destroy(City city);
+
+// Versão dos dados da cidade, avançada a cada comando que altera árvores, tabelas ou elementos
+unsigned long City_GetVersion(City city);
+
+void City_AdvanceVersion(City city);
+
+// Versão do grafo de ruas, avançada só quando custos de arestas mudam (brn)
+unsigned long City_GetGraphVersion(City city);
+
+void City_AdvanceGraphVersion(City city);
+
+// Versão dos equipamentos e das ruas, da qual dependem os mapas de equipamento mais próximo:
+// avançada só por comandos que movem ou removem equipamentos ou quadras (trns, del, dq, catac) ou
+// mudam custos de arestas (brn), e não pelas demais alterações
+unsigned long City_GetEquipVersion(City city);
+
+void City_AdvanceEquipVersion(City city);
+
+// Índice para um novo vértice do grafo (usado pela busca de caminhos para indexar seu estado)
+int City_NewNodeIndex(City city);
+
+// Quantidade de índices de vértice já distribuídos
+int City_GetNodeCount(City city);
+
+// Quantidade de marcos (ALT) escolhidos depois que o grafo de ruas é carregado; 0 (padrão) desativa
+void City_SetLandmarkCount(City city, int count);
+
+int City_GetLandmarkCount(City city);
+
+// Marcos calculados para o grafo (NULL se desativados); a cidade passa a ser dona deles
+void City_SetLandmarks(City city, Landmarks landmarks);
+
+Landmarks City_GetLandmarks(City city);
+
+// Vértices por célula do índice de rotas por partição, calculado depois que o grafo de ruas é
+// carregado; 0 (padrão) desativa
+void City_SetPartitionCellSize(City city, int cellSize);
+
+int City_GetPartitionCellSize(City city);
+
+// Índice de rotas por partição (NULL se desativado); a cidade passa a ser dona dele
+void City_SetRoutePartition(City city, RoutePartition partition);
+
+RoutePartition City_GetRoutePartition(City city);
+
+// Troca o cache de árvores de caminhos mínimos por um com 'capacity' árvores (0 desativa)
+void City_SetPathTreeCapacity(City city, int capacity);
+
+PathTreeCache City_GetPathTreeCache(City city);
+
+// Threads do delta-stepping nas buscas de árvore completa (matrizes, alcance, mapas de
+// equipamento); 0 (padrão) usa o Dijkstra
+void City_SetSearchThreads(City city, int threads);
+
+int City_GetSearchThreads(City city);
+
+// Mapas de equipamento mais próximo pelas ruas, válidos para uma versão dos equipamentos (City_GetEquipVersion)
+FacilityMapCache City_GetFacilityMaps(City city);
+
+RBTree City_GetObjTree(City city);
+
+HashTable City_GetObjTable(City city);
+
+RBTree City_GetTextTree(City city);
+
+RBTree City_GetBlockTree(City city);
+
+HashTable City_GetBlockTable(City city);
+
+RBTree City_GetHydTree(City city);
+
+RBTree City_GetCTowerTree(City city);
+
+RBTree City_GetTLightTree(City city);
+
+RBTree City_GetBuildingTree(City city);
+
+RBTree City_GetWallTree(City city);
+
+RBTree City_GetNodeTree(City city);
+
+HashTable City_GetHydTable(City city);
+
+HashTable City_GetCTowerTable(City city);
+
+HashTable City_GetTLightTable(City city);
+
+HashTable City_GetCommTypeTable(City city);
+
+HashTable City_GetCommerceTable(City city);
+
+// Pessoas indexadas pela chave do CPF (Person_EncodeCpf)
+IntTable City_GetPersonTable(City city);
+
+HashTable City_GetNodeTable(City city);
+
+#endif
@@ -1,16 +1,11 @@
 #include <string.h>
+#include <pthread.h>
 #include "commands.h"
 #include "modules/util/file_util.h"
 
-bool processGeometry(FILE *entryFile);
+bool processGeometry(City city, FILE *entryFile);
 
-bool processCommerces(FILE *ecFile);
-
-bool processPeople(FILE *pmFile);
-
-bool processStreets(FILE *viaFile);
-
-bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir[], char outputDir[], 
+bool processQuery(City city, FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir[], char outputDir[], 
                   char svgFileName[], PathFindMode pathMode, PathStack *pathStack);
 
 void writeObject(Object o, void *param) {
@@ -27,45 +22,394 @@ void writeText(Text text, void *param) {
     putSVGText(svgFile, Text_GetX(text), Text_GetY(text), Text_GetString(text));
 }
 
-void writeSVG(FILE *outputSVGFile, bool svgTag) {
+void writeSVG(City city, FILE *outputSVGFile, bool svgTag) {
     if (svgTag)
         putSVGStart(outputSVGFile);
-    RBTree_Execute(getObjTree(), writeObject, outputSVGFile);
-    RBTree_Execute(getTextTree(), writeText, outputSVGFile);
-    RBTree_Execute(getBlockTree(), putSVGBlock, outputSVGFile);
-    RBTree_Execute(getBuildingTree(), putSVGBuilding, outputSVGFile);
-    RBTree_Execute(getWallTree(), putSVGWall, outputSVGFile);
-    RBTree_Execute(getHydTree(), putSVGHydrant, outputSVGFile);
-    RBTree_Execute(getTLightTree(), putSVGTrafficLight, outputSVGFile);
-    RBTree_Execute(getCTowerTree(), putSVGCellTower, outputSVGFile);
+    RBTree_Execute(City_GetObjTree(city), writeObject, outputSVGFile);
+    RBTree_Execute(City_GetTextTree(city), writeText, outputSVGFile);
+    RBTree_Execute(City_GetBlockTree(city), putSVGBlock, outputSVGFile);
+    RBTree_Execute(City_GetBuildingTree(city), putSVGBuilding, outputSVGFile);
+    RBTree_Execute(City_GetWallTree(city), putSVGWall, outputSVGFile);
+    RBTree_Execute(City_GetHydTree(city), putSVGHydrant, outputSVGFile);
+    RBTree_Execute(City_GetTLightTree(city), putSVGTrafficLight, outputSVGFile);
+    RBTree_Execute(City_GetCTowerTree(city), putSVGCellTower, outputSVGFile);
     if (svgTag)
         putSVGEnd(outputSVGFile);
 }
 
-void processAll(Files files) {
-    processGeometry(Files_GetEntryFile(files));
-    writeSVG(Files_GetOutputSVGFile(files), true);
+// Carregamento dos arquivos .pm, .ec e .via em duas fases. Na leitura, cada arquivo é convertido
+// por uma thread própria (e, se for grande, em blocos paralelos, ver LineParser_ParseFile) em um
+// vetor de registros na ordem do arquivo, sem tocar na cidade, enquanto a thread principal carrega
+// o .geo. Na ligação, os registros viram elementos da cidade: ruas numa
+// thread, pessoas e depois estabelecimentos em outra. As duas não compartilham dados da cidade (as
+// ruas guardam só os CEPs das quadras, no conjunto de strings, que tem trava própria)
+
+// Linha 'p' (pessoa já criada) ou 'm' (person == NULL) do .pm
+typedef struct people_record_t {
+    Person person;
+    char cpf[16], cep[24], face, complement[16];
+    int num;
+} PeopleRecord;
+
+// Linha 't' (tipo já criado) ou 'e' (type == NULL) do .ec
+typedef struct commerce_record_t {
+    CommerceType type;
+    char cnpj[24], cpf[16], codt[16], cep[24], face, name[64];
+    int num;
+} CommerceRecord;
+
+// Linha 'v' (vértice 'i' em x, y) ou 'e' (aresta de 'i' para 'j') do .via
+typedef struct street_record_t {
+    char type;
+    char i[32], j[32], cepLeft[24], cepRight[24], name[64];
+    double x, y, length, speed;
+} StreetRecord;
+
+typedef struct load_job_t {
+    FILE *file;
+    char *statsType, *statsLine;
+    void (*parseLine)(char *line, RecordList *records);
+    RecordList records;
+    pthread_t thread;
+    bool threaded;
+    bool statsPaused;      // estado da coleta na thread que iniciou a leitura
+} LoadJob;
+
+static void _parsePeopleLine(char *line, RecordList *records) {
+    char type[16];
+    if (sscanf(line, "%15s", type) != 1)
+        return;
+
+    if (strcmp(type, "p") == 0) {
+        char cpf[16], name[32], surname[32], sex, birthDate[16];
+        sscanf(line + 2, "%s %s %s %c %s", cpf, name, surname, &sex, birthDate);
+
+        Person person = Person_Create(cpf, name, surname, sex, birthDate);
+        if (person == NULL) {
+            printf("Erro: CPF inválido: %s\n", cpf);
+            return;
+        }
+
+        PeopleRecord *record = RecordList_Append(records);
+        record->person = person;
+    } else if (strcmp(type, "m") == 0) {
+        PeopleRecord *record = RecordList_Append(records);
+        record->person = NULL;
+        sscanf(line + 1, "%s %s %c %d %s", record->cpf, record->cep, &record->face, 
+               &record->num, record->complement);
+    }
+}
+
+static void _parseCommercesLine(char *line, RecordList *records) {
+    char type[16];
+    if (sscanf(line, "%15s", type) != 1)
+        return;
+
+    if (strcmp(type, "t") == 0) {
+        char codt[16], desc[64];
+        sscanf(line + 2, "%s %63[^\n]", codt, desc);
+
+        CommerceRecord *record = RecordList_Append(records);
+        record->type = CommerceType_Create(codt, desc);
+    } else if (strcmp(type, "e") == 0) {
+        CommerceRecord *record = RecordList_Append(records);
+        record->type = NULL;
+        sscanf(line + 2, "%s %s %s %s %c %d %63[^\n]", record->cnpj, record->cpf, record->codt, 
+               record->cep, &record->face, &record->num, record->name);
+    }
+}
+
+static void _parseStreetsLine(char *line, RecordList *records) {
+    char type[16];
+    if (sscanf(line, "%15s", type) != 1)
+        return;
+
+    if (strcmp(type, "v") == 0) {
+        StreetRecord *record = RecordList_Append(records);
+        record->type = 'v';
+        sscanf(line + 2, "%s %lf %lf", record->i, &record->x, &record->y);
+    } else if (strcmp(type, "e") == 0) {
+        StreetRecord *record = RecordList_Append(records);
+        record->type = 'e';
+        sscanf(line + 2, "%s %s %s %s %lf %lf %s", record->i, record->j, record->cepRight, 
+               record->cepLeft, &record->length, &record->speed, record->name);
+    }
+}
+
+static void *_runParse(void *jobVoid) {
+    LoadJob *job = (LoadJob *) jobVoid;
+    Stats_SetPaused(job->statsPaused);
+    Stats_Begin(job->statsType, job->statsLine, 0);
+    LineParser_ParseFile(job->file, job->parseLine, &job->records);
+    Stats_End();
+    return NULL;
+}
+
+static void _linkPeople(City city, RecordList *records) {
+    PeopleRecord *items = records->items;
+    for (int r = 0; r < records->length; r++) {
+        PeopleRecord *record = &items[r];
+
+        if (record->person != NULL) {
+            Person person = record->person;
+            Person replaced = IntTable_Insert(City_GetPersonTable(city), Person_GetCpfKey(person), person);
+            if (replaced != NULL) {
+                Building building = Person_GetBuilding(replaced);
+                if (building != NULL)
+                    Building_RemoveResident(building, replaced);
+                Block block = Person_GetBlock(replaced);
+                if (block != NULL) {
+                    Block_RemoveResident(block, replaced);
+                }
+                Person_Destroy(replaced);
+            }
+        } else {
+            Person person = IntTable_Find(City_GetPersonTable(city), Person_EncodeCpf(record->cpf));
+            if (person == NULL) {
+                printf("Erro: Pessoa de CPF %s não encontrada!\n", record->cpf);
+                continue;
+            }
+
+            char address[64];
+            Building_MakeAddress(address, record->cep, record->face, record->num);
+
+            Block block = HashTable_Find(City_GetBlockTable(city), record->cep);
+            if (block == NULL) {
+                printf("Erro: Quadra de CEP %s não encontrada!\n", record->cep);
+                continue;
+            }
+
+            Person_SetBlock(person, block);
+            Person_SetAddress(person, record->cep, record->face, record->num);
+            Person_SetComplement(person, record->complement);
+
+            RBTree buildings = Block_GetBuildings(block);
+            Building building = RBTree_Find(buildings, address);
+            if (building != NULL) {
+                Building_InsertResident(building, person);
+                Person_SetBuilding(person, building);
+            }
+
+            Block_InsertResident(block, person);
+        }
+    }
+}
+
+static void _linkCommerces(City city, RecordList *records) {
+    CommerceRecord *items = records->items;
+    for (int r = 0; r < records->length; r++) {
+        CommerceRecord *record = &items[r];
+
+        if (record->type != NULL) {
+            // Tipo repetido: só atualiza a descrição, mantendo os estabelecimentos que já o usam
+            CommerceType existing = HashTable_Find(City_GetCommTypeTable(city), 
+                                                   CommerceType_GetCode(record->type));
+            if (existing != NULL) {
+                CommerceType_SetDescription(existing, CommerceType_GetDescription(record->type));
+                CommerceType_Destroy(record->type);
+            } else {
+                HashTable_Insert(City_GetCommTypeTable(city), CommerceType_GetCode(record->type), record->type);
+            }
+            continue;
+        }
+
+        CommerceType cType = HashTable_Find(City_GetCommTypeTable(city), record->codt);
+        if (cType == NULL) {
+            printf("Erro: Tipo de estabelecimento não encontrado: %s\n", record->codt);
+            continue;
+        }
+
+        char address[64];
+        Building_MakeAddress(address, record->cep, record->face, record->num);
+
+        Block block = HashTable_Find(City_GetBlockTable(city), record->cep);
+        if (block == NULL) {
+            printf("Erro: Quadra de CEP %s não encontrada!\n", record->cep);
+            continue;
+        }
 
-    if (Files_GetPmFile(files) != NULL)
-        processPeople(Files_GetPmFile(files));
-    if (Files_GetEcFile(files) != NULL)
-        processCommerces(Files_GetEcFile(files));
-    if (Files_GetViaFile(files) != NULL)
-        processStreets(Files_GetViaFile(files));
+        RBTree buildings = Block_GetBuildings(block);
+        Building building = RBTree_Find(buildings, address);
+
+        Person person = IntTable_Find(City_GetPersonTable(city), Person_EncodeCpf(record->cpf));
+        if (person == NULL) {
+            printf("Erro: Pessoa de CPF %s não encontrada!\n", record->cpf);
+        }
+
+        Commerce commerce = Commerce_Create(cType, address, block, building, record->name, record->cnpj, person);
+        Commerce replaced = HashTable_Insert(City_GetCommerceTable(city), Commerce_GetCnpj(commerce), commerce);
+        if (replaced != NULL) {
+            if (Commerce_GetBuilding(replaced) != NULL)
+                Building_RemoveCommerce(Commerce_GetBuilding(replaced), replaced);
+            Block_RemoveCommerce(Commerce_GetBlock(replaced), replaced);
+            CommerceType_RemoveCommerce(Commerce_GetType(replaced), replaced);
+            Commerce_Destroy(replaced);
+        }
+
+        if (building != NULL)
+            Building_InsertCommerce(building, commerce);
+        Block_InsertCommerce(block, commerce);
+        CommerceType_InsertCommerce(cType, commerce, Block_GetX(block), Block_GetY(block),
+                                    Block_GetW(block), Block_GetH(block));
+    }
+}
+
+static void _linkStreets(City city, RecordList *records) {
+    StreetRecord *items = records->items;
+    for (int r = 0; r < records->length; r++) {
+        StreetRecord *record = &items[r];
+
+        if (record->type == 'v') {
+            GraphNode node = GraphNode_Create(record->i, record->x, record->y, City_NewNodeIndex(city));
+
+            RBTree_Insert(City_GetNodeTree(city), GraphNode_GetPoint(node), node);
+            GraphNode replaced = HashTable_Insert(City_GetNodeTable(city), GraphNode_GetId(node), node);
+            if (replaced != NULL) {
+                GraphNode_Destroy(replaced);
+            }
+        } else {
+            GraphNode node1 = HashTable_Find(City_GetNodeTable(city), record->i);
+            if (node1 == NULL) {
+                printf("Vértice não encontrado: %s!\n", record->i);
+                continue;
+            }
+            GraphNode node2 = HashTable_Find(City_GetNodeTable(city), record->j);
+            if (node2 == NULL) {
+                printf("Vértice não encontrado: %s!\n", record->j);
+                continue;
+            }
+
+            GraphNode_InsertEdge(node1, node2, record->cepLeft, record->cepRight, record->length, record->speed,
+                                 record->name);
+        }
+    }
+}
+
+typedef struct link_job_t {
+    City city;
+    RecordList *streets;
+    bool statsPaused;
+} LinkJob;
+
+static void _collectNodes(RBTree tree, Node node, GraphNode *nodes) {
+    if (node == NULL)
+        return;
+    _collectNodes(tree, RBTreeN_GetLeftChild(tree, node), nodes);
+    GraphNode graphNode = RBTreeN_GetValue(tree, node);
+    nodes[GraphNode_GetIndex(graphNode)] = graphNode;
+    _collectNodes(tree, RBTreeN_GetRightChild(tree, node), nodes);
+}
+
+// Escolhe os marcos e calcula suas tabelas de distâncias (só com o grafo completo)
+static void _buildLandmarks(City city) {
+    int size = City_GetNodeCount(city);
+    GraphNode *nodes = calloc(size, sizeof(GraphNode));
+    _collectNodes(City_GetNodeTree(city), RBTree_GetRoot(City_GetNodeTree(city)), nodes);
+    City_SetLandmarks(city, Landmarks_Create(nodes, size, City_GetLandmarkCount(city)));
+    free(nodes);
+}
+
+// Particiona o grafo e calcula as matrizes de todas as células (só com o grafo completo)
+static void _buildPartition(City city) {
+    int size = City_GetNodeCount(city);
+    GraphNode *nodes = calloc(size, sizeof(GraphNode));
+    _collectNodes(City_GetNodeTree(city), RBTree_GetRoot(City_GetNodeTree(city)), nodes);
+    City_SetRoutePartition(city, RoutePartition_Create(nodes, size, City_GetPartitionCellSize(city)));
+    free(nodes);
+}
+
+static void *_runLinkStreets(void *jobVoid) {
+    LinkJob *job = (LinkJob *) jobVoid;
+    Stats_SetPaused(job->statsPaused);
+    Stats_Begin("(via:lig)", "ligação do .via", 0);
+    _linkStreets(job->city, job->streets);
+    if (City_GetLandmarkCount(job->city) > 0) {
+        Stats_Begin("(alt)", "cálculo dos marcos", 0);
+        _buildLandmarks(job->city);
+    }
+    if (City_GetPartitionCellSize(job->city) > 0) {
+        Stats_Begin("(crp)", "partição e customização", 0);
+        _buildPartition(job->city);
+    }
+    Stats_End();
+    return NULL;
+}
+
+// Inicia a leitura do arquivo (se houver) em uma thread; sem thread disponível, lê na atual
+static void _startParse(LoadJob *job, FILE *file, char *statsType, char *statsLine, 
+                        void (*parseLine)(char *line, RecordList *records), size_t itemSize) {
+    job->file = file;
+    job->statsType = statsType;
+    job->statsLine = statsLine;
+    job->parseLine = parseLine;
+    RecordList_Init(&job->records, itemSize);
+    job->threaded = false;
+    job->statsPaused = Stats_IsPaused();
+    if (file == NULL)
+        return;
+    if (pthread_create(&job->thread, NULL, _runParse, job) == 0)
+        job->threaded = true;
+    else
+        _runParse(job);
+}
+
+static void _finishParse(LoadJob *job) {
+    if (job->threaded)
+        pthread_join(job->thread, NULL);
+}
+
+void processAll(City city, Files files) {
+    LoadJob people, commerces, streets;
+    _startParse(&people, Files_GetPmFile(files), "(pm)", "leitura do .pm", 
+                _parsePeopleLine, sizeof(PeopleRecord));
+    _startParse(&commerces, Files_GetEcFile(files), "(ec)", "leitura do .ec", 
+                _parseCommercesLine, sizeof(CommerceRecord));
+    _startParse(&streets, Files_GetViaFile(files), "(via)", "leitura do .via", 
+                _parseStreetsLine, sizeof(StreetRecord));
+
+    // Etapas de carregamento também aparecem nas estatísticas, com linha 0
+    Stats_Begin("(geo)", "leitura do .geo", 0);
+    processGeometry(city, Files_GetEntryFile(files));
+    Stats_Begin("(svg)", "escrita do .svg", 0);
+    writeSVG(city, Files_GetOutputSVGFile(files), true);
+    Stats_End();
+
+    _finishParse(&people);
+    _finishParse(&commerces);
+    _finishParse(&streets);
+
+    LinkJob linkStreets = {city, &streets.records, Stats_IsPaused()};
+    pthread_t streetsThread;
+    bool streetsThreaded = pthread_create(&streetsThread, NULL, _runLinkStreets, &linkStreets) == 0;
+    if (!streetsThreaded)
+        _runLinkStreets(&linkStreets);
+
+    Stats_Begin("(pm:lig)", "ligação do .pm", 0);
+    _linkPeople(city, &people.records);
+    Stats_Begin("(ec:lig)", "ligação do .ec", 0);
+    _linkCommerces(city, &commerces.records);
+    Stats_End();
+
+    if (streetsThreaded)
+        pthread_join(streetsThread, NULL);
+
+    RecordList_Free(&people.records);
+    RecordList_Free(&commerces.records);
+    RecordList_Free(&streets.records);
     
     if (Files_GetQueryFile(files) != NULL) {
-        processAndGenerateQuery(files, ALL, NULL);
+        processAndGenerateQuery(city, files, ALL, NULL);
     }
 }
 
-void processAndGenerateQuery(Files files, PathFindMode pathMode, PathStack *pathStack) {
+void processAndGenerateQuery(City city, Files files, PathFindMode pathMode, PathStack *pathStack) {
     FILE *outputQryFile = Files_GetOutputQryFile(files);
     putSVGStart(outputQryFile);
     putSVGQueryStart(outputQryFile);
-    processQuery(Files_GetQueryFile(files), outputQryFile, Files_GetTxtFile(files), Files_GetBaseDir(files),
+    processQuery(city, Files_GetQueryFile(files), outputQryFile, Files_GetTxtFile(files), Files_GetBaseDir(files),
                     Files_GetOutputDir(files), Files_GetQrySVGFileName(files), pathMode, pathStack);
     putSVGQueryEnd(outputQryFile);
-    writeSVG(outputQryFile, false);
+    writeSVG(city, outputQryFile, false);
     putSVGUseQuery(outputQryFile);
     putSVGEnd(outputQryFile);
 
@@ -74,7 +418,30 @@ void processAndGenerateQuery(Files files, PathFindMode pathMode, PathStack *path
     fclose(Files_GetQueryFile(files));
 }
 
-bool processGeometry(FILE *entryFile) {
+bool isReadOnlyCommand(char *type) {
+    static char *readOnly[] = {"o?", "i?", "d?", "bb", "crd?", "brl", "m?", "dm?", "de?", "dmprbt",
+                               "@m?", "@e?", "@g?", "@xy", "p?", "pm?", "iso?", "nf?", "agr?",
+                               "evac", NULL};
+    for (int i = 0; readOnly[i] != NULL; i++) {
+        if (strcmp(type, readOnly[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool isReadOnlyQuery(FILE *queryFile) {
+    char buffer[128];
+    bool readOnly = true;
+    while (readOnly && fgets(buffer, 128, queryFile) != NULL) {
+        char type[16];
+        if (sscanf(buffer, "%15s", type) == 1 && !isReadOnlyCommand(type))
+            readOnly = false;
+    }
+    rewind(queryFile);
+    return readOnly;
+}
+
+bool processGeometry(City city, FILE *entryFile) {
     int nx = DEFAULT_MAXIMUM;
     int nb = DEFAULT_MAXIMUM;
     int nh = DEFAULT_MAXIMUM;
@@ -129,7 +496,7 @@ bool processGeometry(FILE *entryFile) {
             Circle c = Circle_Create(radius, x, y);
             Object o = Object_Create(id, c, OBJ_CIRC, color1, color2, wStrkCircle);
 
-            Object replacedObject = RBTree_Insert(getObjTree(), Circle_GetPoint(c), o);
+            Object replacedObject = RBTree_Insert(City_GetObjTree(city), Circle_GetPoint(c), o);
             if (replacedObject != NULL)
                 Object_Destroy(replacedObject);
 
@@ -142,7 +509,7 @@ bool processGeometry(FILE *entryFile) {
             Rectangle r = Rectangle_Create(width, height, x, y);
             Object o = Object_Create(id, r, OBJ_RECT, color1, color2, wStrkRectangle);
 
-            Object replacedObject = RBTree_Insert(getObjTree(), Rectangle_GetPoint(r), o);
+            Object replacedObject = RBTree_Insert(City_GetObjTree(city), Rectangle_GetPoint(r), o);
             if (replacedObject != NULL)
                 Object_Destroy(replacedObject);
 
@@ -153,7 +520,7 @@ bool processGeometry(FILE *entryFile) {
 
             Text t = Text_Create(x, y, string);
 
-            Text replacedText = RBTree_Insert(getTextTree(), Text_GetPoint(t), t);
+            Text replacedText = RBTree_Insert(City_GetTextTree(city), Text_GetPoint(t), t);
             if (replacedText != NULL)
                 Text_Destroy(replacedText);
 
@@ -172,11 +539,11 @@ bool processGeometry(FILE *entryFile) {
 
             Block block = Block_Create(cep, x, y, w, h, cFillBlock, cStrkBlock, wStrkBlock);
 
-            Block replacedBlock = RBTree_Insert(getBlockTree(), Block_GetPoint(block), block);
+            Block replacedBlock = RBTree_Insert(City_GetBlockTree(city), Block_GetPoint(block), block);
             if (replacedBlock != NULL)
                 Block_Destroy(replacedBlock);
 
-            HashTable_Insert(getBlockTable(), Block_GetCep(block), block);
+            HashTable_Insert(City_GetBlockTable(city), Block_GetCep(block), block);
 
         } else if (strcmp(type, "h") == 0) {
             char id[16];
@@ -185,11 +552,11 @@ bool processGeometry(FILE *entryFile) {
             
             Equip hydrant = Equip_Create(id, x, y, cFillHydrant, cStrkHydrant, wStrkHydrant);
 
-            Equip replacedEquip = RBTree_Insert(getHydTree(), Equip_GetPoint(hydrant), hydrant);
+            Equip replacedEquip = RBTree_Insert(City_GetHydTree(city), Equip_GetPoint(hydrant), hydrant);
             if (replacedEquip != NULL)
                 Equip_Destroy(replacedEquip);
 
-            HashTable_Insert(getHydTable(), Equip_GetID(hydrant), hydrant);
+            HashTable_Insert(City_GetHydTable(city), Equip_GetID(hydrant), hydrant);
 
         } else if (strcmp(type, "s") == 0) {
             char id[16];
@@ -198,11 +565,11 @@ bool processGeometry(FILE *entryFile) {
             
             Equip trLight = Equip_Create(id, x, y, cFillTrafficLight, cStrkTrafficLight, wStrkTrafficLight);
             
-            Equip replacedEquip = RBTree_Insert(getTLightTree(), Equip_GetPoint(trLight), trLight);
+            Equip replacedEquip = RBTree_Insert(City_GetTLightTree(city), Equip_GetPoint(trLight), trLight);
             if (replacedEquip != NULL)
                 Equip_Destroy(replacedEquip);
 
-            HashTable_Insert(getTLightTable(), Equip_GetID(trLight), trLight);
+            HashTable_Insert(City_GetTLightTable(city), Equip_GetID(trLight), trLight);
 
         } else if (strcmp(type, "rb") == 0) {
             char id[16];
@@ -211,11 +578,11 @@ bool processGeometry(FILE *entryFile) {
             
             Equip cellTower = Equip_Create(id, x, y, cFillCellTower, cStrkCellTower, wStrkCellTower);
             
-            Equip replacedEquip = RBTree_Insert(getCTowerTree(), Equip_GetPoint(cellTower), cellTower);
+            Equip replacedEquip = RBTree_Insert(City_GetCTowerTree(city), Equip_GetPoint(cellTower), cellTower);
             if (replacedEquip != NULL)
                 Equip_Destroy(replacedEquip);
 
-            HashTable_Insert(getCTowerTable(), Equip_GetID(cellTower), cellTower);
+            HashTable_Insert(City_GetCTowerTable(city), Equip_GetID(cellTower), cellTower);
 
         } else if (strcmp(type, "prd") == 0) {
             char cep[16];
@@ -223,7 +590,7 @@ bool processGeometry(FILE *entryFile) {
             double num, f, p, mrg;
             sscanf(buffer + 3, "%15s %c %lf %lf %lf %lf", cep, &face, &num, &f, &p, &mrg);
 
-            Block block = HashTable_Find(getBlockTable(), cep);
+            Block block = HashTable_Find(City_GetBlockTable(city), cep);
             if (block == NULL) {
                 #ifdef __DEBUG__
                 printf("Erro: Quadra de CEP %s não encontrada!\n", cep);
@@ -234,7 +601,7 @@ bool processGeometry(FILE *entryFile) {
             Building building = Building_Create(block, face, num, f, p, mrg);
             Block_InsertBuilding(block, building);
 
-            Building replacedBuilding = RBTree_Insert(getBuildingTree(), Building_GetPoint(building), building);
+            Building replacedBuilding = RBTree_Insert(City_GetBuildingTree(city), Building_GetPoint(building), building);
             if (replacedBuilding != NULL)
                 Building_Destroy(replacedBuilding);
 
@@ -244,7 +611,7 @@ bool processGeometry(FILE *entryFile) {
 
             Wall wall = Wall_Create(x1, y1, x2, y2);
 
-            Wall replacedWall = RBTree_Insert(getWallTree(), Wall_GetPoint1(wall), wall);
+            Wall replacedWall = RBTree_Insert(City_GetWallTree(city), Wall_GetPoint1(wall), wall);
             if (replacedWall != NULL)
                 Wall_Destroy(wall);
         }
@@ -252,179 +619,99 @@ bool processGeometry(FILE *entryFile) {
     return true;
 }
 
-bool processPeople(FILE *pmFile) {
-    char buffer[128];
-    while (fgets(buffer, 100, pmFile) != NULL) {
-        char type[16];
-        sscanf(buffer, "%15s", type);
-
-        if (strcmp(type, "p") == 0) {
-            char cpf[16], name[32], surname[32], sex, birthDate[16];
-            sscanf(buffer + 2, "%s %s %s %c %s", cpf, name, surname, &sex, birthDate);
-
-            Person person = Person_Create(cpf, name, surname, sex, birthDate);
-
-            Person replaced = HashTable_Insert(getPersonTable(), Person_GetCpf(person), person);
-            if (replaced != NULL) {
-                Building building = Person_GetBuilding(replaced);
-                if (building != NULL)
-                    Building_RemoveResident(building, replaced);
-                Block block = Person_GetBlock(replaced);
-                if (block != NULL) {
-                    Block_RemoveResident(block, replaced);
-                }
-                Person_Destroy(replaced);
-            }
-        } else if (strcmp(type, "m") == 0) {
-            char cpf[16], cep[24], face, complement[16];
-            int num;
-            sscanf(buffer + 1, "%s %s %c %d %s", cpf, cep, &face, &num, complement);
-
-            Person person = HashTable_Find(getPersonTable(), cpf);
-            if (person == NULL) {
-                printf("Erro: Pessoa de CPF %s não encontrada!\n", cpf);
-            }
-
-            char address[64];
-            Building_MakeAddress(address, cep, face, num);
-
-            Block block = HashTable_Find(getBlockTable(), cep);
-            if (block == NULL) {
-                printf("Erro: Quadra de CEP %s não encontrada!\n", cep);
-                continue;
-            }
-
-            Person_SetBlock(person, block);
-            Person_SetAddress(person, address);
-            Person_SetComplement(person, complement);
-
-            RBTree buildings = Block_GetBuildings(block);
-            Building building = RBTree_Find(buildings, address);
-            if (building != NULL) {
-                Building_InsertResident(building, person);
-                Person_SetBuilding(person, building);
-            }
-
-            Block_InsertResident(block, person);
-        }
+// Destinos de uma linha pm?: registradores e equipamentos
+typedef struct matrix_targets_t {
+    char (*labels)[32];
+    Point *points;
+    int length, capacity;
+} MatrixTargets;
+
+static void _addMatrixTarget(MatrixTargets *targets, char label[], Point point) {
+    if (targets->length == targets->capacity) {
+        targets->capacity = targets->capacity == 0 ? 16 : targets->capacity * 2;
+        targets->labels = realloc(targets->labels, targets->capacity * sizeof(*targets->labels));
+        targets->points = realloc(targets->points, targets->capacity * sizeof(Point));
     }
+    snprintf(targets->labels[targets->length], 32, "%s", label);
+    targets->points[targets->length++] = point;
 }
 
-bool processCommerces(FILE *ecFile) {
-    char buffer[128];
-    while (fgets(buffer, 100, ecFile) != NULL) {
-        char type[16];
-        sscanf(buffer, "%15s", type);
-
-        if (strcmp(type, "t") == 0) {
-            char codt[16], desc[64];
-            sscanf(buffer + 2, "%s %63[^\n]", codt, desc);
-
-            CommerceType commType = CommerceType_Create(codt, desc);
-
-            CommerceType replaced = HashTable_Insert(getCommTypeTable(), 
-                                                     CommerceType_GetCode(commType), 
-                                                     commType);
-            if (replaced != NULL)
-                CommerceType_Destroy(replaced);
-
-        } else if (strcmp(type, "e") == 0) {
-            char cnpj[24], cpf[16], codt[16], cep[24], face, name[64];
-            int num;
-
-            sscanf(buffer + 2, "%s %s %s %s %c %d %63[^\n]", cnpj, cpf, codt, cep, &face, &num, name);
-            
-            CommerceType cType = HashTable_Find(getCommTypeTable(), codt);
-            if (cType == NULL) {
-                printf("Erro: Tipo de estabelecimento não encontrado: %s\n", codt);
-                continue;
-            }
-
-            char address[64];
-            Building_MakeAddress(address, cep, face, num);
-
-            Block block = HashTable_Find(getBlockTable(), cep);
-            if (block == NULL) {
-                printf("Erro: Quadra de CEP %s não encontrada!\n", cep);
-                continue;
-            }
-
-            RBTree buildings = Block_GetBuildings(block);
-            Building building = RBTree_Find(buildings, address);
-
-            Person person = HashTable_Find(getPersonTable(), cpf);
-            if (person == NULL) {
-                printf("Erro: Pessoa de CPF %s não encontrada!\n", cpf);
-            }
-
-            Commerce commerce = Commerce_Create(cType, address, block, building, name, cnpj, person);
-            Commerce replaced = HashTable_Insert(getCommerceTable(), Commerce_GetCnpj(commerce), commerce);
-            if (replaced != NULL) {
-                if (Commerce_GetBuilding(replaced) != NULL)
-                    Building_RemoveCommerce(Commerce_GetBuilding(replaced), replaced);
-                Block_RemoveCommerce(Commerce_GetBlock(replaced), replaced);
-                Commerce_Destroy(replaced);
-            }
+static void _addEquipTarget(Value equip, void *targets) {
+    _addMatrixTarget(targets, Equip_GetID(equip), Equip_GetPoint(equip));
+}
 
-            if (building != NULL)
-                Building_InsertCommerce(building, commerce);
-            Block_InsertCommerce(block, commerce);
+// Linha pm?: custos de um registrador até vários destinos, com uma busca por métrica. Cada
+// destino é um registrador (R<n>) ou todos os equipamentos de um tipo (h, s ou rb)
+static void _writePathMatrix(City city, FILE *txtFile, Point registries[], char *args) {
+    char token[16];
+    int offset, source;
+    if (sscanf(args, "%15s%n", token, &offset) != 1 || sscanf(token, "R%d", &source) != 1
+            || source < 0 || source > 10 || registries[source] == NULL) {
+        fprintf(txtFile, "Registrador de origem inválido\n\n");
+        return;
+    }
+    args += offset;
+
+    MatrixTargets targets = {NULL, NULL, 0, 0};
+    while (sscanf(args, "%15s%n", token, &offset) == 1) {
+        args += offset;
+        int r;
+        if (sscanf(token, "R%d", &r) == 1) {
+            if (r < 0 || r > 10 || registries[r] == NULL)
+                fprintf(txtFile, "Registrador não definido: %s\n", token);
+            else
+                _addMatrixTarget(&targets, token, registries[r]);
+        } else if (strcmp(token, "h") == 0) {
+            RBTree_Execute(City_GetHydTree(city), _addEquipTarget, &targets);
+        } else if (strcmp(token, "s") == 0) {
+            RBTree_Execute(City_GetTLightTree(city), _addEquipTarget, &targets);
+        } else if (strcmp(token, "rb") == 0) {
+            RBTree_Execute(City_GetCTowerTree(city), _addEquipTarget, &targets);
+        } else {
+            fprintf(txtFile, "Destino inválido: %s\n", token);
         }
     }
-}
-
-bool processStreets(FILE *viaFile) {
-    char buffer[128];
-    while (fgets(buffer, 100, viaFile) != NULL) {
-        char type[16];
-        sscanf(buffer, "%15s", type);
-
-        if (strcmp(type, "v") == 0) {
-            char id[32];
-            double x, y;
-
-            sscanf(buffer + 2, "%s %lf %lf", id, &x, &y);
 
-            GraphNode node = GraphNode_Create(id, x, y);
-
-            RBTree_Insert(getNodeTree(), GraphNode_GetPoint(node), node);
-            GraphNode replaced = HashTable_Insert(getNodeTable(), GraphNode_GetId(node), node);
-            if (replaced != NULL) {
-                GraphNode_Destroy(replaced);
-            }
-        } else if (strcmp(type, "e") == 0) {
-            char i[32], j[32], cepLeft[24], cepRight[24], name[64];
-            double length, speed;
-
-            sscanf(buffer + 2, "%s %s %s %s %lf %lf %s", 
-                    i, j, cepRight, cepLeft, &length, &speed, name);
-
-            GraphNode node1 = HashTable_Find(getNodeTable(), i);
-            if (node1 == NULL) {
-                printf("Vértice não encontrado: %s!\n", i);
-                continue;
-            }
-            GraphNode node2 = HashTable_Find(getNodeTable(), j);
-            if (node1 == NULL) {
-                printf("Vértice não encontrado: %s!\n", j);
-                continue;
-            }
-
-            Block blockLeft = HashTable_Find(getBlockTable(), cepLeft);
-            Block blockRight = HashTable_Find(getBlockTable(), cepRight);
+    GraphNode start = findClosestNodeToPoint(city, registries[source]);
+    GraphNode *nodes = malloc((targets.length + 1) * sizeof(GraphNode));
+    double *lengths = malloc((targets.length + 1) * sizeof(double));
+    double *times = malloc((targets.length + 1) * sizeof(double));
+    for (int i = 0; i < targets.length; i++)
+        nodes[i] = findClosestNodeToPoint(city, targets.points[i]);
+    if (start != NULL) {
+        findDistances(city, start, nodes, targets.length, false, lengths);
+        findDistances(city, start, nodes, targets.length, true, times);
+    } else {
+        for (int i = 0; i < targets.length; i++)
+            lengths[i] = times[i] = INFINITY;
+    }
 
-            GraphNode_InsertEdge(node1, node2, blockLeft, blockRight, length, speed, name);
-        }
+    fprintf(txtFile, "%-24s %14s %14s\n", "Destino", "Comprimento", "Tempo");
+    for (int i = 0; i < targets.length; i++) {
+        if (isfinite(lengths[i]))
+            fprintf(txtFile, "%-24s %14.2lf %14.2lf\n", targets.labels[i], lengths[i], times[i]);
+        else
+            fprintf(txtFile, "%-24s %14s %14s\n", targets.labels[i], "-", "-");
     }
+    fputs("\n", txtFile);
+
+    free(nodes);
+    free(lengths);
+    free(times);
+    free(targets.labels);
+    free(targets.points);
 }
 
-bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir[], char outputDir[], 
+bool processQuery(City city, FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir[], char outputDir[], 
                   char svgFileName[], PathFindMode pathMode, PathStack *pathStack) {
     Point registries[11];
     memset(registries, 0, 11 * sizeof(Point));
     
     char buffer[128];
-    while (fgets(buffer, 128, queryFile) != NULL) {
+    int lineNumber = 0;
+    // A medição da linha termina ao fim do seu processamento, antes da leitura da próxima
+    for (; fgets(buffer, 128, queryFile) != NULL; Stats_End()) {
+        lineNumber++;
 
         int len = strlen(buffer);
         if (buffer[len - 1] != '\n') {
@@ -433,14 +720,18 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
         }
 
         char type[16];
-        sscanf(buffer, "%15s", type);
+        if (sscanf(buffer, "%15s", type) == 1) {
+            Stats_Begin(type, buffer, lineNumber);
+            if (!isReadOnlyCommand(type))
+                City_AdvanceVersion(city);
+        }
         if (strcmp(type, "o?") == 0) {
 
             char idA[8], idB[8];
             sscanf(buffer + 3, "%7s %7s", idA, idB);
             
             fputs(buffer, txtFile);
-            if (!Query_Overlaps(txtFile, outputFile, idA, idB))
+            if (!Query_Overlaps(city, txtFile, outputFile, idA, idB))
                 return false;
 
         } else if (strcmp(type, "i?") == 0) {
@@ -450,7 +741,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 3, "%7s %lf %lf", id, &x, &y);
 
             fputs(buffer, txtFile);
-            if (!Query_Inside(txtFile, outputFile, id, x, y))
+            if (!Query_Inside(city, txtFile, outputFile, id, x, y))
                 return false;
 
         } else if (strcmp(type, "d?") == 0) {
@@ -458,7 +749,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             char j[8], k[8];
             sscanf(buffer + 3, "%7s %7s", j, k);
             
-            if (!Query_Distance(txtFile, outputFile, j, k))
+            if (!Query_Distance(city, txtFile, outputFile, j, k))
                 return false;
 
         } else if (strcmp(type, "bb") == 0) {
@@ -466,7 +757,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             char suffix[32], color[16];
             sscanf(buffer + 3, "%s %s", suffix, color);
 
-            if (!Query_Bb(txtFile, outputFile, outputDir, svgFileName, suffix, color))
+            if (!Query_Bb(city, txtFile, outputFile, outputDir, svgFileName, suffix, color))
                 return false;
         
         } else if (strcmp(type, "dq") == 0) {
@@ -476,7 +767,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 3, "%7s %15s %lf", metric, id, &dist);
 
             fputs(buffer, txtFile);
-            if (!Query_Dq(txtFile, metric, id, dist))
+            if (!Query_Dq(city, txtFile, metric, id, dist))
                 return false;
         
         } else if (strcmp(type, "del") == 0) {
@@ -485,7 +776,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "%15s", id);
 
             fputs(buffer, txtFile);
-            if (!Query_Del(txtFile, id))
+            if (!Query_Del(city, txtFile, id))
                 return false;
         
         } else if (strcmp(type, "cbq") == 0) {
@@ -495,7 +786,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "%lf %lf %lf %23s", &x, &y, &r, cStrk);
 
             fputs(buffer, txtFile);
-            if (!Query_Cbq(txtFile, x, y, r, cStrk))
+            if (!Query_Cbq(city, txtFile, x, y, r, cStrk))
                 return false;
         
         } else if (strcmp(type, "crd?") == 0) {
@@ -504,7 +795,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 5, "%15s", id);
 
             fputs(buffer, txtFile);
-            if (!Query_Crd(txtFile, id))
+            if (!Query_Crd(city, txtFile, id))
                 return false;
 
         } else if (strcmp(type, "trns") == 0) {
@@ -514,7 +805,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
                    &x, &y, &w, &h, &dx, &dy);
 
             fputs(buffer, txtFile);
-            if (!Query_Trns(txtFile, x, y, w, h, dx, dy))
+            if (!Query_Trns(city, txtFile, x, y, w, h, dx, dy))
                 return false;
 
         } else if (strcmp(type, "brl") == 0) {
@@ -522,7 +813,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             double x, y;
             sscanf(buffer + 4, "%lf %lf", &x, &y);
 
-            if (!Query_Brl(outputFile, x, y))
+            if (!Query_Brl(city, outputFile, x, y))
                 return false;
 
         } else if (strcmp(type, "fi") == 0) {
@@ -533,7 +824,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 3, "%lf %lf %d %lf", &x, &y, &ns, &r);
 
             fputs(buffer, txtFile);
-            if (!Query_Fi(txtFile, outputFile, x, y, ns, r))
+            if (!Query_Fi(city, txtFile, outputFile, x, y, ns, r))
                 return false;
 
         } else if (strcmp(type, "fh") == 0) {
@@ -545,7 +836,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 3, "%c%d %15s %c %lf", &signal, &k, cep, &face, &num);
 
             fputs(buffer, txtFile);
-            if (!Query_Fh(txtFile, outputFile, signal, k, cep, face, num))
+            if (!Query_Fh(city, txtFile, outputFile, signal, k, cep, face, num))
                 return false;
 
         } else if (strcmp(type, "fs") == 0) {
@@ -557,9 +848,22 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 3, "%d %15s %c %lf", &k, cep, &face, &num);
 
             fputs(buffer, txtFile);
-            if (!Query_Fs(txtFile, outputFile, k, cep, face, num))
+            if (!Query_Fs(city, txtFile, outputFile, k, cep, face, num))
                 return false;
 
+        } else if (strcmp(type, "nf?") == 0) {
+
+            char equipType[8], metric, cep[16], face, color[24];
+            double num;
+
+            if (sscanf(buffer + 4, "%7s %c %15s %c %lf %23s", equipType, &metric, cep, &face, &num, color) != 6) {
+                printf("Linha nf? inválida: %s", buffer);
+                continue;
+            }
+
+            fputs(buffer, txtFile);
+            Query_Nf(city, txtFile, outputFile, equipType, metric == 'r', cep, face, num, color);
+
         } else if (strcmp(type, "brn") == 0) {
 
             char arqPol[32];
@@ -568,7 +872,19 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "%lf %lf %31[^\n]", &x, &y, arqPol);
 
             fputs(buffer, txtFile);
-            Query_Brn(txtFile, outputFile, x, y, outputDir, arqPol);
+            Query_Brn(city, txtFile, outputFile, x, y, outputDir, arqPol);
+
+        } else if (strcmp(type, "evac") == 0) {
+
+            char arqPol[32], color[24];
+
+            if (sscanf(buffer + 5, "%31s %23s", arqPol, color) != 2) {
+                printf("Linha evac inválida: %s", buffer);
+                continue;
+            }
+
+            fputs(buffer, txtFile);
+            Query_Evac(city, txtFile, outputFile, outputDir, arqPol, color);
 
         } else if (strcmp(type, "m?") == 0) {
 
@@ -577,7 +893,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 3, "%s", cep);
 
             fputs(buffer, txtFile);
-            if (!Query_M(txtFile, cep))
+            if (!Query_M(city, txtFile, cep))
                 return false;
 
         } else if (strcmp(type, "mplg?") == 0) {
@@ -586,7 +902,15 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 6, "%31[^\n]", arqPol);
 
             fputs(buffer, txtFile);
-            Query_Mplg(txtFile, outputFile, baseDir, arqPol);
+            Query_Mplg(city, txtFile, outputFile, baseDir, arqPol);
+
+        } else if (strcmp(type, "agr?") == 0) {
+
+            char arqPol[32];
+            sscanf(buffer + 5, "%31[^\n]", arqPol);
+
+            fputs(buffer, txtFile);
+            Query_Agr(city, txtFile, baseDir, arqPol);
 
         } else if (strcmp(type, "dm?") == 0) {
 
@@ -594,7 +918,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "%s", cpf);
 
             fputs(buffer, txtFile);
-            if (!Query_Dm(txtFile, cpf))
+            if (!Query_Dm(city, txtFile, cpf))
                 return false;
 
         } else if (strcmp(type, "de?") == 0) {
@@ -603,7 +927,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "%s", cnpj);
 
             fputs(buffer, txtFile);
-            if (!Query_De(txtFile, cnpj))
+            if (!Query_De(city, txtFile, cnpj))
                 return false;
 
         } else if (strcmp(type, "mud") == 0) {
@@ -613,7 +937,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "%s %s %c %d %s", cpf, cep, &face, &num, compl);
 
             fputs(buffer, txtFile);
-            if (!Query_Mud(txtFile, cpf, cep, face, num, compl))
+            if (!Query_Mud(city, txtFile, cpf, cep, face, num, compl))
                 return false;
 
         } else if (strcmp(type, "eplg?") == 0) {
@@ -622,7 +946,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 6, "%s %s", arqPolig, commType);
 
             fputs(buffer, txtFile);
-            Query_Eplg(txtFile, outputFile, baseDir, arqPolig, commType);
+            Query_Eplg(city, txtFile, outputFile, baseDir, arqPolig, commType);
 
         } else if (strcmp(type, "catac") == 0) {
             
@@ -630,7 +954,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 6, "%31[^\n]", arqPolig);
 
             fputs(buffer, txtFile);
-            Query_Catac(outputFile, txtFile, baseDir, arqPolig);
+            Query_Catac(city, outputFile, txtFile, baseDir, arqPolig);
 
         } else if (strcmp(type, "dmprbt") == 0) {
 
@@ -638,24 +962,27 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
 
             sscanf(buffer + 7, "%c %31[^\n]", &t, arq);
 
-            Query_Dmprbt(outputDir, t, arq);
+            Query_Dmprbt(city, outputDir, t, arq);
         } else if (strcmp(type, "@m?") == 0) {
             int r;
             char cpf[16];
 
             sscanf(buffer + 4, "R%d %s", &r, cpf);
 
-            Person person = HashTable_Find(getPersonTable(), cpf);
+            Person person = IntTable_Find(City_GetPersonTable(city), Person_EncodeCpf(cpf));
             if (person == NULL) {
                 printf("Pessoa não encontrada: %s!\n", cpf);
                 continue;
             }
 
-            char cep[24], face;
+            char *cep, face;
             int num;
-            sscanf(Person_GetAddress(person), "%s %c %d", cep, &face, &num);
+            if (!Person_GetAddress(person, &cep, &face, &num)) {
+                printf("Pessoa sem endereço: %s!\n", cpf);
+                continue;
+            }
 
-            Block block = HashTable_Find(getBlockTable(), cep);
+            Block block = HashTable_Find(City_GetBlockTable(city), cep);
             if (block == NULL) {
                 printf("Quadra não encontrada: %s!\n", cep);
                 continue;
@@ -674,7 +1001,7 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
 
             sscanf(buffer + 4, "R%d %s %c %d", &r, cep, &face, &num);
 
-            Block block = HashTable_Find(getBlockTable(), cep);
+            Block block = HashTable_Find(City_GetBlockTable(city), cep);
             if (block == NULL) {
                 printf("Quadra não encontrada: %s!\n", cep);
                 continue;
@@ -694,11 +1021,11 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             sscanf(buffer + 4, "R%d %s", &r, id);
 
             Equip e;
-            e = HashTable_Find(getHydTable(), id);
+            e = HashTable_Find(City_GetHydTable(city), id);
             if (e == NULL)
-                e = HashTable_Find(getTLightTable(), id);
+                e = HashTable_Find(City_GetTLightTable(city), id);
             if (e == NULL)
-                e = HashTable_Find(getCTowerTable(), id);
+                e = HashTable_Find(City_GetCTowerTable(city), id);
             if (e == NULL) {
                 printf("Equipamento não encontrado: %s!\n", id);
                 continue;
@@ -743,14 +1070,33 @@ bool processQuery(FILE *queryFile, FILE *outputFile, FILE *txtFile, char baseDir
             fputs(buffer, txtFile);
 
             putSVGStart(file);
-            writeSVG(file, false);
-            PathStack s = findPath(registries[r1], registries[r2], file, txtFile, cormc, cormr, pathMode);
+            writeSVG(city, file, false);
+            PathStack s = findPath(city, registries[r1], registries[r2], file, txtFile, cormc, cormr, pathMode);
             if (pathMode != ALL)
                 *pathStack = s;
             putSVGEnd(file);
             fclose(file);
+        } else if (strcmp(type, "iso?") == 0) {
+            char metric, color[24];
+            int r;
+            double budget;
+
+            if (sscanf(buffer + 5, "R%d %c %lf %23s", &r, &metric, &budget, color) != 4 || r < 0 || r > 10) {
+                printf("Linha iso? inválida: %s", buffer);
+                continue;
+            } else if (registries[r] == NULL) {
+                printf("Registrador não definido: R%d!\n", r);
+                continue;
+            }
+
+            fputs(buffer, txtFile);
+            Query_Iso(city, txtFile, outputFile, registries[r], metric == 'r', budget, color);
+        } else if (strcmp(type, "pm?") == 0) {
+            fputs(buffer, txtFile);
+            _writePathMatrix(city, txtFile, registries, buffer + 3);
         }
     }
+    Stats_End();
 
     for (int i = 0; i < 11; i++) {
         if (registries[i] != NULL)
@@ -8,8 +8,10 @@
 #include "modules/sig/geometry.h"
 #include "modules/util/files.h"
 #include "modules/util/svg.h"
+#include "modules/util/stats.h"
+#include "modules/util/line_parser.h"
 #include "query.h"
-#include "data.h"
+#include "city.h"
 #include "pathfind.h"
 
 #define DEFAULT_MAXIMUM 1000
@@ -18,8 +20,15 @@
 // void processAll(FILE *entryFile, FILE *outputSVGFile, FILE *outputQryFile, FILE *queryFile, 
 //                 FILE *txtFile, char outputDir[], char svgFileName[]);
 
-void processAll(Files files);
+void processAll(City city, Files files);
 
-void processAndGenerateQuery(Files files, PathFindMode pathMode, PathStack *pathStack);
+void processAndGenerateQuery(City city, Files files, PathFindMode pathMode, PathStack *pathStack);
+
+// Retorna se o comando de consulta apenas lê a cidade (não altera árvores, tabelas ou elementos,
+// nem mesmo marcações de destaque usadas no SVG)
+bool isReadOnlyCommand(char *type);
+
+// Retorna se todas as linhas do arquivo de consulta são apenas de leitura, voltando ao início do arquivo
+bool isReadOnlyQuery(FILE *queryFile);
 
 #endif
\ No newline at end of file
@@ -508,7 +508,7 @@ void loadTreeData(RBTree tree, Node root, bool isActive[7], bool isRed[7], char
     }
 }
 
-void navTree(TreeType type) {
+void navTree(City city, TreeType type) {
     curs_set(0);
     noecho();
 
@@ -518,31 +518,31 @@ void navTree(TreeType type) {
     
     switch(type) {
         case HIDRANTE:
-            tree = getHydTree();
+            tree = City_GetHydTree(city);
             sub2 = "Arvore de Hidrantes";
             break;
         case QUADRA:
-            tree = getBlockTree();
+            tree = City_GetBlockTree(city);
             sub2 = "Arvore de Quadras";
             break;
         case SEMAFORO:
-            tree = getTLightTree();
+            tree = City_GetTLightTree(city);
             sub2 = "Arvore de Semáforos";
             break;
         case RADIOBASE:
-            tree = getCTowerTree();
+            tree = City_GetCTowerTree(city);
             sub2 = "Arvore de Radio-Base";
             break;
         case PREDIO:
-            tree = getBuildingTree();
+            tree = City_GetBuildingTree(city);
             sub2 = "Arvore de Prédios";
             break;
         case MURO:
-            tree = getWallTree();
+            tree = City_GetWallTree(city);
             sub2 = "Arvore de Muros";
             break;
         default:
-            tree = getBlockTree();
+            tree = City_GetBlockTree(city);
             sub2 = "Default Tree - Quadras";
             break;
     }
@@ -710,7 +710,7 @@ void setResult(WINDOW *processamento, bool success) {
     doneScreen(success, NULL);
 }
 
-void processCommand(char *buffer, Files *files, char *baseDir, char *entryFileName) {
+void processCommand(City city, char *buffer, Files *files, char *baseDir, char *entryFileName) {
     WINDOW *processamento = newwin(4, 79, 5, 1);
     wattron(processamento, A_BOLD);
     mvwprintw(processamento, 1, 1, "Executando o comando ");
@@ -742,7 +742,7 @@ void processCommand(char *buffer, Files *files, char *baseDir, char *entryFileNa
             return cleanDelete(processamento);
         }
         
-        processAndGenerateQuery(files, ALL, NULL);
+        processAndGenerateQuery(city, files, ALL, NULL);
         setResult(processamento, true);
         return cleanDelete(processamento);
     } else if (strcmp(comando, "dmprbt") == 0) {
@@ -764,14 +764,14 @@ void processCommand(char *buffer, Files *files, char *baseDir, char *entryFileNa
             return cleanDelete(processamento);
         }
 
-        if (Query_Dmprbt(Files_GetOutputDir(files), t, arq)) {
+        if (Query_Dmprbt(city, Files_GetOutputDir(files), t, arq)) {
             setResult(processamento, true);
             return cleanDelete(processamento);
 		}
 
     } else if (strcmp(comando, "nav") == 0) {
         TreeType t = menuTipo();
-        navTree(t);
+        navTree(city, t);
     }
 
     cleanDelete(processamento);
@@ -779,7 +779,7 @@ void processCommand(char *buffer, Files *files, char *baseDir, char *entryFileNa
 }
 
 
-void startGui(Files *files, char *baseDir, char *entryFileName) {
+void startGui(City city, Files *files, char *baseDir, char *entryFileName) {
     WINDOW * mainwin;
 
     if ( (mainwin = initscr()) == NULL ) {
@@ -819,7 +819,7 @@ void startGui(Files *files, char *baseDir, char *entryFileName) {
 
     char *str = waitCommand();
     while (strcmp(str, "sai") != 0) {
-        processCommand(str, files, baseDir, entryFileName);
+        processCommand(city, str, files, baseDir, entryFileName);
         free(str);
         str = waitCommand();
 
@@ -12,7 +12,7 @@
 #include "commands.h"
 #include "modules/aux/point.h"
 
-void startGui(Files *files, char *baseDir, char *entryFileName);
+void startGui(City city, Files *files, char *baseDir, char *entryFileName);
 
 #endif
 
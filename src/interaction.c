@@ -7,10 +7,11 @@
 #define CCYAN "\033[0;36m"
 #define CRESET "\033[0m"
 
-void navigation(PathStack pathStack, bool quickest);
-void recalculate(GraphNode currentNode, PathStack *pathStack, GraphNode *currentTarget, bool quickest);
+void navigation(City city, PathStack pathStack, bool quickest);
+void recalculate(City city, GraphNode currentNode, PathStack *pathStack, GraphNode *currentTarget, bool quickest,
+                 PathTree reverseTrees[2]);
 
-void startInteraction(Files *files, char *baseDir, char *entryFileName) {
+void startInteraction(City city, Files *files, char *baseDir, char *entryFileName) {
     printf("-- MODO INTERAÇÃO --\n");
     char buffer[128];
     char command[16];
@@ -27,7 +28,7 @@ void startInteraction(Files *files, char *baseDir, char *entryFileName) {
             if (!Files_OpenQueryFiles(files, baseDir, entryFileName, qryFileName))
                 continue;
             
-            processAndGenerateQuery(files, ALL, NULL);
+            processAndGenerateQuery(city, files, ALL, NULL);
         } else if (strcmp(command, "dmprbt") == 0) {
             char t = '\0', arq[64] = "";
             sscanf(buffer + 7, "%c %63[^\n]", &t, arq);
@@ -42,7 +43,7 @@ void startInteraction(Files *files, char *baseDir, char *entryFileName) {
                 continue;
             }
 
-            if (Query_Dmprbt(Files_GetOutputDir(files), t, arq))
+            if (Query_Dmprbt(city, Files_GetOutputDir(files), t, arq))
                 printf("Árvore escrita no arquivo %s!\n", arq);
 
         } else if (strcmp(command, "nav") == 0) {
@@ -53,22 +54,22 @@ void startInteraction(Files *files, char *baseDir, char *entryFileName) {
 
             switch (t) {
                 case 'q':
-                    tree = getBlockTree();
+                    tree = City_GetBlockTree(city);
                     break;
                 case 'h':
-                    tree = getHydTree();
+                    tree = City_GetHydTree(city);
                     break;
                 case 's':
-                    tree = getTLightTree();
+                    tree = City_GetTLightTree(city);
                     break;
                 case 't':
-                    tree = getCTowerTree();
+                    tree = City_GetCTowerTree(city);
                     break;
                 case 'p':
-                    tree = getBuildingTree();
+                    tree = City_GetBuildingTree(city);
                     break;
                 case 'm':
-                    tree = getWallTree();
+                    tree = City_GetWallTree(city);
                     break;
             }
 
@@ -153,11 +154,11 @@ void startInteraction(Files *files, char *baseDir, char *entryFileName) {
 
             PathStack pathStack = NULL;
             
-            processAndGenerateQuery(files, command[1] == 'r' ? QUICKEST : SHORTEST, &pathStack);
+            processAndGenerateQuery(city, files, command[1] == 'r' ? QUICKEST : SHORTEST, &pathStack);
             printf("-- INÍCIO NAVEGAÇÃO --\n");
             printf("n, s, l, o => Norte, Sul, Leste, Oeste.\n");
             printf("ne, no, se, so => Nordeste, Noroeste, Sudeste, Sudoeste.\n");
-            navigation(pathStack, command[1] == 'r');
+            navigation(city, pathStack, command[1] == 'r');
             printf("-- FIM NAVEGAÇÃO --\n");
         } else if (strcmp(command, "sai") != 0) {
             printf("Comando não reconhecido!\n");
@@ -165,7 +166,19 @@ void startInteraction(Files *files, char *baseDir, char *entryFileName) {
     } while (strcmp(command, "sai") != 0);
 }
 
-void navigation(PathStack pathStack, bool quickest) {
+static void _navigate(City city, PathStack pathStack, bool quickest, PathTree reverseTrees[2]);
+
+void navigation(City city, PathStack pathStack, bool quickest) {
+    // Árvores reversas de caminhos até o destino, por métrica, criadas no primeiro recálculo
+    PathTree reverseTrees[2] = {NULL, NULL};
+    _navigate(city, pathStack, quickest, reverseTrees);
+    for (int i = 0; i < 2; i++) {
+        if (reverseTrees[i] != NULL)
+            PathTree_Destroy(reverseTrees[i]);
+    }
+}
+
+static void _navigate(City city, PathStack pathStack, bool quickest, PathTree reverseTrees[2]) {
     if (pathStack == NULL) {
         printf(CRED "Caminho não encontrado!\n" CRESET);
     } else {
@@ -227,7 +240,7 @@ void navigation(PathStack pathStack, bool quickest) {
                             double yc = GraphNode_GetY(currentNode);
                             if (euclideanDistance(xt, yt, xc, yc) >= 200) {
                                 printf(CCYAN "Se afastou mais de 200 unidades do alvo, recalculando...\n" CRESET);
-                                recalculate(currentNode, &pathStack, &currentTarget, quickest);
+                                recalculate(city, currentNode, &pathStack, &currentTarget, quickest, reverseTrees);
                                 if (pathStack == NULL) {
                                     printf(CRED "Impossível recalcular o caminho!\n" CRESET);
                                     return;
@@ -238,7 +251,7 @@ void navigation(PathStack pathStack, bool quickest) {
                                || strcmp(internalCommand, "rc") == 0) {
                         printf(CCYAN "Recalculando...\n" CRESET);
                         quickest = internalCommand[1] == 'r';
-                        recalculate(currentNode, &pathStack, &currentTarget, quickest);
+                        recalculate(city, currentNode, &pathStack, &currentTarget, quickest, reverseTrees);
                         if (pathStack == NULL) {
                             printf(CRED "Impossível recalcular o caminho!\n" CRESET);
                             return;
@@ -260,16 +273,21 @@ void navigation(PathStack pathStack, bool quickest) {
     }
 }
 
-void recalculate(GraphNode currentNode, PathStack *pathStack, GraphNode *currentTarget, bool quickest) {
+// O destino não muda durante a navegação, então cada recálculo só segue os pais da árvore reversa
+// enraizada nele (o grafo também não muda, não há consultas no meio)
+void recalculate(City city, GraphNode currentNode, PathStack *pathStack, GraphNode *currentTarget, bool quickest,
+                 PathTree reverseTrees[2]) {
     GraphNode end = getPathStackBase(*pathStack);
     destroyPathStack(*pathStack);
-    *pathStack = findPathStack(currentNode, end, quickest);
+    if (reverseTrees[quickest] == NULL)
+        reverseTrees[quickest] = PathTree_Create(City_GetNodeCount(city), end, quickest, true);
+    *pathStack = findPathStackInTree(reverseTrees[quickest], currentNode);
     *currentTarget = currentNode;
 }
 
 #else
-void startInteraction(Files *files, char *baseDir, char *entryFileName) {
-    startGui(files, baseDir, entryFileName);
+void startInteraction(City city, Files *files, char *baseDir, char *entryFileName) {
+    startGui(city, files, baseDir, entryFileName);
 }
 
 #endif
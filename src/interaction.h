@@ -8,6 +8,6 @@
 #include "commands.h"
 #include "gui.h"
 
-void startInteraction(Files *files, char *baseDir, char *entryFileName);
+void startInteraction(City city, Files *files, char *baseDir, char *entryFileName);
 
 #endif
\ No newline at end of file
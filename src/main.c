@@ -5,8 +5,12 @@
 #include "modules/util/file_util.h"
 #include "commands.h"
 #include "interaction.h"
+#include "server.h"
 #include "modules/sig/object.h"
 #include "modules/util/files.h"
+#include "modules/util/polygon_cache.h"
+#include "modules/util/stats.h"
+#include "modules/util/string_pool.h"
 
 int main(int argc, char *argv[]) {
 	Files files = Files_Create();
@@ -21,6 +25,12 @@ int main(int argc, char *argv[]) {
 	char *ecFileName = NULL;
 	char *pmFileName = NULL;
 	char *viaFileName = NULL;
+	char *statsFileName = NULL;
+	char *socketPath = NULL;
+	int landmarkCount = 0;
+	int pathTrees = CITY_PATH_TREES;
+	int searchThreads = 0;
+	int partitionCellSize = 0;
 
 	FILE *entryFile = NULL;
 	FILE *outputSVGFile = NULL;
@@ -102,6 +112,51 @@ int main(int argc, char *argv[]) {
 			strcpy(viaFileName, argv[i]);
 		} else if (strcmp("-i", argv[i]) == 0) {
 			interactive = true;
+		} else if (strcmp("-server", argv[i]) == 0) {
+			if (++i >= argc) {
+				printf("O argumento '-server' requer o caminho de um socket!\n");
+				return 1;
+			}
+			if (socketPath != NULL) {
+				free(socketPath);
+			}
+			socketPath = malloc((strlen(argv[i]) + 1) * sizeof(char));
+			strcpy(socketPath, argv[i]);
+		} else if (strcmp("-alt", argv[i]) == 0) {
+			// Busca de caminhos com marcos (ALT): quantidade de marcos a pré-calcular
+			if (++i >= argc || sscanf(argv[i], "%d", &landmarkCount) != 1 || landmarkCount < 0) {
+				printf("O argumento '-alt' requer a quantidade de marcos!\n");
+				return 1;
+			}
+		} else if (strcmp("-spt", argv[i]) == 0) {
+			// Árvores de caminhos mínimos guardadas entre consultas (0 desativa o cache)
+			if (++i >= argc || sscanf(argv[i], "%d", &pathTrees) != 1 || pathTrees < 0) {
+				printf("O argumento '-spt' requer a quantidade de árvores!\n");
+				return 1;
+			}
+		} else if (strcmp("-crp", argv[i]) == 0) {
+			// Busca de caminhos por partição em células (CRP): vértices por célula
+			if (++i >= argc || sscanf(argv[i], "%d", &partitionCellSize) != 1 || partitionCellSize < 0) {
+				printf("O argumento '-crp' requer a quantidade de vértices por célula!\n");
+				return 1;
+			}
+		} else if (strcmp("-threads", argv[i]) == 0) {
+			// Buscas de árvore completa por delta-stepping nessa quantidade de threads (0 usa o Dijkstra)
+			if (++i >= argc || sscanf(argv[i], "%d", &searchThreads) != 1 || searchThreads < 0) {
+				printf("O argumento '-threads' requer a quantidade de threads!\n");
+				return 1;
+			}
+		} else if (strcmp("-stats", argv[i]) == 0) {
+			// Nome do arquivo (no diretório de saída) é opcional, sem ele o resumo vai para stderr
+			Stats_Enable();
+			if (i + 1 < argc && argv[i + 1][0] != '-') {
+				i++;
+				if (statsFileName != NULL) {
+					free(statsFileName);
+				}
+				statsFileName = malloc((strlen(argv[i]) + 1) * sizeof(char));
+				strcpy(statsFileName, argv[i]);
+			}
 		} else {
 			printf("Comando não reconhecido: '%s'\n", argv[i]);
 			return 1;
@@ -164,17 +219,41 @@ int main(int argc, char *argv[]) {
 		Files_SetViaFile(files, viaFile);	
 	}
 
-	initializeTrees();
-    initializeTables();
+	City city = City_Create();
+	City_SetLandmarkCount(city, landmarkCount);
+	City_SetPartitionCellSize(city, partitionCellSize);
+	City_SetPathTreeCapacity(city, pathTrees);
+	City_SetSearchThreads(city, searchThreads);
 	
-	processAll(files);
+	processAll(city, files);
+
+	if (socketPath != NULL) {
+		// Segunda cópia dos dados, para o servidor publicar versões sem bloquear as leituras
+		City replica = City_Create();
+		City_SetLandmarkCount(replica, landmarkCount);
+		City_SetPartitionCellSize(replica, partitionCellSize);
+		City_SetPathTreeCapacity(replica, pathTrees);
+		City_SetSearchThreads(replica, searchThreads);
+		startServer(city, replica, files, baseDir, entryFileName, queryFileName, socketPath);
+		City_Destroy(replica);
+	} else if (interactive) {
+		startInteraction(city, files, baseDir, entryFileName);
+	}
 
-	if (interactive) {
-		startInteraction(files, baseDir, entryFileName);
+	if (Stats_IsEnabled()) {
+		FILE *statsFile = stderr;
+		if (statsFileName != NULL)
+			statsFile = openFile(outputDir, statsFileName, "w");
+		if (statsFile != NULL) {
+			Stats_Dump(statsFile);
+			if (statsFile != stderr)
+				fclose(statsFile);
+		}
 	}
 
-	destroyTables();
-    destroyTrees();
+	City_Destroy(city);
+	PolygonCache_Destroy();
+	StringPool_Destroy();
 
 	// Limpeza
 	fclose(entryFile);
@@ -200,6 +279,10 @@ int main(int argc, char *argv[]) {
 		free(viaFileName);
 		fclose(viaFile);
 	}
+	if (statsFileName != NULL)
+		free(statsFileName);
+	if (socketPath != NULL)
+		free(socketPath);
 
 	Files_Destroy(files);
 }
\ No newline at end of file
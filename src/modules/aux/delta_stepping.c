@@ -0,0 +1,322 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+
+#include "delta_stepping.h"
+
+// Vértices amostrados (em largura, a partir das origens) para escolher delta
+#define SAMPLE_SIZE 1024
+
+typedef struct index_list_t {
+    int *items;
+    int length, capacity;
+} IndexList;
+
+// Pedido de relaxamento: 'edge' leva ao vértice 'index' com custo 'distance'
+typedef struct request_t {
+    int index;
+    double distance;
+    GraphEdge edge;
+} Request;
+
+typedef struct request_list_t {
+    Request *items;
+    int length, capacity;
+} RequestList;
+
+typedef struct run_t {
+    int threads;
+    bool quickest, reverse;
+    double budget, delta;
+    double *distance;
+    GraphEdge *via;
+    GraphNode *nodes;
+    int *roundMark;          // última rodada em que o vértice entrou na fronteira
+    long *settledMark;       // último balde (+1) em que o vértice foi fechado
+    RequestList *outbox;     // pedidos da thread i para a thread j em [i * threads + j]
+    bool *active;            // fronteira não vazia, por thread
+    long *minBucket;         // menor balde não vazio, por thread
+    pthread_barrier_t barrier;
+} Run;
+
+typedef struct worker_t {
+    Run *run;
+    int id;
+    IndexList *buckets;
+    long bucketCount;
+    long visits;
+} Worker;
+
+static void _push(IndexList *list, int index) {
+    if (list->length == list->capacity) {
+        list->capacity = list->capacity > 0 ? list->capacity * 2 : 16;
+        list->items = realloc(list->items, list->capacity * sizeof(int));
+    }
+    list->items[list->length++] = index;
+}
+
+static void _pushRequest(RequestList *list, int index, double distance, GraphEdge edge) {
+    if (list->length == list->capacity) {
+        list->capacity = list->capacity > 0 ? list->capacity * 2 : 16;
+        list->items = realloc(list->items, list->capacity * sizeof(Request));
+    }
+    list->items[list->length++] = (Request) {index, distance, edge};
+}
+
+static long _bucketOf(Run *run, double distance) {
+    return (long) (distance / run->delta);
+}
+
+static void _putInBucket(Worker *worker, int index, long bucket) {
+    if (bucket >= worker->bucketCount) {
+        long count = worker->bucketCount > 0 ? worker->bucketCount : 16;
+        while (count <= bucket)
+            count *= 2;
+        worker->buckets = realloc(worker->buckets, count * sizeof(IndexList));
+        for (long i = worker->bucketCount; i < count; i++)
+            worker->buckets[i] = (IndexList) {NULL, 0, 0};
+        worker->bucketCount = count;
+    }
+    _push(&worker->buckets[bucket], index);
+}
+
+// Média do custo das arestas dos primeiros vértices encontrados a partir das origens
+static double _chooseDelta(Run *run, GraphNode sources[], int count) {
+    GraphNode *queue = malloc(SAMPLE_SIZE * sizeof(GraphNode));
+    int length = 0, edges = 0;
+    double total = 0;
+    for (int i = 0; i < count && length < SAMPLE_SIZE; i++) {
+        if (sources[i] != NULL && run->roundMark[GraphNode_GetIndex(sources[i])] == 0) {
+            run->roundMark[GraphNode_GetIndex(sources[i])] = 1;
+            queue[length++] = sources[i];
+        }
+    }
+    for (int head = 0; head < length; head++) {
+        GraphEdge first = run->reverse ? GraphNode_GetFirstInEdge(queue[head]) : GraphNode_GetFirstEdge(queue[head]);
+        for (GraphEdge edge = first; edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double cost = GraphEdge_GetCost(edge, !run->quickest);
+            if (!isfinite(cost))
+                continue;
+            total += cost;
+            edges++;
+            GraphNode neighbor = run->reverse ? GraphEdge_GetSource(edge) : GraphEdge_GetTarget(edge);
+            if (length < SAMPLE_SIZE && run->roundMark[GraphNode_GetIndex(neighbor)] == 0) {
+                run->roundMark[GraphNode_GetIndex(neighbor)] = 1;
+                queue[length++] = neighbor;
+            }
+        }
+    }
+    for (int i = 0; i < length; i++)
+        run->roundMark[GraphNode_GetIndex(queue[i])] = 0;
+    free(queue);
+    return edges > 0 && total > 0 ? total / edges : 1;
+}
+
+// Menor balde não vazio depois de 'current', entre todas as threads (-1 se não houver). Entradas
+// de vértices que já mudaram de balde são descartadas
+static long _nextBucket(Worker *worker, long current) {
+    Run *run = worker->run;
+    long local = -1;
+    for (long b = current + 1; b < worker->bucketCount && local < 0; b++) {
+        IndexList *bucket = &worker->buckets[b];
+        int kept = 0;
+        for (int i = 0; i < bucket->length; i++) {
+            if (_bucketOf(run, run->distance[bucket->items[i]]) == b)
+                bucket->items[kept++] = bucket->items[i];
+        }
+        bucket->length = kept;
+        if (kept > 0)
+            local = b;
+    }
+    run->minBucket[worker->id] = local;
+    pthread_barrier_wait(&run->barrier);
+
+    long next = -1;
+    for (int t = 0; t < run->threads; t++) {
+        if (run->minBucket[t] >= 0 && (next < 0 || run->minBucket[t] < next))
+            next = run->minBucket[t];
+    }
+    return next;
+}
+
+// Tira do balde os vértices que ainda pertencem a ele, sem repetir na rodada, e os acrescenta aos
+// fechados do balde
+static void _takeBucket(Worker *worker, long current, int round, IndexList *frontier, IndexList *settled) {
+    Run *run = worker->run;
+    frontier->length = 0;
+    // O balde pode não existir nesta thread
+    if (current >= worker->bucketCount)
+        return;
+    IndexList *bucket = &worker->buckets[current];
+    for (int i = 0; i < bucket->length; i++) {
+        int index = bucket->items[i];
+        if (_bucketOf(run, run->distance[index]) != current || run->roundMark[index] == round)
+            continue;
+        run->roundMark[index] = round;
+        _push(frontier, index);
+        if (run->settledMark[index] != current + 1) {
+            run->settledMark[index] = current + 1;
+            _push(settled, index);
+        }
+    }
+    bucket->length = 0;
+}
+
+// Gera os pedidos das arestas leves (ou pesadas) dos vértices da lista para as threads donas dos
+// vizinhos
+static void _relax(Worker *worker, IndexList *list, bool light) {
+    Run *run = worker->run;
+    for (int i = 0; i < list->length; i++) {
+        int index = list->items[i];
+        double distance = run->distance[index];
+        if (light)
+            worker->visits++;
+        GraphNode node = run->nodes[index];
+        GraphEdge first = run->reverse ? GraphNode_GetFirstInEdge(node) : GraphNode_GetFirstEdge(node);
+        for (GraphEdge edge = first; edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double cost = GraphEdge_GetCost(edge, !run->quickest);
+            if (!isfinite(cost) || (cost <= run->delta) != light)
+                continue;
+            double newDistance = distance + cost;
+            if (newDistance > run->budget)
+                continue;
+            GraphNode neighbor = run->reverse ? GraphEdge_GetSource(edge) : GraphEdge_GetTarget(edge);
+            int neighborIndex = GraphNode_GetIndex(neighbor);
+            int owner = neighborIndex % run->threads;
+            // Só o dono lê o custo atual do vértice
+            if (owner == worker->id && newDistance >= run->distance[neighborIndex])
+                continue;
+            _pushRequest(&run->outbox[worker->id * run->threads + owner], neighborIndex, newDistance, edge);
+        }
+    }
+}
+
+// Aplica os pedidos recebidos de todas as threads
+static void _apply(Worker *worker) {
+    Run *run = worker->run;
+    for (int from = 0; from < run->threads; from++) {
+        RequestList *inbox = &run->outbox[from * run->threads + worker->id];
+        for (int i = 0; i < inbox->length; i++) {
+            Request *request = &inbox->items[i];
+            if (request->distance >= run->distance[request->index])
+                continue;
+            run->distance[request->index] = request->distance;
+            run->via[request->index] = request->edge;
+            run->nodes[request->index] = run->reverse ? GraphEdge_GetSource(request->edge)
+                                                      : GraphEdge_GetTarget(request->edge);
+            _putInBucket(worker, request->index, _bucketOf(run, request->distance));
+        }
+        inbox->length = 0;
+    }
+}
+
+static void *_work(void *workerVoid) {
+    Worker *worker = (Worker *) workerVoid;
+    Run *run = worker->run;
+    IndexList frontier = {NULL, 0, 0}, settled = {NULL, 0, 0};
+    int round = 0;
+
+    for (long current = _nextBucket(worker, -1); current >= 0; current = _nextBucket(worker, current)) {
+        // Arestas leves até o balde se esvaziar em todas as threads: podem devolver vértices a ele
+        settled.length = 0;
+        while (true) {
+            _takeBucket(worker, current, ++round, &frontier, &settled);
+            run->active[worker->id] = frontier.length > 0;
+            pthread_barrier_wait(&run->barrier);
+            bool any = false;
+            for (int t = 0; t < run->threads; t++)
+                any = any || run->active[t];
+            if (!any)
+                break;
+            _relax(worker, &frontier, true);
+            pthread_barrier_wait(&run->barrier);
+            _apply(worker);
+            pthread_barrier_wait(&run->barrier);
+        }
+        // Arestas pesadas, uma vez por vértice fechado no balde: só levam a baldes seguintes
+        _relax(worker, &settled, false);
+        pthread_barrier_wait(&run->barrier);
+        _apply(worker);
+    }
+
+    free(frontier.items);
+    free(settled.items);
+    return NULL;
+}
+
+void DeltaStepping_Run(int size, GraphNode sources[], int count, bool quickest, bool reverse, double budget,
+                       int threads, double distance[], GraphEdge via[]) {
+    if (threads < 1)
+        threads = 1;
+    if (threads > size && size > 0)
+        threads = size;
+
+    Run run;
+    run.threads = threads;
+    run.quickest = quickest;
+    run.reverse = reverse;
+    run.budget = budget;
+    run.distance = distance;
+    run.via = via != NULL ? via : malloc(size * sizeof(GraphEdge));
+    run.nodes = malloc(size * sizeof(GraphNode));
+    run.roundMark = calloc(size, sizeof(int));
+    run.settledMark = calloc(size, sizeof(long));
+    run.outbox = calloc(threads * threads, sizeof(RequestList));
+    run.active = calloc(threads, sizeof(bool));
+    run.minBucket = calloc(threads, sizeof(long));
+    run.delta = _chooseDelta(&run, sources, count);
+    pthread_barrier_init(&run.barrier, NULL, threads);
+
+    Worker *workers = calloc(threads, sizeof(Worker));
+    for (int t = 0; t < threads; t++) {
+        workers[t].run = &run;
+        workers[t].id = t;
+    }
+    for (int i = 0; i < size; i++) {
+        distance[i] = INFINITY;
+        run.via[i] = NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        if (sources[i] == NULL)
+            continue;
+        int index = GraphNode_GetIndex(sources[i]);
+        if (distance[index] == 0)
+            continue;
+        distance[index] = 0;
+        run.nodes[index] = sources[i];
+        _putInBucket(&workers[index % threads], index, 0);
+    }
+
+    // A thread atual é a de número 0
+    pthread_t *ids = malloc(threads * sizeof(pthread_t));
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&ids[t], NULL, _work, &workers[t]) != 0) {
+            perror("Erro ao criar thread");
+            exit(1);
+        }
+    }
+    _work(&workers[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(ids[t], NULL);
+
+    // Vértices fechados pelas outras threads contam para a medição da thread atual
+    for (int t = 0; t < threads; t++) {
+        Stats_Visits += workers[t].visits;
+        for (long b = 0; b < workers[t].bucketCount; b++)
+            free(workers[t].buckets[b].items);
+        free(workers[t].buckets);
+    }
+    for (int i = 0; i < threads * threads; i++)
+        free(run.outbox[i].items);
+
+    pthread_barrier_destroy(&run.barrier);
+    free(ids);
+    free(workers);
+    free(run.minBucket);
+    free(run.active);
+    free(run.outbox);
+    free(run.settledMark);
+    free(run.roundMark);
+    free(run.nodes);
+    if (via == NULL)
+        free(run.via);
+}
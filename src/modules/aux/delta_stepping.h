@@ -0,0 +1,28 @@
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "graph_node.h"
+#include "../util/stats.h"
+
+// Caminhos mínimos a partir de várias origens por delta-stepping, em várias threads. Os vértices
+// ficam em baldes de largura delta pelo custo provisório; um balde inteiro é processado por vez,
+// relaxando primeiro as arestas leves (custo até delta, que podem devolver vértices ao mesmo
+// balde) e depois as pesadas. Cada thread é dona dos vértices de índice congruente a ela e só ela
+// altera seus custos, então as threads trocam pedidos de relaxamento entre barreiras, sem travas.
+// Serve para árvores completas (ou limitadas por custo); para um único destino o Dijkstra
+// bidirecional fecha bem menos vértices
+//
+// 'size' é a quantidade de índices de vértice; as origens (NULL é ignorado) ficam com custo 0. Com
+// 'reverse' a busca segue as arestas que chegam, dando o custo de cada vértice até as origens. Só
+// são alcançados vértices com custo até 'budget'. 'distance' recebe o custo (infinito onde não foi
+// alcançado) e 'via', se não for NULL, a aresta pela qual o vértice foi alcançado (NULL nas
+// origens e onde não foi alcançado). Delta é a média do custo das arestas perto das origens
+void DeltaStepping_Run(int size, GraphNode sources[], int count, bool quickest, bool reverse, double budget,
+                       int threads, double distance[], GraphEdge via[]);
+
+#endif
@@ -0,0 +1,160 @@
+#include "facility_map.h"
+
+typedef struct facility_map_t {
+    double *distance;
+    void **nearest;
+    GraphNode *next;
+} *FacilityMapImpl;
+
+typedef struct facility_map_cache_t {
+    int slots;
+    FacilityMapImpl *maps;
+    unsigned long *versions;
+    pthread_mutex_t lock;
+} *FacilityMapCacheImpl;
+
+// Equipamento de 'index': o do primeiro vértice já resolvido no caminho, gravado em todo o caminho
+static void *_resolveNearest(FacilityMapImpl map, int index) {
+    int current = index;
+    while (map->nearest[current] == NULL && map->next[current] != NULL)
+        current = GraphNode_GetIndex(map->next[current]);
+    void *nearest = map->nearest[current];
+    for (current = index; map->nearest[current] == NULL && map->next[current] != NULL;
+         current = GraphNode_GetIndex(map->next[current]))
+        map->nearest[current] = nearest;
+    return nearest;
+}
+
+static void _createParallel(FacilityMapImpl map, int size, GraphNode seeds[], int count, bool quickest, int threads) {
+    GraphEdge *via = malloc(size * sizeof(GraphEdge));
+    DeltaStepping_Run(size, seeds, count, quickest, true, INFINITY, threads, map->distance, via);
+    for (int i = 0; i < size; i++)
+        map->next[i] = via[i] != NULL ? GraphEdge_GetTarget(via[i]) : NULL;
+    for (int i = 0; i < size; i++) {
+        if (isfinite(map->distance[i]))
+            _resolveNearest(map, i);
+    }
+    free(via);
+}
+
+FacilityMap FacilityMap_Create(int size, GraphNode seeds[], void *facilities[], int count, bool quickest, int threads) {
+    FacilityMapImpl map = malloc(sizeof(struct facility_map_t));
+    map->distance = malloc(size * sizeof(double));
+    map->nearest = malloc(size * sizeof(void *));
+    map->next = malloc(size * sizeof(GraphNode));
+    for (int i = 0; i < size; i++) {
+        map->distance[i] = INFINITY;
+        map->nearest[i] = NULL;
+        map->next[i] = NULL;
+    }
+
+    // Vários equipamentos no mesmo vértice: fica o primeiro
+    for (int i = 0; i < count; i++) {
+        if (seeds[i] != NULL && map->nearest[GraphNode_GetIndex(seeds[i])] == NULL)
+            map->nearest[GraphNode_GetIndex(seeds[i])] = facilities[i];
+    }
+    if (threads > 0) {
+        _createParallel(map, size, seeds, count, quickest, threads);
+        return map;
+    }
+
+    GraphNode *nodes = malloc(size * sizeof(GraphNode));
+    IndexHeap heap = IndexHeap_Create(size);
+    for (int i = 0; i < count; i++) {
+        if (seeds[i] == NULL)
+            continue;
+        int index = GraphNode_GetIndex(seeds[i]);
+        if (map->distance[index] == 0)
+            continue;
+        nodes[index] = seeds[i];
+        map->distance[index] = 0;
+        IndexHeap_Push(heap, index, 0);
+    }
+
+    while (!IndexHeap_IsEmpty(heap)) {
+        double distance;
+        int index = IndexHeap_Extract(heap, &distance);
+        STATS_VISIT();
+        GraphNode node = nodes[index];
+        for (GraphEdge edge = GraphNode_GetFirstInEdge(node); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double newDistance = distance + GraphEdge_GetCost(edge, !quickest);
+            GraphNode neighbor = GraphEdge_GetSource(edge);
+            int neighborIndex = GraphNode_GetIndex(neighbor);
+            if (isfinite(newDistance) && newDistance < map->distance[neighborIndex]) {
+                map->distance[neighborIndex] = newDistance;
+                map->nearest[neighborIndex] = map->nearest[index];
+                map->next[neighborIndex] = node;
+                nodes[neighborIndex] = neighbor;
+                IndexHeap_Push(heap, neighborIndex, newDistance);
+            }
+        }
+    }
+
+    IndexHeap_Destroy(heap);
+    free(nodes);
+    return map;
+}
+
+void *FacilityMap_GetNearest(FacilityMap mapVoid, GraphNode node, double *distance) {
+    FacilityMapImpl map = (FacilityMapImpl) mapVoid;
+    int index = GraphNode_GetIndex(node);
+    if (distance != NULL)
+        *distance = map->distance[index];
+    return map->nearest[index];
+}
+
+GraphNode FacilityMap_GetNext(FacilityMap map, GraphNode node) {
+    return ((FacilityMapImpl) map)->next[GraphNode_GetIndex(node)];
+}
+
+void FacilityMap_Destroy(FacilityMap mapVoid) {
+    FacilityMapImpl map = (FacilityMapImpl) mapVoid;
+    free(map->distance);
+    free(map->nearest);
+    free(map->next);
+    free(map);
+}
+
+FacilityMapCache FacilityMapCache_Create(int slots) {
+    FacilityMapCacheImpl cache = malloc(sizeof(struct facility_map_cache_t));
+    cache->slots = slots;
+    cache->maps = calloc(slots, sizeof(FacilityMapImpl));
+    cache->versions = calloc(slots, sizeof(unsigned long));
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+void FacilityMapCache_Lock(FacilityMapCache cache) {
+    pthread_mutex_lock(&((FacilityMapCacheImpl) cache)->lock);
+}
+
+void FacilityMapCache_Unlock(FacilityMapCache cache) {
+    pthread_mutex_unlock(&((FacilityMapCacheImpl) cache)->lock);
+}
+
+FacilityMap FacilityMapCache_Get(FacilityMapCache cacheVoid, int slot, unsigned long version) {
+    FacilityMapCacheImpl cache = (FacilityMapCacheImpl) cacheVoid;
+    if (cache->maps[slot] == NULL || cache->versions[slot] != version)
+        return NULL;
+    return cache->maps[slot];
+}
+
+void FacilityMapCache_Set(FacilityMapCache cacheVoid, int slot, unsigned long version, FacilityMap map) {
+    FacilityMapCacheImpl cache = (FacilityMapCacheImpl) cacheVoid;
+    if (cache->maps[slot] != NULL)
+        FacilityMap_Destroy(cache->maps[slot]);
+    cache->maps[slot] = map;
+    cache->versions[slot] = version;
+}
+
+void FacilityMapCache_Destroy(FacilityMapCache cacheVoid) {
+    FacilityMapCacheImpl cache = (FacilityMapCacheImpl) cacheVoid;
+    for (int i = 0; i < cache->slots; i++) {
+        if (cache->maps[i] != NULL)
+            FacilityMap_Destroy(cache->maps[i]);
+    }
+    free(cache->maps);
+    free(cache->versions);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
@@ -0,0 +1,52 @@
+#ifndef FACILITY_MAP_H
+#define FACILITY_MAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "delta_stepping.h"
+#include "graph_node.h"
+#include "../data_structures/index_heap.h"
+#include "../util/stats.h"
+
+// Para cada vértice do grafo, o equipamento (de um conjunto, ex.: todos os hidrantes) mais próximo
+// pelas ruas, indo do vértice até ele, e o próximo vértice desse caminho. Sai de um único Dijkstra
+// com várias origens pelas arestas reversas, a partir dos vértices de todos os equipamentos
+typedef void *FacilityMap;
+
+// Conjunto de mapas por posição, com uma versão dos dados da cidade: mapas de outra versão não valem
+typedef void *FacilityMapCache;
+
+// 'seeds[i]' é o vértice do equipamento 'facilities[i]' (NULL é ignorado); 'size' é a quantidade
+// de índices de vértice. Com 'threads' > 0 a busca é por delta-stepping e o equipamento de cada
+// vértice sai depois, seguindo o caminho até a origem
+FacilityMap FacilityMap_Create(int size, GraphNode seeds[], void *facilities[], int count, bool quickest, int threads);
+
+// Equipamento mais próximo a partir de 'node' (NULL se nenhum for alcançável), com o custo em
+// 'distance' (se não for NULL)
+void *FacilityMap_GetNearest(FacilityMap map, GraphNode node, double *distance);
+
+// Próximo vértice do caminho de 'node' até seu equipamento mais próximo (NULL no próprio vértice
+// do equipamento)
+GraphNode FacilityMap_GetNext(FacilityMap map, GraphNode node);
+
+void FacilityMap_Destroy(FacilityMap map);
+
+FacilityMapCache FacilityMapCache_Create(int slots);
+
+// Os mapas só podem ser obtidos, trocados e usados com o cache travado
+void FacilityMapCache_Lock(FacilityMapCache cache);
+
+void FacilityMapCache_Unlock(FacilityMapCache cache);
+
+// Mapa da posição 'slot' calculado na versão 'version', ou NULL
+FacilityMap FacilityMapCache_Get(FacilityMapCache cache, int slot, unsigned long version);
+
+// Guarda 'map' (e sua versão) na posição, liberando o anterior
+void FacilityMapCache_Set(FacilityMapCache cache, int slot, unsigned long version, FacilityMap map);
+
+void FacilityMapCache_Destroy(FacilityMapCache cache);
+
+#endif
@@ -6,11 +6,13 @@
 typedef struct graph_node_t *GraphNodeImpl;
 
 typedef struct edge_t {
-    char name[64];
-    Block leftBlock;
-    Block rightBlock;
+    char *name;
+    char *leftCep;   // quadras dos lados, buscadas pelo CEP (podem ser removidas depois)
+    char *rightCep;
     double length;
     double speed;
+    bool blocked;    // fechada por brn (custo infinito, mas o comprimento original fica)
+    GraphNodeImpl source;
     GraphNodeImpl node;
 } *Edge;
 
@@ -27,21 +29,21 @@ typedef struct graph_node_t {
     char id[32];
     Point point;
     EdgeList edges;
-    double distance;
-    struct graph_node_t *parent;
-    bool closed;
-    char *streetName;
+    EdgeList inEdges;  // arestas que chegam ao vértice (pertencem à lista 'edges' da origem)
+    int index;
 } *GraphNodeImpl;
 
-GraphNode GraphNode_Create(char id[], double x, double y) {
+GraphNode GraphNode_Create(char id[], double x, double y, int index) {
     GraphNodeImpl node = malloc(sizeof(struct graph_node_t));
     strcpy(node->id, id);
     node->point = Point_Create(x, y);
     node->edges = malloc(sizeof(struct edge_list_t));
     node->edges->first = NULL;
     node->edges->last = NULL;
-    node->closed = false;
-    node->streetName = NULL;
+    node->inEdges = malloc(sizeof(struct edge_list_t));
+    node->inEdges->first = NULL;
+    node->inEdges->last = NULL;
+    node->index = index;
     return node;
 }
 
@@ -55,37 +57,49 @@ void GraphNode_Destroy(GraphNode nodeVoid) {
         current = next;
     }
     free(node->edges);
+    current = node->inEdges->first;
+    while (current != NULL) {
+        EdgeListItem next = current->next;
+        free(current);
+        current = next;
+    }
+    free(node->inEdges);
     Point_Destroy(node->point);
-    if (node->streetName != NULL)
-        free(node->streetName);
     free(node);
 }
 
-void GraphNode_InsertEdge(GraphNode nodeVoid, GraphNode other, Block leftBlock, Block rightBlock, 
+static void _appendEdge(EdgeList list, Edge edge) {
+    EdgeListItem item = malloc(sizeof(struct edge_list_item_t));
+    item->edge = edge;
+    item->next = NULL;
+
+    if (list->first == NULL) {
+        item->previous = NULL;
+        list->first = item;
+        list->last = item;
+    } else {
+        item->previous = list->last;
+        list->last->next = item;
+        list->last = item;
+    }
+}
+
+void GraphNode_InsertEdge(GraphNode nodeVoid, GraphNode other, char leftCep[], char rightCep[], 
                           double length, double speed, char name[]) {
     GraphNodeImpl node = (GraphNodeImpl) nodeVoid;
     
     Edge edge = malloc(sizeof(struct edge_t));
+    edge->source = node;
     edge->node = (GraphNodeImpl) other;
-    edge->leftBlock = leftBlock;
-    edge->rightBlock = rightBlock;
+    edge->leftCep = StringPool_Intern(leftCep);
+    edge->rightCep = StringPool_Intern(rightCep);
     edge->length = length;
     edge->speed = speed;
-    strcpy(edge->name, name);
+    edge->blocked = false;
+    edge->name = StringPool_Intern(name);
 
-    EdgeListItem item = malloc(sizeof(struct edge_list_item_t));
-    item->edge = edge;
-    item->next = NULL;
-
-    if (node->edges->first == NULL) {
-        item->previous = NULL;
-        node->edges->first = item;
-        node->edges->last = item;
-    } else {
-        item->previous = node->edges->last;
-        node->edges->last->next = item;
-        node->edges->last = item;
-    }
+    _appendEdge(node->edges, edge);
+    _appendEdge(edge->node->inEdges, edge);
 }
 
 GraphNode GraphNode_GoTo(GraphNode nodeVoid, char direction[], char streetName[]) {
@@ -116,50 +130,14 @@ GraphNode GraphNode_GoTo(GraphNode nodeVoid, char direction[], char streetName[]
     return NULL;
 }
 
-void GraphNode_CollectNeighbors(GraphNode nodeVoid, BinaryHeap heap, bool byLength) {
-    GraphNodeImpl node = (GraphNodeImpl) nodeVoid;
-
-    node->closed = true;
-    EdgeListItem current = node->edges->first;
-    while (current != NULL) {
-        GraphNodeImpl currentNode = current->edge->node;
-
-        bool newNode = currentNode->closed == false && currentNode->parent == NULL;
-
-        double newdist;
-        if (byLength) {
-            newdist = node->distance + current->edge->length;
-        } else {
-            newdist = node->distance + current->edge->length / current->edge->speed;
-            if (current->edge->speed == 0) {
-                newdist = INFINITY;
-            }
-        }
-
-        if (isfinite(newdist) && (isinf(currentNode->distance) || currentNode->distance > newdist)) {
-            currentNode->distance = newdist;
-            currentNode->parent = node;
-            if (currentNode->streetName == NULL)
-                currentNode->streetName = malloc(64 * sizeof(char));
-            strcpy(currentNode->streetName, current->edge->name);
-        } else if (newNode) {
-            newNode = false;
-        }
-
-        if (newNode) {
-            BinHeap_Insert(heap, currentNode);
-        }
-        current = current->next;
-    }
-}
-
-void GraphNode_DestroyEdgesAffected(GraphNode nodeVoid, Polygon polygon) {
+bool GraphNode_DestroyEdgesAffected(GraphNode nodeVoid, Polygon polygon) {
     GraphNodeImpl node = (GraphNodeImpl) nodeVoid;
 
     double x1 = Point_GetX(node->point);
     double y1 = Point_GetY(node->point);
 
     bool nodeInside = Polygon_IsPointInside(polygon, x1, y1);
+    bool changed = false;
 
     EdgeListItem current = node->edges->first;
     while (current != NULL) {
@@ -168,33 +146,18 @@ void GraphNode_DestroyEdgesAffected(GraphNode nodeVoid, Polygon polygon) {
 
         if (nodeInside || Polygon_IsPointInside(polygon, x2, y2) || 
                 Polygon_DoesSegmentIntersect(polygon, x1, y1, x2, y2)) {
-            current->edge->length = INFINITY;
-            current->edge->speed = 0;
+            changed = changed || !current->edge->blocked;
+            current->edge->blocked = true;
         }
         current = current->next;
     }
-}
-
-int GraphNode_CompareAsc(const void *a, const void *b) {
-    return ((GraphNodeImpl) a)->distance - ((GraphNodeImpl) b)->distance;
-}
-
-int GraphNode_CompareDesc(const void *a, const void *b) {
-    return ((GraphNodeImpl) b)->distance - ((GraphNodeImpl) a)->distance;
-}
-
-bool GraphNode_IsClosed(GraphNode node) {
-    return ((GraphNodeImpl) node)->closed;
+    return changed;
 }
 
 char *GraphNode_GetId(GraphNode node) {
     return ((GraphNodeImpl) node)->id;
 }
 
-GraphNode GraphNode_GetParent(GraphNode node) {
-    return ((GraphNodeImpl) node)->parent;
-}
-
 Point GraphNode_GetPoint(GraphNode node) {
    return ((GraphNodeImpl) node)->point;
 }
@@ -207,22 +170,54 @@ double GraphNode_GetY(GraphNode node) {
     return Point_GetY(((GraphNodeImpl) node)->point);
 }
 
-void GraphNode_SetParent(GraphNode node, GraphNode parent) {
-    ((GraphNodeImpl) node)->parent = parent;
+int GraphNode_GetIndex(GraphNode node) {
+    return ((GraphNodeImpl) node)->index;
+}
+
+GraphEdge GraphNode_GetFirstEdge(GraphNode node) {
+    return ((GraphNodeImpl) node)->edges->first;
+}
+
+GraphEdge GraphNode_GetFirstInEdge(GraphNode node) {
+    return ((GraphNodeImpl) node)->inEdges->first;
+}
+
+GraphEdge GraphEdge_GetNext(GraphEdge edge) {
+    return ((EdgeListItem) edge)->next;
+}
+
+GraphNode GraphEdge_GetTarget(GraphEdge edge) {
+    return ((EdgeListItem) edge)->edge->node;
+}
+
+GraphNode GraphEdge_GetSource(GraphEdge edge) {
+    return ((EdgeListItem) edge)->edge->source;
+}
+
+char *GraphEdge_GetName(GraphEdge edge) {
+    return ((EdgeListItem) edge)->edge->name;
 }
 
-void GraphNode_SetDistance(GraphNode node, double distance) {
-    ((GraphNodeImpl) node)->distance = distance;
+char *GraphEdge_GetLeftCep(GraphEdge edge) {
+    return ((EdgeListItem) edge)->edge->leftCep;
 }
 
-void GraphNode_SetClosed(GraphNode node, bool closed) {
-    ((GraphNodeImpl) node)->closed = closed;
+char *GraphEdge_GetRightCep(GraphEdge edge) {
+    return ((EdgeListItem) edge)->edge->rightCep;
 }
 
-double GraphNode_GetDistance(GraphNode node) {
-    return ((GraphNodeImpl) node)->distance;
+double GraphEdge_GetCost(GraphEdge edgeVoid, bool byLength) {
+    Edge edge = ((EdgeListItem) edgeVoid)->edge;
+    if (edge->blocked)
+        return INFINITY;
+    return GraphEdge_GetUnblockedCost(edgeVoid, byLength);
 }
 
-char *GraphNode_GetStreetName(GraphNode node) {
-    return ((GraphNodeImpl) node)->streetName;
+double GraphEdge_GetUnblockedCost(GraphEdge edgeVoid, bool byLength) {
+    Edge edge = ((EdgeListItem) edgeVoid)->edge;
+    if (byLength)
+        return edge->length;
+    if (edge->speed == 0)
+        return INFINITY;
+    return edge->length / edge->speed;
 }
@@ -2,48 +2,60 @@
 #define GRAPH_NODE_H
 
 #include <stdlib.h>
-#include "../data_structures/binary_heap.h"
+#include <stdbool.h>
 #include "polygon.h"
+#include "../util/string_pool.h"
 
 typedef void *GraphNode;
+typedef void *GraphEdge;
 
-GraphNode GraphNode_Create(char id[], double x, double y);
+// O índice identifica o vértice nos vetores de estado da busca de caminhos, que não altera o grafo
+GraphNode GraphNode_Create(char id[], double x, double y, int index);
 
 void GraphNode_Destroy(GraphNode node);
 
-void GraphNode_InsertEdge(GraphNode nodeVoid, GraphNode other, Block leftBlock, Block rightBlock, 
+void GraphNode_InsertEdge(GraphNode nodeVoid, GraphNode other, char leftCep[], char rightCep[], 
                           double length, double speed, char name[]);
 
-void GraphNode_CollectNeighbors(GraphNode nodeVoid, BinaryHeap heap, bool byLength);
-
 GraphNode GraphNode_GoTo(GraphNode nodeVoid, char direction[], char streetName[]);
 
-void GraphNode_DestroyEdgesAffected(GraphNode nodeVoid, Polygon polygon);
-
-int GraphNode_CompareAsc(const void *a, const void *b);
-
-int GraphNode_CompareDesc(const void *a, const void *b);
-
-bool GraphNode_IsClosed(GraphNode node);
+// Bloqueia as arestas que saem do vértice e tocam o polígono. Retorna se alguma foi bloqueada agora
+bool GraphNode_DestroyEdgesAffected(GraphNode nodeVoid, Polygon polygon);
 
 char *GraphNode_GetId(GraphNode node);
 
-GraphNode GraphNode_GetParent(GraphNode node);
-
 Point GraphNode_GetPoint(GraphNode node);
 
 double GraphNode_GetX(GraphNode node);
 
 double GraphNode_GetY(GraphNode node);
 
-void GraphNode_SetParent(GraphNode node, GraphNode parent);
+int GraphNode_GetIndex(GraphNode node);
+
+// Arestas que saem do vértice, percorridas com GraphEdge_GetNext até NULL
+GraphEdge GraphNode_GetFirstEdge(GraphNode node);
+
+// Arestas que chegam ao vértice (adjacência reversa, montada em GraphNode_InsertEdge), percorridas
+// da mesma forma. São as mesmas arestas da origem, então bloqueios valem para as duas listas
+GraphEdge GraphNode_GetFirstInEdge(GraphNode node);
+
+GraphEdge GraphEdge_GetNext(GraphEdge edge);
+
+GraphNode GraphEdge_GetSource(GraphEdge edge);
+
+GraphNode GraphEdge_GetTarget(GraphEdge edge);
+
+char *GraphEdge_GetName(GraphEdge edge);
 
-void GraphNode_SetDistance(GraphNode node, double distance);
+// CEPs das quadras à esquerda e à direita da rua (internados, podem não existir na cidade)
+char *GraphEdge_GetLeftCep(GraphEdge edge);
 
-void GraphNode_SetClosed(GraphNode node, bool closed);
+char *GraphEdge_GetRightCep(GraphEdge edge);
 
-double GraphNode_GetDistance(GraphNode node);
+// Custo de percorrer a aresta: comprimento ou tempo (comprimento / velocidade); infinito se bloqueada
+double GraphEdge_GetCost(GraphEdge edge, bool byLength);
 
-char *GraphNode_GetStreetName(GraphNode node);
+// Custo da aresta ignorando o bloqueio (ex.: para sair de uma área bloqueada)
+double GraphEdge_GetUnblockedCost(GraphEdge edge, bool byLength);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "landmarks.h"
+
+typedef struct landmarks_t {
+    int size;       // quantidade de índices de vértice
+    int stride;     // marcos reservados por vértice nas tabelas
+    int count;      // marcos efetivamente escolhidos
+    // [métrica][vértice * stride + marco], métrica 0 = comprimento, 1 = tempo
+    double *from[2];  // distância do marco ao vértice
+    double *to[2];    // distância do vértice ao marco
+} *LandmarksImpl;
+
+// Dijkstra completo a partir de 'source', para frente ou para trás (adjacência reversa),
+// escrevendo a distância de cada índice em 'distance'
+static void _fullDijkstra(GraphNode *nodes, int size, GraphNode source, bool backward, bool byLength,
+                          double *distance) {
+    for (int i = 0; i < size; i++)
+        distance[i] = INFINITY;
+    IndexHeap heap = IndexHeap_Create(size);
+    distance[GraphNode_GetIndex(source)] = 0;
+    IndexHeap_Push(heap, GraphNode_GetIndex(source), 0);
+
+    while (!IndexHeap_IsEmpty(heap)) {
+        double current;
+        GraphNode node = nodes[IndexHeap_Extract(heap, &current)];
+        GraphEdge first = backward ? GraphNode_GetFirstInEdge(node) : GraphNode_GetFirstEdge(node);
+        for (GraphEdge edge = first; edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            GraphNode neighbor = backward ? GraphEdge_GetSource(edge) : GraphEdge_GetTarget(edge);
+            int index = GraphNode_GetIndex(neighbor);
+            double newDistance = current + GraphEdge_GetCost(edge, byLength);
+            if (isfinite(newDistance) && newDistance < distance[index]) {
+                distance[index] = newDistance;
+                IndexHeap_Push(heap, index, newDistance);
+            }
+        }
+    }
+    IndexHeap_Destroy(heap);
+}
+
+// Vértice de maior distância finita e positiva em 'distance' (NULL se não houver)
+static GraphNode _farthest(GraphNode *nodes, int size, double *distance) {
+    GraphNode farthest = NULL;
+    double max = 0;
+    for (int i = 0; i < size; i++) {
+        if (nodes[i] != NULL && isfinite(distance[i]) && distance[i] > max) {
+            max = distance[i];
+            farthest = nodes[i];
+        }
+    }
+    return farthest;
+}
+
+Landmarks Landmarks_Create(GraphNode *nodes, int size, int count) {
+    GraphNode first = NULL;
+    for (int i = 0; i < size && first == NULL; i++)
+        first = nodes[i];
+    if (first == NULL || count <= 0)
+        return NULL;
+
+    LandmarksImpl landmarks = malloc(sizeof(struct landmarks_t));
+    landmarks->size = size;
+    landmarks->stride = count;
+    landmarks->count = 0;
+    for (int m = 0; m < 2; m++) {
+        landmarks->from[m] = malloc((size_t) size * count * sizeof(double));
+        landmarks->to[m] = malloc((size_t) size * count * sizeof(double));
+    }
+
+    double *distance = malloc(size * sizeof(double));
+    // Menor distância (comprimento) de cada vértice a algum marco já escolhido
+    double *nearest = malloc(size * sizeof(double));
+
+    // O primeiro marco é o vértice mais distante de um vértice qualquer
+    _fullDijkstra(nodes, size, first, false, true, distance);
+    GraphNode landmark = _farthest(nodes, size, distance);
+    if (landmark == NULL)
+        landmark = first;
+    for (int i = 0; i < size; i++)
+        nearest[i] = INFINITY;
+
+    while (landmark != NULL && landmarks->count < count) {
+        int l = landmarks->count++;
+        for (int m = 0; m < 2; m++) {
+            bool byLength = m == 0;
+            _fullDijkstra(nodes, size, landmark, false, byLength, distance);
+            for (int i = 0; i < size; i++)
+                landmarks->from[m][i * count + l] = distance[i];
+            if (byLength) {
+                for (int i = 0; i < size; i++) {
+                    if (distance[i] < nearest[i])
+                        nearest[i] = distance[i];
+                }
+            }
+            _fullDijkstra(nodes, size, landmark, true, byLength, distance);
+            for (int i = 0; i < size; i++)
+                landmarks->to[m][i * count + l] = distance[i];
+        }
+        landmark = _farthest(nodes, size, nearest);
+    }
+
+    free(distance);
+    free(nearest);
+    return landmarks;
+}
+
+int Landmarks_GetCount(Landmarks landmarks) {
+    return ((LandmarksImpl) landmarks)->count;
+}
+
+double Landmarks_LowerBound(Landmarks landmarksVoid, GraphNode from, GraphNode to, bool byLength) {
+    LandmarksImpl landmarks = (LandmarksImpl) landmarksVoid;
+    int m = byLength ? 0 : 1;
+    double *fromV = &landmarks->from[m][GraphNode_GetIndex(from) * landmarks->stride];
+    double *fromT = &landmarks->from[m][GraphNode_GetIndex(to) * landmarks->stride];
+    double *toV = &landmarks->to[m][GraphNode_GetIndex(from) * landmarks->stride];
+    double *toT = &landmarks->to[m][GraphNode_GetIndex(to) * landmarks->stride];
+
+    // d(v, t) >= d(v, L) - d(t, L) e d(v, t) >= d(L, t) - d(L, v). Termos indefinidos (marco
+    // inalcançável dos dois lados) são ignorados
+    double bound = 0;
+    for (int l = 0; l < landmarks->count; l++) {
+        double a = toV[l] - toT[l];
+        double b = fromT[l] - fromV[l];
+        if (!isnan(a) && a > bound)
+            bound = a;
+        if (!isnan(b) && b > bound)
+            bound = b;
+    }
+    return bound;
+}
+
+void Landmarks_Destroy(Landmarks landmarksVoid) {
+    LandmarksImpl landmarks = (LandmarksImpl) landmarksVoid;
+    for (int m = 0; m < 2; m++) {
+        free(landmarks->from[m]);
+        free(landmarks->to[m]);
+    }
+    free(landmarks);
+}
@@ -0,0 +1,31 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "graph_node.h"
+#include "../data_structures/index_heap.h"
+
+// Marcos para busca de caminhos ALT (A*, marcos e desigualdade triangular). Para cada marco e cada
+// métrica (comprimento e tempo) guarda a distância do marco a todos os vértices e de todos os
+// vértices ao marco, de onde saem limites inferiores para o custo entre dois vértices quaisquer
+typedef void *Landmarks;
+
+// Escolhe até 'count' marcos entre os vértices de 'nodes' (indexado por GraphNode_GetIndex, com
+// 'size' posições; posições NULL são ignoradas), sempre o vértice mais distante dos já escolhidos,
+// e calcula as tabelas de distâncias. Retorna NULL se o grafo não tiver vértices
+Landmarks Landmarks_Create(GraphNode *nodes, int size, int count);
+
+int Landmarks_GetCount(Landmarks landmarks);
+
+// Limite inferior do custo de 'from' até 'to' pela métrica dada; infinito se 'to' não era
+// alcançável a partir de 'from' quando as tabelas foram calculadas. Bloqueios posteriores de
+// ruas (GraphNode_DestroyEdgesAffected) só aumentam custos, então o limite continua válido
+// (e consistente para o A*), apenas menos justo
+double Landmarks_LowerBound(Landmarks landmarks, GraphNode from, GraphNode to, bool byLength);
+
+void Landmarks_Destroy(Landmarks landmarks);
+
+#endif
@@ -0,0 +1,237 @@
+#include "path_tree.h"
+
+typedef struct path_tree_t {
+    GraphNode source;
+    bool quickest;
+    bool reverse;         // busca pelas arestas que chegam, a partir da raiz
+    double *distance;
+    GraphNode *parent;
+    char **streetName;
+    GraphNode *nodes;     // vértice de cada índice já alcançado
+    bool *closed;
+    IndexHeap heap;       // fronteira, mantida entre os pedidos
+
+    pthread_mutex_t lock;
+    int users;            // threads que obtiveram a árvore
+    bool evicted;         // já fora do cache, liberada pelo último usuário
+    struct path_tree_t *prev, *next;
+} *PathTreeImpl;
+
+// Origem consultada sem árvore
+typedef struct recent_source_t {
+    GraphNode source;
+    bool quickest;
+} RecentSource;
+
+typedef struct path_tree_cache_t {
+    int capacity, length;
+    PathTreeImpl first, last;  // da usada mais recentemente à usada há mais tempo
+    RecentSource *recent;      // fila circular com 'capacity' posições
+    int recentNext;
+    unsigned long version;
+    pthread_mutex_t lock;
+} *PathTreeCacheImpl;
+
+PathTree PathTree_Create(int size, GraphNode source, bool quickest, bool reverse) {
+    PathTreeImpl tree = malloc(sizeof(struct path_tree_t));
+    tree->source = source;
+    tree->quickest = quickest;
+    tree->reverse = reverse;
+    tree->distance = malloc(size * sizeof(double));
+    tree->parent = malloc(size * sizeof(GraphNode));
+    tree->streetName = malloc(size * sizeof(char *));
+    tree->nodes = malloc(size * sizeof(GraphNode));
+    tree->closed = malloc(size * sizeof(bool));
+    for (int i = 0; i < size; i++) {
+        tree->distance[i] = INFINITY;
+        tree->parent[i] = NULL;
+        tree->streetName[i] = NULL;
+        tree->closed[i] = false;
+    }
+    tree->heap = IndexHeap_Create(size);
+
+    int index = GraphNode_GetIndex(source);
+    tree->nodes[index] = source;
+    tree->distance[index] = 0;
+    IndexHeap_Push(tree->heap, index, 0);
+
+    pthread_mutex_init(&tree->lock, NULL);
+    tree->users = 0;
+    tree->evicted = false;
+    tree->prev = NULL;
+    tree->next = NULL;
+    return tree;
+}
+
+void PathTree_Destroy(PathTree treeVoid) {
+    PathTreeImpl tree = (PathTreeImpl) treeVoid;
+    free(tree->distance);
+    free(tree->parent);
+    free(tree->streetName);
+    free(tree->nodes);
+    free(tree->closed);
+    IndexHeap_Destroy(tree->heap);
+    pthread_mutex_destroy(&tree->lock);
+    free(tree);
+}
+
+bool PathTree_Reach(PathTree treeVoid, GraphNode target) {
+    PathTreeImpl tree = (PathTreeImpl) treeVoid;
+    int targetIndex = GraphNode_GetIndex(target);
+    while (!tree->closed[targetIndex] && !IndexHeap_IsEmpty(tree->heap)) {
+        double distance;
+        int index = IndexHeap_Extract(tree->heap, &distance);
+        tree->closed[index] = true;
+        STATS_VISIT();
+
+        GraphNode node = tree->nodes[index];
+        GraphEdge first = tree->reverse ? GraphNode_GetFirstInEdge(node) : GraphNode_GetFirstEdge(node);
+        for (GraphEdge edge = first; edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double newDistance = distance + GraphEdge_GetCost(edge, !tree->quickest);
+            GraphNode neighbor = tree->reverse ? GraphEdge_GetSource(edge) : GraphEdge_GetTarget(edge);
+            int neighborIndex = GraphNode_GetIndex(neighbor);
+            if (isfinite(newDistance) && newDistance < tree->distance[neighborIndex]) {
+                tree->distance[neighborIndex] = newDistance;
+                tree->parent[neighborIndex] = node;
+                tree->streetName[neighborIndex] = GraphEdge_GetName(edge);
+                tree->nodes[neighborIndex] = neighbor;
+                IndexHeap_Push(tree->heap, neighborIndex, newDistance);
+            }
+        }
+    }
+    return tree->closed[targetIndex];
+}
+
+double *PathTree_GetDistances(PathTree tree) {
+    return ((PathTreeImpl) tree)->distance;
+}
+
+GraphNode *PathTree_GetParents(PathTree tree) {
+    return ((PathTreeImpl) tree)->parent;
+}
+
+char **PathTree_GetStreetNames(PathTree tree) {
+    return ((PathTreeImpl) tree)->streetName;
+}
+
+PathTreeCache PathTreeCache_Create(int capacity) {
+    PathTreeCacheImpl cache = malloc(sizeof(struct path_tree_cache_t));
+    cache->capacity = capacity;
+    cache->length = 0;
+    cache->first = NULL;
+    cache->last = NULL;
+    cache->recent = calloc(capacity, sizeof(RecentSource));
+    cache->recentNext = 0;
+    cache->version = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+static void _unlink(PathTreeCacheImpl cache, PathTreeImpl tree) {
+    if (tree->prev != NULL)
+        tree->prev->next = tree->next;
+    else
+        cache->first = tree->next;
+    if (tree->next != NULL)
+        tree->next->prev = tree->prev;
+    else
+        cache->last = tree->prev;
+    tree->prev = NULL;
+    tree->next = NULL;
+}
+
+static void _pushFront(PathTreeCacheImpl cache, PathTreeImpl tree) {
+    tree->prev = NULL;
+    tree->next = cache->first;
+    if (cache->first != NULL)
+        cache->first->prev = tree;
+    else
+        cache->last = tree;
+    cache->first = tree;
+}
+
+// Tira a árvore do cache; se alguma thread ainda a usa, a liberação fica para PathTreeCache_Release
+static void _evict(PathTreeCacheImpl cache, PathTreeImpl tree) {
+    _unlink(cache, tree);
+    cache->length--;
+    tree->evicted = true;
+    if (tree->users == 0)
+        PathTree_Destroy(tree);
+}
+
+// Esvazia o cache quando o grafo muda (bloqueios de ruas alteram os custos)
+static void _checkVersion(PathTreeCacheImpl cache, unsigned long version) {
+    if (cache->version == version)
+        return;
+    while (cache->first != NULL)
+        _evict(cache, cache->first);
+    memset(cache->recent, 0, cache->capacity * sizeof(RecentSource));
+    cache->recentNext = 0;
+    cache->version = version;
+}
+
+// Retorna se a origem já foi consultada (e a tira da fila), ou a põe na fila
+static bool _wasRecent(PathTreeCacheImpl cache, GraphNode source, bool quickest) {
+    for (int i = 0; i < cache->capacity; i++) {
+        if (cache->recent[i].source == source && cache->recent[i].quickest == quickest) {
+            cache->recent[i].source = NULL;
+            return true;
+        }
+    }
+    cache->recent[cache->recentNext] = (RecentSource) {source, quickest};
+    cache->recentNext = (cache->recentNext + 1) % cache->capacity;
+    return false;
+}
+
+PathTree PathTreeCache_Acquire(PathTreeCache cacheVoid, int size, GraphNode source, bool quickest, unsigned long version) {
+    PathTreeCacheImpl cache = (PathTreeCacheImpl) cacheVoid;
+    if (cache->capacity <= 0)
+        return NULL;
+
+    pthread_mutex_lock(&cache->lock);
+    _checkVersion(cache, version);
+
+    PathTreeImpl tree = cache->first;
+    while (tree != NULL && (tree->source != source || tree->quickest != quickest))
+        tree = tree->next;
+
+    if (tree != NULL) {
+        _unlink(cache, tree);
+    } else if (_wasRecent(cache, source, quickest)) {
+        if (cache->length == cache->capacity)
+            _evict(cache, cache->last);
+        tree = PathTree_Create(size, source, quickest, false);
+        cache->length++;
+    } else {
+        pthread_mutex_unlock(&cache->lock);
+        return NULL;
+    }
+    _pushFront(cache, tree);
+    tree->users++;
+    pthread_mutex_unlock(&cache->lock);
+
+    // A busca continua na árvore, então só uma thread por vez a usa
+    pthread_mutex_lock(&tree->lock);
+    return tree;
+}
+
+void PathTreeCache_Release(PathTreeCache cacheVoid, PathTree treeVoid) {
+    PathTreeCacheImpl cache = (PathTreeCacheImpl) cacheVoid;
+    PathTreeImpl tree = (PathTreeImpl) treeVoid;
+    pthread_mutex_unlock(&tree->lock);
+
+    pthread_mutex_lock(&cache->lock);
+    tree->users--;
+    if (tree->evicted && tree->users == 0)
+        PathTree_Destroy(tree);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void PathTreeCache_Destroy(PathTreeCache cacheVoid) {
+    PathTreeCacheImpl cache = (PathTreeCacheImpl) cacheVoid;
+    while (cache->first != NULL)
+        _evict(cache, cache->first);
+    free(cache->recent);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
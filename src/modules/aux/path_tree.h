@@ -0,0 +1,51 @@
+#ifndef PATH_TREE_H
+#define PATH_TREE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "graph_node.h"
+#include "../data_structures/index_heap.h"
+#include "../util/stats.h"
+
+// Árvore de caminhos mínimos a partir de uma origem, por uma métrica (comprimento ou tempo). É
+// construída sob demanda: o Dijkstra para assim que o destino pedido é fechado e continua de onde
+// parou no próximo pedido, então destinos já fechados saem só de percorrer os pais. Uma árvore
+// reversa guarda os caminhos de todos os vértices até a raiz: o pai é o próximo vértice rumo a ela
+typedef void *PathTree;
+
+// Guarda as árvores mais recentes de cada (origem, métrica), descartando a usada há mais tempo.
+// Uma origem só ganha árvore na segunda consulta: a primeira é respondida pela busca ponto a ponto,
+// que fecha menos vértices. Árvores de versões anteriores do grafo são descartadas
+typedef void *PathTreeCache;
+
+// 'size' é a quantidade de índices de vértice
+PathTree PathTree_Create(int size, GraphNode root, bool quickest, bool reverse);
+
+// Fecha vértices até que 'target' seja fechado ou a busca se esgote. Retorna se ele é alcançável
+bool PathTree_Reach(PathTree tree, GraphNode target);
+
+// Vetores indexados por GraphNode_GetIndex, válidos enquanto a árvore estiver obtida
+double *PathTree_GetDistances(PathTree tree);
+
+GraphNode *PathTree_GetParents(PathTree tree);
+
+char **PathTree_GetStreetNames(PathTree tree);
+
+void PathTree_Destroy(PathTree tree);
+
+PathTreeCache PathTreeCache_Create(int capacity);
+
+// Árvore de 'source' pela métrica dada na versão 'version' do grafo, criada se preciso, para uso
+// exclusivo da thread até PathTreeCache_Release. Retorna NULL se a origem ainda não foi
+// consultada (ver acima)
+PathTree PathTreeCache_Acquire(PathTreeCache cache, int size, GraphNode source, bool quickest, unsigned long version);
+
+void PathTreeCache_Release(PathTreeCache cache, PathTree tree);
+
+void PathTreeCache_Destroy(PathTreeCache cache);
+
+#endif
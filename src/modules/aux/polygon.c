@@ -5,18 +5,38 @@ typedef struct segment_t {
     struct segment_t *next;
 } *PolySegment;
 
+// Número máximo de faixas horizontais do polígono preparado
+#define POLYGON_MAX_BANDS 4096
+
+// Polígono preparado para consultas: arestas em um vetor contíguo (na ordem do polígono),
+// caixa delimitadora completa e as arestas divididas em faixas horizontais. Cada aresta
+// aparece em todas as faixas que o seu intervalo fechado em y toca
+typedef struct prepared_t {
+    struct segment_t *edges;
+    int nEdges;
+    double minX, minY, maxX, maxY;
+    int nBands;
+    double bandHeight;
+    int *bandStart;
+    int *bandEdges;
+} *PreparedPolygon;
+
 typedef struct polygon_t {
     PolySegment first, last;
     bool pointInserted;
     double lastX, lastY;
     double minX, maxX;
+    PreparedPolygon prepared;
 } *PolygonImpl;
 
+static void _invalidatePrepared(PolygonImpl polygon);
+
 Polygon Polygon_Create() {
     PolygonImpl polygon = malloc(sizeof(struct polygon_t));
     polygon->first = NULL;
     polygon->last = NULL;
     polygon->pointInserted = false;
+    polygon->prepared = NULL;
     return polygon;
 }
 
@@ -33,10 +53,12 @@ void Polygon_Connect(Polygon polygonVoid) {
 
     polygon->last->next = seg;
     polygon->last = seg;
+    _invalidatePrepared(polygon);
 }
 
 void Polygon_InsertPoint(Polygon polygonVoid, double x, double y) {
     PolygonImpl polygon = (PolygonImpl) polygonVoid;
+    _invalidatePrepared(polygon);
     if (polygon->pointInserted) {
         // Não inserir ponto se for igual ao anterior
         if (polygon->lastX != x || polygon->lastY != y) {
@@ -68,6 +90,7 @@ void Polygon_InsertPoint(Polygon polygonVoid, double x, double y) {
 
 void Polygon_ReadFromFile(Polygon polygonVoid, FILE *file) {
     PolygonImpl polygon = (PolygonImpl) polygonVoid;
+    _invalidatePrepared(polygon);
 
     double x, y;
     fscanf(file, "%lf %lf", &polygon->lastX, &polygon->lastY);
@@ -125,14 +148,118 @@ void Polygon_Destroy(Polygon polygonVoid) {
         free(seg);
         seg = next;
     }
+    _invalidatePrepared(polygon);
     free(polygon);
 }
 
+static void _invalidatePrepared(PolygonImpl polygon) {
+    PreparedPolygon prepared = polygon->prepared;
+    if (prepared == NULL)
+        return;
+    free(prepared->edges);
+    free(prepared->bandStart);
+    free(prepared->bandEdges);
+    free(prepared);
+    polygon->prepared = NULL;
+}
+
+// Faixa que contém a coordenada y (limitada às faixas existentes)
+static int _bandOf(PreparedPolygon prepared, double y) {
+    if (prepared->bandHeight <= 0)
+        return 0;
+    double band = floor((y - prepared->minY) / prepared->bandHeight);
+    if (band < 0)
+        return 0;
+    if (band >= prepared->nBands)
+        return prepared->nBands - 1;
+    return (int) band;
+}
+
+void Polygon_Prepare(Polygon polygonVoid) {
+    PolygonImpl polygon = (PolygonImpl) polygonVoid;
+    if (polygon->prepared != NULL)
+        return;
+
+    PreparedPolygon prepared = malloc(sizeof(struct prepared_t));
+    prepared->nEdges = 0;
+    for (PolySegment seg = polygon->first; seg != NULL; seg = seg->next)
+        prepared->nEdges++;
+
+    int n = prepared->nEdges;
+    prepared->edges = malloc((n + 1) * sizeof(struct segment_t));
+    prepared->minX = prepared->minY = prepared->maxX = prepared->maxY = 0;
+    int i = 0;
+    for (PolySegment seg = polygon->first; seg != NULL; seg = seg->next, i++) {
+        prepared->edges[i] = *seg;
+        prepared->edges[i].next = NULL;
+        if (i == 0) {
+            prepared->minX = min(seg->x1, seg->x2);
+            prepared->maxX = max(seg->x1, seg->x2);
+            prepared->minY = min(seg->y1, seg->y2);
+            prepared->maxY = max(seg->y1, seg->y2);
+        } else {
+            prepared->minX = min(prepared->minX, min(seg->x1, seg->x2));
+            prepared->maxX = max(prepared->maxX, max(seg->x1, seg->x2));
+            prepared->minY = min(prepared->minY, min(seg->y1, seg->y2));
+            prepared->maxY = max(prepared->maxY, max(seg->y1, seg->y2));
+        }
+    }
+
+    // Aproximadamente uma faixa por aresta
+    prepared->nBands = n < 1 ? 1 : n > POLYGON_MAX_BANDS ? POLYGON_MAX_BANDS : n;
+    prepared->bandHeight = (prepared->maxY - prepared->minY) / prepared->nBands;
+    if (prepared->bandHeight <= 0)
+        prepared->nBands = 1;
+
+    // Contar as arestas de cada faixa e depois preenchê-las (vetor único, indexado por bandStart)
+    int nBands = prepared->nBands;
+    prepared->bandStart = calloc(nBands + 1, sizeof(int));
+    for (i = 0; i < n; i++) {
+        PolySegment e = &prepared->edges[i];
+        int first = _bandOf(prepared, min(e->y1, e->y2));
+        int last = _bandOf(prepared, max(e->y1, e->y2));
+        for (int b = first; b <= last; b++)
+            prepared->bandStart[b + 1]++;
+    }
+    for (int b = 0; b < nBands; b++)
+        prepared->bandStart[b + 1] += prepared->bandStart[b];
+
+    prepared->bandEdges = malloc((prepared->bandStart[nBands] + 1) * sizeof(int));
+    int *fill = malloc(nBands * sizeof(int));
+    for (int b = 0; b < nBands; b++)
+        fill[b] = prepared->bandStart[b];
+    for (i = 0; i < n; i++) {
+        PolySegment e = &prepared->edges[i];
+        int first = _bandOf(prepared, min(e->y1, e->y2));
+        int last = _bandOf(prepared, max(e->y1, e->y2));
+        for (int b = first; b <= last; b++)
+            prepared->bandEdges[fill[b]++] = i;
+    }
+    free(fill);
+
+    polygon->prepared = prepared;
+}
+
+static PreparedPolygon _getPrepared(PolygonImpl polygon) {
+    if (polygon->prepared == NULL)
+        Polygon_Prepare(polygon);
+    return polygon->prepared;
+}
+
 int _calculateIntersections(PolygonImpl polygon, double x, double y) {
+    PreparedPolygon prepared = _getPrepared(polygon);
+
+    // Fora da faixa em y ou à esquerda do polígono: a semirreta não cruza nenhuma aresta
+    if (prepared->nEdges == 0 || y < prepared->minY || y > prepared->maxY || x < prepared->minX)
+        return 0;
 
     int intersections = 0;
-    
-    for (PolySegment seg = polygon->first; seg != NULL; seg = seg->next) {
+
+    // Apenas as arestas da faixa do ponto podem ser cruzadas
+    int band = _bandOf(prepared, y);
+    for (int k = prepared->bandStart[band]; k < prepared->bandStart[band + 1]; k++) {
+        int i = prepared->bandEdges[k];
+        PolySegment seg = &prepared->edges[i];
         // Segmento do polígono é horizontal e o ponto cruza com ele
         if (seg->y1 == seg->y2 && seg->y1 == y) {
             // Não contar intersecção
@@ -143,9 +270,7 @@ int _calculateIntersections(PolygonImpl polygon, double x, double y) {
             if (x < seg->x1)
                 continue;
             // Selecionar próximo segmento
-            PolySegment next = seg->next;
-            if (next == NULL)
-                next = polygon->first;
+            PolySegment next = &prepared->edges[(i + 1) % prepared->nEdges];
             // Verificar se o próximo segmento está na mesma direção que o atual
             // (não é um ápice)
             if ((seg->y2 - seg->y1) * (next->y2 - next->y1) > 0) {
@@ -206,12 +331,25 @@ bool _segmentTouchesOrCrossesLine(PolySegment a, PolySegment b) {
 }
 
 bool _checkIntersection(PolygonImpl polygon, double x1, double y1, double x2, double y2) {
+    PreparedPolygon prepared = _getPrepared(polygon);
     struct segment_t testingSeg = {x1, y1, x2, y2};
-    for (PolySegment seg = polygon->first; seg != NULL; seg = seg->next) {
-        if (_checkBoundingBoxIntersection(&testingSeg, seg)
-                && _segmentTouchesOrCrossesLine(&testingSeg, seg)
-                && _segmentTouchesOrCrossesLine(seg, &testingSeg))
-            return true;
+
+    // Caixa delimitadora do segmento não toca a do polígono
+    if (prepared->nEdges == 0 || min(x1, x2) >= prepared->maxX || max(x1, x2) <= prepared->minX
+            || min(y1, y2) >= prepared->maxY || max(y1, y2) <= prepared->minY)
+        return false;
+
+    // Testar apenas as arestas das faixas que o segmento atravessa
+    int first = _bandOf(prepared, min(y1, y2));
+    int last = _bandOf(prepared, max(y1, y2));
+    for (int band = first; band <= last; band++) {
+        for (int k = prepared->bandStart[band]; k < prepared->bandStart[band + 1]; k++) {
+            PolySegment seg = &prepared->edges[prepared->bandEdges[k]];
+            if (_checkBoundingBoxIntersection(&testingSeg, seg)
+                    && _segmentTouchesOrCrossesLine(&testingSeg, seg)
+                    && _segmentTouchesOrCrossesLine(seg, &testingSeg))
+                return true;
+        }
     }
     return false;
 }
@@ -282,6 +420,14 @@ double Polygon_GetMaxX(Polygon polygon) {
     return ((PolygonImpl) polygon)->maxX;
 }
 
+double Polygon_GetMinY(Polygon polygon) {
+    return _getPrepared((PolygonImpl) polygon)->minY;
+}
+
+double Polygon_GetMaxY(Polygon polygon) {
+    return _getPrepared((PolygonImpl) polygon)->maxY;
+}
+
 bool Polygon_IsBlockInside(Polygon polygonVoid, Block block, bool partially) {
     PolygonImpl polygon = (PolygonImpl) polygonVoid;
     return _isRectInside(polygon, Block_GetX(block), Block_GetY(block), 
@@ -27,6 +27,10 @@ double Polygon_CalculateArea(Polygon polygon);
 
 void Polygon_Destroy(Polygon polygon);
 
+// Prepara o polígono para consultas (feito automaticamente na primeira consulta e
+// descartado quando o polígono é alterado)
+void Polygon_Prepare(Polygon polygon);
+
 bool Polygon_IsPointInside(Polygon polygon, double x, double y);
 
 bool Polygon_IsBlockInside(Polygon polygon, Block block, bool partially);
@@ -37,6 +41,10 @@ double Polygon_GetMinX(Polygon polygon);
 
 double Polygon_GetMaxX(Polygon polygon);
 
+double Polygon_GetMinY(Polygon polygon);
+
+double Polygon_GetMaxY(Polygon polygon);
+
 bool Polygon_DoesSegmentIntersect(Polygon polygon, double x1, double y1, double x2, double y2);
 
 void *Polygon_GetFirstSeg(Polygon polygon);
@@ -0,0 +1,387 @@
+#include "route_partition.h"
+
+// Níveis no máximo; cada nível agrupa cerca de FANOUT células do nível de baixo
+#define MAX_LEVELS 4
+#define FANOUT 8
+
+typedef struct cell_t {
+    int *boundary;        // índices dos vértices de borda
+    int count;
+    double *matrix[2];    // custo [i * count + j] da borda i à borda j, por comprimento e por tempo
+    bool changed;
+} Cell;
+
+typedef struct route_partition_t {
+    int size, levels;
+    GraphNode *nodes;
+    int capacity[MAX_LEVELS];   // vértices por célula, no máximo
+    int *cell[MAX_LEVELS];      // célula de cada vértice (-1 em índices sem vértice)
+    int *local[MAX_LEVELS];     // posição do vértice na borda da sua célula, ou -1
+    Cell *cells[MAX_LEVELS];
+    int cellCount[MAX_LEVELS];
+
+    // Estado da customização
+    double *distance;
+    int *touched;
+    IndexHeap heap;
+} *RoutePartitionImpl;
+
+typedef struct keyed_t {
+    double key;
+    int index;
+} Keyed;
+
+static int _compareKeyed(const void *a, const void *b) {
+    const Keyed *ka = a, *kb = b;
+    if (ka->key != kb->key)
+        return ka->key < kb->key ? -1 : 1;
+    return ka->index - kb->index;
+}
+
+// Dá células aos vértices de 'items' nos níveis até 'top' em que eles cabem numa só; no resto,
+// divide-os ao meio pela coordenada de maior extensão
+static void _split(RoutePartitionImpl p, Keyed *items, int n, int top) {
+    while (top >= 0 && n <= p->capacity[top]) {
+        int id = p->cellCount[top]++;
+        for (int i = 0; i < n; i++)
+            p->cell[top][items[i].index] = id;
+        top--;
+    }
+    if (top < 0)
+        return;
+
+    double minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    for (int i = 0; i < n; i++) {
+        GraphNode node = p->nodes[items[i].index];
+        minX = fmin(minX, GraphNode_GetX(node));
+        maxX = fmax(maxX, GraphNode_GetX(node));
+        minY = fmin(minY, GraphNode_GetY(node));
+        maxY = fmax(maxY, GraphNode_GetY(node));
+    }
+    bool byX = maxX - minX >= maxY - minY;
+    for (int i = 0; i < n; i++) {
+        GraphNode node = p->nodes[items[i].index];
+        items[i].key = byX ? GraphNode_GetX(node) : GraphNode_GetY(node);
+    }
+    qsort(items, n, sizeof(Keyed), _compareKeyed);
+    _split(p, items, n / 2, top);
+    _split(p, items + n / 2, n - n / 2, top);
+}
+
+// Se o vértice tem aresta (de saída ou de chegada, bloqueada ou não) para outra célula do nível
+static bool _isBoundary(RoutePartitionImpl p, int level, int index) {
+    GraphNode node = p->nodes[index];
+    for (GraphEdge edge = GraphNode_GetFirstEdge(node); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+        if (p->cell[level][GraphNode_GetIndex(GraphEdge_GetTarget(edge))] != p->cell[level][index])
+            return true;
+    }
+    for (GraphEdge edge = GraphNode_GetFirstInEdge(node); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+        if (p->cell[level][GraphNode_GetIndex(GraphEdge_GetSource(edge))] != p->cell[level][index])
+            return true;
+    }
+    return false;
+}
+
+static void _findBoundaries(RoutePartitionImpl p, int level) {
+    p->cells[level] = calloc(p->cellCount[level], sizeof(Cell));
+    p->local[level] = malloc(p->size * sizeof(int));
+    for (int i = 0; i < p->size; i++) {
+        p->local[level][i] = -1;
+        if (p->nodes[i] != NULL && _isBoundary(p, level, i))
+            p->local[level][i] = p->cells[level][p->cell[level][i]].count++;
+    }
+    for (int c = 0; c < p->cellCount[level]; c++) {
+        Cell *cell = &p->cells[level][c];
+        cell->boundary = malloc(cell->count * sizeof(int));
+        for (int m = 0; m < 2; m++)
+            cell->matrix[m] = malloc((size_t) cell->count * cell->count * sizeof(double));
+        cell->changed = true;
+    }
+    for (int i = 0; i < p->size; i++) {
+        if (p->local[level][i] >= 0)
+            p->cells[level][p->cell[level][i]].boundary[p->local[level][i]] = i;
+    }
+}
+
+static void _relaxInCell(RoutePartitionImpl p, int index, double distance, int *touchedCount) {
+    if (!isfinite(distance) || distance >= p->distance[index])
+        return;
+    if (p->distance[index] == INFINITY)
+        p->touched[(*touchedCount)++] = index;
+    p->distance[index] = distance;
+    IndexHeap_Push(p->heap, index, distance);
+}
+
+// Dijkstra a partir de 'source' sem sair da célula 'id' do nível. No nível 0 pelas arestas; acima,
+// pelas matrizes das células do nível de baixo e pelas arestas entre elas. Retorna quantos
+// vértices foram alcançados (em 'touched')
+static int _cellDijkstra(RoutePartitionImpl p, int level, int id, int source, bool byLength) {
+    int touchedCount = 0;
+    _relaxInCell(p, source, 0, &touchedCount);
+    while (!IndexHeap_IsEmpty(p->heap)) {
+        double distance;
+        int index = IndexHeap_Extract(p->heap, &distance);
+        STATS_VISIT();
+        if (level > 0) {
+            Cell *sub = &p->cells[level - 1][p->cell[level - 1][index]];
+            double *row = sub->matrix[byLength ? 0 : 1] + (size_t) p->local[level - 1][index] * sub->count;
+            for (int j = 0; j < sub->count; j++)
+                _relaxInCell(p, sub->boundary[j], distance + row[j], &touchedCount);
+        }
+        for (GraphEdge edge = GraphNode_GetFirstEdge(p->nodes[index]); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            int neighbor = GraphNode_GetIndex(GraphEdge_GetTarget(edge));
+            if (p->cell[level][neighbor] != id)
+                continue;
+            // Dentro da mesma célula do nível de baixo, o caminho já está na matriz
+            if (level > 0 && p->cell[level - 1][neighbor] == p->cell[level - 1][index])
+                continue;
+            _relaxInCell(p, neighbor, distance + GraphEdge_GetCost(edge, byLength), &touchedCount);
+        }
+    }
+    return touchedCount;
+}
+
+static void _customizeCell(RoutePartitionImpl p, int level, int id) {
+    Cell *cell = &p->cells[level][id];
+    for (int m = 0; m < 2; m++) {
+        for (int i = 0; i < cell->count; i++) {
+            int touchedCount = _cellDijkstra(p, level, id, cell->boundary[i], m == 0);
+            double *row = cell->matrix[m] + (size_t) i * cell->count;
+            for (int j = 0; j < cell->count; j++)
+                row[j] = p->distance[cell->boundary[j]];
+            for (int k = 0; k < touchedCount; k++)
+                p->distance[p->touched[k]] = INFINITY;
+        }
+    }
+    cell->changed = false;
+}
+
+RoutePartition RoutePartition_Create(GraphNode *nodes, int size, int cellSize) {
+    int count = 0;
+    for (int i = 0; i < size; i++) {
+        if (nodes[i] != NULL)
+            count++;
+    }
+    if (count == 0)
+        return NULL;
+
+    RoutePartitionImpl p = malloc(sizeof(struct route_partition_t));
+    p->size = size;
+    p->nodes = malloc(size * sizeof(GraphNode));
+    for (int i = 0; i < size; i++)
+        p->nodes[i] = nodes[i];
+
+    // Um nível a mais enquanto o de cima ainda tiver várias células
+    p->capacity[0] = cellSize > 1 ? cellSize : 2;
+    p->levels = 1;
+    while (p->levels < MAX_LEVELS && (long) p->capacity[p->levels - 1] * FANOUT < count) {
+        p->capacity[p->levels] = p->capacity[p->levels - 1] * FANOUT;
+        p->levels++;
+    }
+
+    Keyed *items = malloc(count * sizeof(Keyed));
+    count = 0;
+    for (int i = 0; i < size; i++) {
+        if (nodes[i] != NULL)
+            items[count++] = (Keyed) {0, i};
+    }
+    for (int l = 0; l < p->levels; l++) {
+        p->cell[l] = malloc(size * sizeof(int));
+        for (int i = 0; i < size; i++)
+            p->cell[l][i] = -1;
+        p->cellCount[l] = 0;
+    }
+    _split(p, items, count, p->levels - 1);
+    free(items);
+    for (int l = 0; l < p->levels; l++)
+        _findBoundaries(p, l);
+
+    p->distance = malloc(size * sizeof(double));
+    for (int i = 0; i < size; i++)
+        p->distance[i] = INFINITY;
+    p->touched = malloc(size * sizeof(int));
+    p->heap = IndexHeap_Create(size);
+    RoutePartition_Customize(p);
+    return p;
+}
+
+int RoutePartition_GetLevels(RoutePartition partition) {
+    return ((RoutePartitionImpl) partition)->levels;
+}
+
+void RoutePartition_MarkChanged(RoutePartition partition, GraphNode node) {
+    RoutePartitionImpl p = (RoutePartitionImpl) partition;
+    int index = GraphNode_GetIndex(node);
+    for (int l = 0; l < p->levels; l++)
+        p->cells[l][p->cell[l][index]].changed = true;
+}
+
+int RoutePartition_Customize(RoutePartition partition) {
+    RoutePartitionImpl p = (RoutePartitionImpl) partition;
+    int customized = 0;
+    for (int l = 0; l < p->levels; l++) {
+        for (int c = 0; c < p->cellCount[l]; c++) {
+            if (p->cells[l][c].changed) {
+                _customizeCell(p, l, c);
+                customized++;
+            }
+        }
+    }
+    return customized;
+}
+
+// Nível mais alto em que a célula de 'index' não é a de 's' nem a de 't' (0 se não houver)
+static int _queryLevel(RoutePartitionImpl p, int index, int s, int t) {
+    int level = p->levels;
+    while (level > 0 && (p->cell[level - 1][index] == p->cell[level - 1][s]
+                         || p->cell[level - 1][index] == p->cell[level - 1][t]))
+        level--;
+    return level;
+}
+
+// Troca os atalhos do caminho de 'end' a 'start' pelas arestas: cada um é refeito por um Dijkstra
+// dentro da sua célula, de onde o custo dele saiu
+static void _unpack(RoutePartitionImpl p, GraphNode start, GraphNode end, bool byLength, GraphNode parent[],
+                    char *streetName[], unsigned char *hop) {
+    int length = 0;
+    for (GraphNode node = end; node != start; node = parent[GraphNode_GetIndex(node)])
+        length++;
+    GraphNode *path = malloc((length + 1) * sizeof(GraphNode));
+    path[0] = end;
+    for (int k = 0; k < length; k++)
+        path[k + 1] = parent[GraphNode_GetIndex(path[k])];
+
+    double *distance = malloc(p->size * sizeof(double));
+    GraphNode *cellParent = malloc(p->size * sizeof(GraphNode));
+    char **cellName = malloc(p->size * sizeof(char *));
+    int *touched = malloc(p->size * sizeof(int));
+    for (int i = 0; i < p->size; i++)
+        distance[i] = INFINITY;
+    IndexHeap heap = IndexHeap_Create(p->size);
+
+    for (int k = 0; k < length; k++) {
+        int to = GraphNode_GetIndex(path[k]), from = GraphNode_GetIndex(path[k + 1]);
+        if (hop[to] == 0)
+            continue;
+        int level = hop[to] - 1, id = p->cell[level][from];
+
+        int touchedCount = 0;
+        distance[from] = 0;
+        touched[touchedCount++] = from;
+        IndexHeap_Push(heap, from, 0);
+        while (!IndexHeap_IsEmpty(heap)) {
+            double current;
+            int index = IndexHeap_Extract(heap, &current);
+            STATS_VISIT();
+            if (index == to)
+                break;
+            for (GraphEdge edge = GraphNode_GetFirstEdge(p->nodes[index]); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+                int neighbor = GraphNode_GetIndex(GraphEdge_GetTarget(edge));
+                double newDistance = current + GraphEdge_GetCost(edge, byLength);
+                if (p->cell[level][neighbor] != id || !isfinite(newDistance) || newDistance >= distance[neighbor])
+                    continue;
+                if (distance[neighbor] == INFINITY)
+                    touched[touchedCount++] = neighbor;
+                distance[neighbor] = newDistance;
+                cellParent[neighbor] = p->nodes[index];
+                cellName[neighbor] = GraphEdge_GetName(edge);
+                IndexHeap_Push(heap, neighbor, newDistance);
+            }
+        }
+        while (!IndexHeap_IsEmpty(heap))
+            IndexHeap_Extract(heap, NULL);
+
+        for (int index = to; index != from; index = GraphNode_GetIndex(cellParent[index])) {
+            parent[index] = cellParent[index];
+            streetName[index] = cellName[index];
+        }
+        for (int i = 0; i < touchedCount; i++)
+            distance[touched[i]] = INFINITY;
+    }
+
+    IndexHeap_Destroy(heap);
+    free(touched);
+    free(cellName);
+    free(cellParent);
+    free(distance);
+    free(path);
+}
+
+bool RoutePartition_Route(RoutePartition partition, GraphNode start, GraphNode end, bool quickest,
+                          double distance[], GraphNode parent[], char *streetName[]) {
+    RoutePartitionImpl p = (RoutePartitionImpl) partition;
+    int s = GraphNode_GetIndex(start), t = GraphNode_GetIndex(end);
+    // Nível do atalho que levou a cada vértice (0: aresta)
+    unsigned char *hop = calloc(p->size, sizeof(unsigned char));
+    IndexHeap heap = IndexHeap_Create(p->size);
+    distance[s] = 0;
+    IndexHeap_Push(heap, s, 0);
+
+    bool found = false;
+    while (!IndexHeap_IsEmpty(heap)) {
+        double current;
+        int index = IndexHeap_Extract(heap, &current);
+        STATS_VISIT();
+        if (index == t) {
+            found = true;
+            break;
+        }
+
+        GraphNode node = p->nodes[index];
+        int level = _queryLevel(p, index, s, t);
+        if (level > 0) {
+            Cell *cell = &p->cells[level - 1][p->cell[level - 1][index]];
+            double *row = cell->matrix[quickest ? 1 : 0] + (size_t) p->local[level - 1][index] * cell->count;
+            for (int j = 0; j < cell->count; j++) {
+                int neighbor = cell->boundary[j];
+                double newDistance = current + row[j];
+                if (isfinite(newDistance) && newDistance < distance[neighbor]) {
+                    distance[neighbor] = newDistance;
+                    parent[neighbor] = node;
+                    streetName[neighbor] = NULL;
+                    hop[neighbor] = level;
+                    IndexHeap_Push(heap, neighbor, newDistance);
+                }
+            }
+        }
+        for (GraphEdge edge = GraphNode_GetFirstEdge(node); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            int neighbor = GraphNode_GetIndex(GraphEdge_GetTarget(edge));
+            // Arestas dentro da célula já estão nos atalhos
+            if (level > 0 && p->cell[level - 1][neighbor] == p->cell[level - 1][index])
+                continue;
+            double newDistance = current + GraphEdge_GetCost(edge, !quickest);
+            if (isfinite(newDistance) && newDistance < distance[neighbor]) {
+                distance[neighbor] = newDistance;
+                parent[neighbor] = node;
+                streetName[neighbor] = GraphEdge_GetName(edge);
+                hop[neighbor] = 0;
+                IndexHeap_Push(heap, neighbor, newDistance);
+            }
+        }
+    }
+
+    if (found)
+        _unpack(p, start, end, !quickest, parent, streetName, hop);
+    IndexHeap_Destroy(heap);
+    free(hop);
+    return found;
+}
+
+void RoutePartition_Destroy(RoutePartition partition) {
+    RoutePartitionImpl p = (RoutePartitionImpl) partition;
+    for (int l = 0; l < p->levels; l++) {
+        for (int c = 0; c < p->cellCount[l]; c++) {
+            free(p->cells[l][c].boundary);
+            free(p->cells[l][c].matrix[0]);
+            free(p->cells[l][c].matrix[1]);
+        }
+        free(p->cells[l]);
+        free(p->cell[l]);
+        free(p->local[l]);
+    }
+    IndexHeap_Destroy(p->heap);
+    free(p->touched);
+    free(p->distance);
+    free(p->nodes);
+    free(p);
+}
@@ -0,0 +1,45 @@
+#ifndef ROUTE_PARTITION_H
+#define ROUTE_PARTITION_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "graph_node.h"
+#include "../data_structures/index_heap.h"
+#include "../util/stats.h"
+
+// Índice de rotas por partição em níveis (CRP). Os vértices são divididos pela posição, por
+// bissecções sucessivas, em células de até 'cellSize' vértices, agrupadas em células maiores nos
+// níveis de cima; a partição não depende dos custos. Para cada célula e métrica, uma matriz guarda
+// o custo mínimo, sem sair da célula, entre cada par de vértices de borda (com aresta para outra
+// célula do nível). A busca entre dois vértices usa as arestas só nas células deles e, longe
+// deles, as matrizes do nível mais alto possível. Bloqueios de ruas só exigem recalcular as
+// matrizes das células que contêm as arestas bloqueadas
+typedef void *RoutePartition;
+
+// Particiona os vértices de 'nodes' (indexado por GraphNode_GetIndex, com 'size' posições;
+// posições NULL são ignoradas) e calcula as matrizes de todas as células. Retorna NULL se o grafo
+// não tiver vértices
+RoutePartition RoutePartition_Create(GraphNode *nodes, int size, int cellSize);
+
+int RoutePartition_GetLevels(RoutePartition partition);
+
+// Marca as células de 'node', em todos os níveis, para serem recalculadas (arestas que saem dele
+// mudaram de custo)
+void RoutePartition_MarkChanged(RoutePartition partition, GraphNode node);
+
+// Recalcula as matrizes das células marcadas, de baixo para cima. Retorna quantas foram
+// recalculadas. Não pode rodar junto com RoutePartition_Route
+int RoutePartition_Customize(RoutePartition partition);
+
+// Caminho mínimo de 'start' a 'end' pela métrica dada. Os vetores, indexados por
+// GraphNode_GetIndex e iniciados com infinito e NULL, recebem como numa busca de Dijkstra o custo
+// dos vértices alcançados e, nos vértices do caminho, o anterior e o nome da rua até ele. Retorna
+// se 'end' é alcançável
+bool RoutePartition_Route(RoutePartition partition, GraphNode start, GraphNode end, bool quickest,
+                          double distance[], GraphNode parent[], char *streetName[]);
+
+void RoutePartition_Destroy(RoutePartition partition);
+
+#endif
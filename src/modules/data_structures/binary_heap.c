@@ -12,6 +12,7 @@ BinaryHeap BinHeap_Create(int size, int (*compare)(const void *a, const void *b)
     heap->nodes[0] = NULL;
     heap->compare = compare;
     heap->length = 0;
+    return heap;
 }
 
 BinaryHeap BinHeap_Insert(BinaryHeap heapVoid, Value element) {
@@ -31,6 +32,7 @@ BinaryHeap BinHeap_Insert(BinaryHeap heapVoid, Value element) {
     }
 
     heap->length++;
+    return heap;
 }
 
 static int _pickChild(BinHeapImpl heap, int i) {
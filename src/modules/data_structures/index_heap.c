@@ -0,0 +1,106 @@
+#include "index_heap.h"
+
+typedef struct index_heap_t {
+    int *items;      // índices, na ordem do heap
+    double *keys;    // chave de cada posição do heap
+    int *positions;  // posição de cada índice no heap, -1 se ausente
+    int length;
+    int capacity;
+} *IndexHeapImpl;
+
+IndexHeap IndexHeap_Create(int capacity) {
+    IndexHeapImpl heap = malloc(sizeof(struct index_heap_t));
+    heap->items = malloc(capacity * sizeof(int));
+    heap->keys = malloc(capacity * sizeof(double));
+    heap->positions = malloc(capacity * sizeof(int));
+    for (int i = 0; i < capacity; i++)
+        heap->positions[i] = -1;
+    heap->length = 0;
+    heap->capacity = capacity;
+    return heap;
+}
+
+static void _place(IndexHeapImpl heap, int pos, int index, double key) {
+    heap->items[pos] = index;
+    heap->keys[pos] = key;
+    heap->positions[index] = pos;
+}
+
+static void _siftUp(IndexHeapImpl heap, int pos) {
+    int index = heap->items[pos];
+    double key = heap->keys[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap->keys[parent] <= key)
+            break;
+        _place(heap, pos, heap->items[parent], heap->keys[parent]);
+        pos = parent;
+    }
+    _place(heap, pos, index, key);
+}
+
+static void _siftDown(IndexHeapImpl heap, int pos) {
+    int index = heap->items[pos];
+    double key = heap->keys[pos];
+    while (pos * 2 + 1 < heap->length) {
+        int child = pos * 2 + 1;
+        if (child + 1 < heap->length && heap->keys[child + 1] < heap->keys[child])
+            child++;
+        if (key <= heap->keys[child])
+            break;
+        _place(heap, pos, heap->items[child], heap->keys[child]);
+        pos = child;
+    }
+    _place(heap, pos, index, key);
+}
+
+void IndexHeap_Push(IndexHeap heapVoid, int index, double key) {
+    IndexHeapImpl heap = (IndexHeapImpl) heapVoid;
+    int pos = heap->positions[index];
+    if (pos == -1) {
+        pos = heap->length++;
+    } else if (key >= heap->keys[pos]) {
+        return;
+    }
+    _place(heap, pos, index, key);
+    _siftUp(heap, pos);
+}
+
+int IndexHeap_Extract(IndexHeap heapVoid, double *key) {
+    IndexHeapImpl heap = (IndexHeapImpl) heapVoid;
+    if (heap->length == 0)
+        return -1;
+
+    int index = heap->items[0];
+    if (key != NULL)
+        *key = heap->keys[0];
+    heap->positions[index] = -1;
+
+    heap->length--;
+    if (heap->length > 0) {
+        _place(heap, 0, heap->items[heap->length], heap->keys[heap->length]);
+        _siftDown(heap, 0);
+    }
+    return index;
+}
+
+double IndexHeap_PeekKey(IndexHeap heapVoid) {
+    IndexHeapImpl heap = (IndexHeapImpl) heapVoid;
+    return heap->length == 0 ? INFINITY : heap->keys[0];
+}
+
+bool IndexHeap_Contains(IndexHeap heap, int index) {
+    return ((IndexHeapImpl) heap)->positions[index] != -1;
+}
+
+bool IndexHeap_IsEmpty(IndexHeap heap) {
+    return ((IndexHeapImpl) heap)->length == 0;
+}
+
+void IndexHeap_Destroy(IndexHeap heapVoid) {
+    IndexHeapImpl heap = (IndexHeapImpl) heapVoid;
+    free(heap->items);
+    free(heap->keys);
+    free(heap->positions);
+    free(heap);
+}
@@ -0,0 +1,30 @@
+#ifndef INDEXHEAP_H
+#define INDEXHEAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Heap mínimo de índices inteiros em [0, capacidade), ordenado por chaves reais, com diminuição
+// de chave. Cada índice aparece no máximo uma vez
+typedef void *IndexHeap;
+
+IndexHeap IndexHeap_Create(int capacity);
+
+// Insere o índice com a chave dada ou, se ele já estiver no heap, diminui sua chave
+void IndexHeap_Push(IndexHeap heap, int index, double key);
+
+// Remove e retorna o índice de menor chave, escrevendo a chave em 'key' (se não for NULL).
+// Retorna -1 se o heap estiver vazio
+int IndexHeap_Extract(IndexHeap heap, double *key);
+
+// Menor chave do heap, sem removê-la (infinito se estiver vazio)
+double IndexHeap_PeekKey(IndexHeap heap);
+
+bool IndexHeap_Contains(IndexHeap heap, int index);
+
+bool IndexHeap_IsEmpty(IndexHeap heap);
+
+void IndexHeap_Destroy(IndexHeap heap);
+
+#endif
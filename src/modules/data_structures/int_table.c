@@ -0,0 +1,127 @@
+#include "int_table.h"
+
+typedef struct int_table_t {
+    uint64_t *keys;  // 0 marca posição vazia
+    void **values;
+    int capacity;    // sempre potência de 2
+    int length;
+} *IntTableImpl;
+
+static void _allocate(IntTableImpl table, int capacity) {
+    table->keys = calloc(capacity, sizeof(uint64_t));
+    table->values = malloc(capacity * sizeof(void *));
+    table->capacity = capacity;
+}
+
+IntTable IntTable_Create(int capacity) {
+    IntTableImpl table = malloc(sizeof(struct int_table_t));
+    int realCapacity = 16;
+    while (realCapacity < capacity * 2)
+        realCapacity *= 2;
+    _allocate(table, realCapacity);
+    table->length = 0;
+    return table;
+}
+
+static int _home(IntTableImpl table, uint64_t key) {
+    // Espalhamento de Fibonacci: os bits altos do produto são bem distribuídos
+    return (int) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & (table->capacity - 1);
+}
+
+// Posição da chave, ou da vaga onde ela deveria estar
+static int _findSlot(IntTableImpl table, uint64_t key) {
+    int i = _home(table, key);
+    while (table->keys[i] != 0 && table->keys[i] != key)
+        i = (i + 1) & (table->capacity - 1);
+    return i;
+}
+
+static void _grow(IntTableImpl table) {
+    uint64_t *oldKeys = table->keys;
+    void **oldValues = table->values;
+    int oldCapacity = table->capacity;
+
+    _allocate(table, oldCapacity * 2);
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i] != 0) {
+            int slot = _findSlot(table, oldKeys[i]);
+            table->keys[slot] = oldKeys[i];
+            table->values[slot] = oldValues[i];
+        }
+    }
+    free(oldKeys);
+    free(oldValues);
+}
+
+void *IntTable_Insert(IntTable tableVoid, uint64_t key, void *value) {
+    IntTableImpl table = (IntTableImpl) tableVoid;
+    if (key == 0)
+        return NULL;
+    if ((table->length + 1) * 2 > table->capacity)
+        _grow(table);
+
+    int i = _findSlot(table, key);
+    void *replaced = NULL;
+    if (table->keys[i] == key) {
+        replaced = table->values[i];
+    } else {
+        table->keys[i] = key;
+        table->length++;
+    }
+    table->values[i] = value;
+    return replaced;
+}
+
+void *IntTable_Find(IntTable tableVoid, uint64_t key) {
+    IntTableImpl table = (IntTableImpl) tableVoid;
+    if (key == 0)
+        return NULL;
+    int i = _findSlot(table, key);
+    return table->keys[i] == key ? table->values[i] : NULL;
+}
+
+void *IntTable_Remove(IntTable tableVoid, uint64_t key) {
+    IntTableImpl table = (IntTableImpl) tableVoid;
+    if (key == 0)
+        return NULL;
+    int i = _findSlot(table, key);
+    if (table->keys[i] != key)
+        return NULL;
+    void *removed = table->values[i];
+
+    // Puxa para trás os elementos seguintes da sequência que ficariam inalcançáveis
+    int mask = table->capacity - 1;
+    int j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (table->keys[j] == 0)
+            break;
+        int home = _home(table, table->keys[j]);
+        // Só move se a posição original de j não estiver no intervalo circular (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            table->keys[i] = table->keys[j];
+            table->values[i] = table->values[j];
+            i = j;
+        }
+    }
+    table->keys[i] = 0;
+    table->length--;
+    return removed;
+}
+
+int IntTable_GetLength(IntTable table) {
+    return ((IntTableImpl) table)->length;
+}
+
+void IntTable_Destroy(IntTable tableVoid, void (*destroy)(void *)) {
+    IntTableImpl table = (IntTableImpl) tableVoid;
+    if (destroy != NULL) {
+        for (int i = 0; i < table->capacity; i++) {
+            if (table->keys[i] != 0)
+                destroy(table->values[i]);
+        }
+    }
+    free(table->keys);
+    free(table->values);
+    free(table);
+}
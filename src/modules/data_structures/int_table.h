@@ -0,0 +1,29 @@
+#ifndef INTTABLE_H
+#define INTTABLE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tabela de espalhamento com chaves inteiras de 64 bits (endereçamento aberto, sondagem linear).
+// A chave 0 é reservada e não pode ser inserida
+typedef void *IntTable;
+
+// Cria a tabela com espaço inicial para 'capacity' elementos (ela cresce quando necessário)
+IntTable IntTable_Create(int capacity);
+
+// Insere um par chave-valor, retornando o valor substituído (NULL se a chave não existia)
+void *IntTable_Insert(IntTable table, uint64_t key, void *value);
+
+// Retorna o valor correspondente à chave (NULL se não existir)
+void *IntTable_Find(IntTable table, uint64_t key);
+
+// Remove o par chave-valor e retorna o valor removido (NULL se não existir)
+void *IntTable_Remove(IntTable table, uint64_t key);
+
+int IntTable_GetLength(IntTable table);
+
+// Destrói a tabela, executando destroy em todos os valores (se não for NULL)
+void IntTable_Destroy(IntTable table, void (*destroy)(void *));
+
+#endif
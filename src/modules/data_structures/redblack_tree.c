@@ -1,6 +1,10 @@
 #include <stdlib.h>
 
 #include "redblack_tree.h"
+#include "../util/stats.h"
+
+// Operações em lote reconstroem a árvore quando afetam mais que 1/RBTREE_REBUILD_RATIO dos nós
+#define RBTREE_REBUILD_RATIO 8
 
 typedef struct node_t {
     NodeColor color;
@@ -87,6 +91,7 @@ Value RBTree_Find(RBTree treeVoid, Key key) {
     RBTreeImpl tree = (RBTreeImpl) treeVoid;
     NodeImpl currentNode = tree->root;
     while (currentNode != tree->nil) {
+        STATS_VISIT();
         int cmpResult = tree->compare(key, currentNode->key);
         if (cmpResult < 0)
             currentNode = currentNode->left;
@@ -121,9 +126,189 @@ Value RBTree_Remove(RBTree treeVoid, Key key) {
     return value;
 }
 
+// Ordena as chaves com a função de comparação da árvore (merge sort)
+static void _sortKeys(RBTreeImpl tree, Key *keys, Key *aux, int n) {
+    if (n < 2)
+        return;
+    int half = n / 2;
+    _sortKeys(tree, keys, aux, half);
+    _sortKeys(tree, keys + half, aux, n - half);
+
+    int i = 0, j = half, k = 0;
+    while (i < half && j < n) {
+        if (tree->compare(keys[j], keys[i]) < 0)
+            aux[k++] = keys[j++];
+        else
+            aux[k++] = keys[i++];
+    }
+    while (i < half)
+        aux[k++] = keys[i++];
+    while (j < n)
+        aux[k++] = keys[j++];
+    for (k = 0; k < n; k++)
+        keys[k] = aux[k];
+}
+
+// Coloca os nós da subárvore em ordem no vetor, retornando a nova posição final
+static NodeImpl *_flattenNodes(RBTreeImpl tree, NodeImpl node, NodeImpl *vector) {
+    if (node == tree->nil)
+        return vector;
+    vector = _flattenNodes(tree, node->left, vector);
+    *(vector++) = node;
+    return _flattenNodes(tree, node->right, vector);
+}
+
+// Monta uma árvore balanceada a partir dos nós ordenados em nodes[lo..hi]. As folhas do
+// último nível (incompleto) ficam vermelhas, garantindo a mesma altura negra em todos os caminhos
+static NodeImpl _buildBalanced(RBTreeImpl tree, NodeImpl *nodes, int lo, int hi,
+                               int depth, int redDepth, NodeImpl parent) {
+    if (lo > hi)
+        return tree->nil;
+    int mid = lo + (hi - lo) / 2;
+    NodeImpl node = nodes[mid];
+    node->parent = parent;
+    node->color = depth > 0 && depth == redDepth ? RED : BLACK;
+    node->left = _buildBalanced(tree, nodes, lo, mid - 1, depth + 1, redDepth, node);
+    node->right = _buildBalanced(tree, nodes, mid + 1, hi, depth + 1, redDepth, node);
+    return node;
+}
+
+static void _rebuild(RBTreeImpl tree, NodeImpl *nodes, int n) {
+    int redDepth = 0;
+    while ((2 << redDepth) <= n)
+        redDepth++;
+    tree->root = _buildBalanced(tree, nodes, 0, n - 1, 0, redDepth, tree->nil);
+    tree->length = n;
+}
+
+int RBTree_RemoveMany(RBTree treeVoid, Key *keys, int n) {
+    RBTreeImpl tree = (RBTreeImpl) treeVoid;
+    int removed = 0;
+
+    // Poucas remoções: remover uma a uma
+    if (n < tree->length / RBTREE_REBUILD_RATIO) {
+        for (int i = 0; i < n; i++) {
+            if (RBTree_Remove(tree, keys[i]) != NULL)
+                removed++;
+        }
+        return removed;
+    }
+
+    Key *aux = malloc(n * sizeof(Key));
+    _sortKeys(tree, keys, aux, n);
+    free(aux);
+
+    NodeImpl *nodes = malloc((tree->length + 1) * sizeof(NodeImpl));
+    int length = _flattenNodes(tree, tree->root, nodes) - nodes;
+
+    // Percorrer os nós e as chaves ordenadas ao mesmo tempo, mantendo os que não foram pedidos
+    int kept = 0, k = 0;
+    for (int i = 0; i < length; i++) {
+        while (k < n && tree->compare(keys[k], nodes[i]->key) < 0)
+            k++;
+        if (k < n && tree->compare(keys[k], nodes[i]->key) == 0) {
+            free(nodes[i]);
+            removed++;
+            k++;
+        } else {
+            nodes[kept++] = nodes[i];
+        }
+    }
+
+    _rebuild(tree, nodes, kept);
+    free(nodes);
+    return removed;
+}
+
+// Ordena os nós pela chave (merge sort estável)
+static void _sortNodes(RBTreeImpl tree, NodeImpl *nodes, NodeImpl *aux, int n) {
+    if (n < 2)
+        return;
+    int half = n / 2;
+    _sortNodes(tree, nodes, aux, half);
+    _sortNodes(tree, nodes + half, aux, n - half);
+
+    int i = 0, j = half, k = 0;
+    while (i < half && j < n) {
+        if (tree->compare(nodes[j]->key, nodes[i]->key) < 0)
+            aux[k++] = nodes[j++];
+        else
+            aux[k++] = nodes[i++];
+    }
+    while (i < half)
+        aux[k++] = nodes[i++];
+    while (j < n)
+        aux[k++] = nodes[j++];
+    for (k = 0; k < n; k++)
+        nodes[k] = aux[k];
+}
+
+int RBTree_InsertMany(RBTree treeVoid, Key *keys, Value *values, int n) {
+    RBTreeImpl tree = (RBTreeImpl) treeVoid;
+    int oldLength = tree->length;
+
+    // Poucas inserções: inserir uma a uma
+    if (n < tree->length / RBTREE_REBUILD_RATIO) {
+        for (int i = 0; i < n; i++)
+            RBTree_Insert(tree, keys[i], values[i]);
+        return tree->length - oldLength;
+    }
+
+    NodeImpl *newNodes = malloc((n + 1) * sizeof(NodeImpl));
+    NodeImpl *aux = malloc((n + 1) * sizeof(NodeImpl));
+    for (int i = 0; i < n; i++) {
+        newNodes[i] = malloc(sizeof(struct node_t));
+        newNodes[i]->key = keys[i];
+        newNodes[i]->value = values[i];
+    }
+    _sortNodes(tree, newNodes, aux, n);
+    free(aux);
+
+    // Chaves repetidas no próprio lote: vale a última
+    int newLength = 0;
+    for (int i = 0; i < n; i++) {
+        if (newLength > 0 && tree->compare(newNodes[newLength - 1]->key, newNodes[i]->key) == 0) {
+            free(newNodes[newLength - 1]);
+            newLength--;
+        }
+        newNodes[newLength++] = newNodes[i];
+    }
+
+    NodeImpl *oldNodes = malloc((oldLength + 1) * sizeof(NodeImpl));
+    _flattenNodes(tree, tree->root, oldNodes);
+
+    // Intercalar os nós antigos com os novos; em caso de chave igual, o novo substitui o valor
+    NodeImpl *nodes = malloc((oldLength + newLength + 1) * sizeof(NodeImpl));
+    int i = 0, j = 0, k = 0;
+    while (i < oldLength && j < newLength) {
+        int cmpResult = tree->compare(newNodes[j]->key, oldNodes[i]->key);
+        if (cmpResult < 0) {
+            nodes[k++] = newNodes[j++];
+        } else if (cmpResult > 0) {
+            nodes[k++] = oldNodes[i++];
+        } else {
+            oldNodes[i]->key = newNodes[j]->key;
+            oldNodes[i]->value = newNodes[j]->value;
+            free(newNodes[j++]);
+            nodes[k++] = oldNodes[i++];
+        }
+    }
+    while (i < oldLength)
+        nodes[k++] = oldNodes[i++];
+    while (j < newLength)
+        nodes[k++] = newNodes[j++];
+
+    _rebuild(tree, nodes, k);
+    free(nodes);
+    free(oldNodes);
+    free(newNodes);
+    return tree->length - oldLength;
+}
+
 static void _executeNode(RBTreeImpl tree, NodeImpl node, void (*func)(Value, void*), void *param) {
     if (node != tree->nil) {
         _executeNode(tree, node->left, func, param);
+        STATS_VISIT();
         func(node->value, param);
         _executeNode(tree, node->right, func, param);
     }
@@ -194,6 +379,7 @@ Key RBTreeN_GetKey(RBTree treeVoid, Node nodeVoid) {
 
 Value RBTreeN_GetValue(RBTree treeVoid, Node nodeVoid) {
     NodeImpl node = (NodeImpl) nodeVoid;
+    STATS_VISIT();
     return node->value;
 }
 
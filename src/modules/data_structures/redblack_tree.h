@@ -28,6 +28,15 @@ Value RBTree_Find(RBTree tree, Key key);
 // Remove o par chave-valor e retorna o valor removido (NULL se não existir)
 Value RBTree_Remove(RBTree tree, Key key);
 
+// Remove de uma vez os pares das 'n' chaves em 'keys' (a ordem é alterada), reconstruindo
+// a árvore em tempo linear quando a quantidade for grande. Retorna o número de removidos
+int RBTree_RemoveMany(RBTree tree, Key *keys, int n);
+
+// Insere de uma vez os 'n' pares (keys[i], values[i]), reconstruindo a árvore em tempo linear
+// quando a quantidade for grande. Chaves já existentes têm o valor substituído, como em RBTree_Insert.
+// Retorna o número de nós novos
+int RBTree_InsertMany(RBTree tree, Key *keys, Value *values, int n);
+
 // Executa func em todos os valores, com o valor como primeiro parâmetro e
 // param como o segundo -> func(valor, param)
 void RBTree_Execute(RBTree tree, void (*func)(Value, void*), void *param);
@@ -7,12 +7,14 @@ typedef struct block_t {
     Point point;
     double w;
     double h;
-    char cFill[24];
-    char cStroke[24];
-    char wStroke[16];
+    char *cFill;
+    char *cStroke;
+    char *wStroke;
     RBTree buildings;
     RBTree commerces;
-    RBTree residents;
+    CommerceCount *commerceCounts;
+    int commerceTypes;
+    PersonList residents;
 } *BlockPtr;
 
 Block Block_Create(char cep[], double x, double y, double w, double h, 
@@ -22,12 +24,14 @@ Block Block_Create(char cep[], double x, double y, double w, double h,
     block->point = Point_Create(x, y);
     block->w = w;
     block->h = h;
-    strcpy(block->cFill, cFill);
-    strcpy(block->cStroke, cStroke);
-    strcpy(block->wStroke, wStroke);
+    block->cFill = StringPool_Intern(cFill);
+    block->cStroke = StringPool_Intern(cStroke);
+    block->wStroke = StringPool_Intern(wStroke);
     block->buildings = RBTree_Create(compareStrings);
     block->commerces = RBTree_Create(compareStrings);
-    block->residents = RBTree_Create(compareStrings);
+    block->commerceCounts = NULL;
+    block->commerceTypes = 0;
+    PersonList_Init(&block->residents);
     return block;
 }
 
@@ -61,7 +65,7 @@ char *Block_GetCFill(Block blockVoid) {
 }
 
 void Block_SetCFill(Block blockVoid, char *cFill) {
-    strcpy(((BlockPtr) blockVoid)->cFill, cFill);
+    ((BlockPtr) blockVoid)->cFill = StringPool_Intern(cFill);
 }
 
 char *Block_GetCStroke(Block blockVoid) {
@@ -71,7 +75,7 @@ char *Block_GetCStroke(Block blockVoid) {
 
 void Block_SetCStroke(Block blockVoid, char *cStroke) {
     BlockPtr block = (BlockPtr) blockVoid;
-    strcpy(block->cStroke, cStroke);
+    block->cStroke = StringPool_Intern(cStroke);
 }
 
 char *Block_GetWStroke(Block blockVoid) {
@@ -80,7 +84,7 @@ char *Block_GetWStroke(Block blockVoid) {
 }
 
 void Block_SetWStroke(Block blockVoid, char *wStroke) {
-    strcpy(((BlockPtr) blockVoid)->wStroke, wStroke);
+    ((BlockPtr) blockVoid)->wStroke = StringPool_Intern(wStroke);
 }
 
 double Block_GetX(Block blockVoid) {
@@ -148,8 +152,8 @@ RBTree Block_GetCommerces(Block blockVoid) {
     return ((BlockPtr) blockVoid)->commerces;
 }
 
-RBTree Block_GetResidents(Block blockVoid) {
-    return ((BlockPtr) blockVoid)->residents;
+PersonList *Block_GetResidents(Block blockVoid) {
+    return &((BlockPtr) blockVoid)->residents;
 }
 
 void Block_InsertBuilding(Block blockVoid, Building building) {
@@ -157,14 +161,40 @@ void Block_InsertBuilding(Block blockVoid, Building building) {
     RBTree_Insert(block->buildings, Building_GetKey(building), building);
 }
 
+CommerceCount *Block_GetCommerceCounts(Block blockVoid, int *length) {
+    BlockPtr block = (BlockPtr) blockVoid;
+    *length = block->commerceTypes;
+    return block->commerceCounts;
+}
+
+// Poucos tipos por quadra: busca linear, removendo o tipo quando a contagem zera
+static void _countCommerce(BlockPtr block, Commerce commerce, int delta) {
+    CommerceType type = Commerce_GetType(commerce);
+    for (int i = 0; i < block->commerceTypes; i++) {
+        if (block->commerceCounts[i].type == type) {
+            block->commerceCounts[i].count += delta;
+            if (block->commerceCounts[i].count <= 0)
+                block->commerceCounts[i] = block->commerceCounts[--block->commerceTypes];
+            return;
+        }
+    }
+    if (delta <= 0)
+        return;
+    block->commerceCounts = realloc(block->commerceCounts, (block->commerceTypes + 1) * sizeof(CommerceCount));
+    block->commerceCounts[block->commerceTypes++] = (CommerceCount) {type, delta};
+}
+
 void Block_InsertCommerce(Block blockVoid, Commerce commerce) {
     BlockPtr block = (BlockPtr) blockVoid;
-    RBTree_Insert(block->commerces, Commerce_GetCnpj(commerce), commerce);
+    Commerce replaced = RBTree_Insert(block->commerces, Commerce_GetCnpj(commerce), commerce);
+    if (replaced != NULL)
+        _countCommerce(block, replaced, -1);
+    _countCommerce(block, commerce, 1);
 }
 
 void Block_InsertResident(Block blockVoid, Person person) {
     BlockPtr block = (BlockPtr) blockVoid;
-    RBTree_Insert(block->residents, Person_GetCpf(person), person);
+    PersonList_Insert(&block->residents, person);
 }
 
 void Block_RemoveBuilding(Block blockVoid, Building building) {
@@ -174,12 +204,14 @@ void Block_RemoveBuilding(Block blockVoid, Building building) {
 
 void Block_RemoveCommerce(Block blockVoid, Commerce commerce) {
     BlockPtr block = (BlockPtr) blockVoid;
-    RBTree_Remove(block->commerces, Commerce_GetCnpj(commerce));
+    Commerce removed = RBTree_Remove(block->commerces, Commerce_GetCnpj(commerce));
+    if (removed != NULL)
+        _countCommerce(block, removed, -1);
 }
 
 void Block_RemoveResident(Block blockVoid, Person person) {
     BlockPtr block = (BlockPtr) blockVoid;
-    RBTree_Remove(block->residents, Person_GetCpf(person));
+    PersonList_Remove(&block->residents, person);
 }
 
 void Block_Describe(Block blockVoid, char *str) {
@@ -193,7 +225,8 @@ void Block_Destroy(Block blockVoid) {
     Point_Destroy(block->point);
     RBTree_Destroy(block->buildings, NULL);
     RBTree_Destroy(block->commerces, NULL);
-    RBTree_Destroy(block->residents, NULL);
+    free(block->commerceCounts);
+    PersonList_Free(&block->residents);
     free(block);
 }
 
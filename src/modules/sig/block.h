@@ -7,6 +7,8 @@
 
 #include "../aux/point.h"
 #include "../data_structures/redblack_tree.h"
+#include "../util/string_pool.h"
+#include "commerce_type.h"
 
 typedef void *Block;
 typedef void *Building;
@@ -21,7 +23,10 @@ RBTree Block_GetBuildings(Block block);
 
 RBTree Block_GetCommerces(Block block);
 
-RBTree Block_GetResidents(Block block);
+PersonList *Block_GetResidents(Block block);
+
+// Quantidade de estabelecimentos da quadra por tipo, mantida a cada inserção e remoção
+CommerceCount *Block_GetCommerceCounts(Block block, int *length);
 
 void Block_InsertBuilding(Block block, Building building);
 
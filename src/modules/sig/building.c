@@ -10,7 +10,7 @@ typedef struct building_t {
     Block block;
     char key[32];
     RBTree commerces;
-    RBTree residents;
+    PersonList residents;
     bool highlighted;
     bool painted;
 } *BuildingPtr;
@@ -59,7 +59,7 @@ Building Building_Create(Block block, char face, int num, double f, double p, do
     Building_MakeAddress(building->key, Block_GetCep(block), face, num);
 
     building->commerces = RBTree_Create(compareStrings);
-    building->residents = RBTree_Create(compareStrings);
+    PersonList_Init(&building->residents);
     building->highlighted = false;
     building->painted = false;
 
@@ -113,8 +113,8 @@ Segment *Building_PutSegments(Building buildingVoid, Segment *vector, double xSo
     return vector;
 }
 
-RBTree Building_GetResidents(Building buildingVoid) {
-    return ((BuildingPtr) buildingVoid)->residents;
+PersonList *Building_GetResidents(Building buildingVoid) {
+    return &((BuildingPtr) buildingVoid)->residents;
 }
 
 RBTree Building_GetCommerces(Building buildingVoid) {
@@ -128,7 +128,7 @@ void Building_InsertCommerce(Building buildingVoid, Commerce commerce) {
 
 void Building_InsertResident(Building buildingVoid, Person person) {
     BuildingPtr building = (BuildingPtr) buildingVoid;
-    RBTree_Insert(building->residents, Person_GetCpf(person), person);
+    PersonList_Insert(&building->residents, person);
 }
 
 void Building_RemoveCommerce(Building buildingVoid, Commerce commerce) {
@@ -138,7 +138,7 @@ void Building_RemoveCommerce(Building buildingVoid, Commerce commerce) {
 
 void Building_RemoveResident(Building buildingVoid, Person person) {
     BuildingPtr building = (BuildingPtr) buildingVoid;
-    RBTree_Remove(building->residents, Person_GetCpf(person));
+    PersonList_Remove(&building->residents, person);
 }
 
 double Building_GetX(Building buildingVoid) {
@@ -242,6 +242,6 @@ void Building_Destroy(Building buildingVoid) {
     BuildingPtr building = (BuildingPtr) buildingVoid;
     Point_Destroy(building->point);
     RBTree_Destroy(building->commerces, NULL);
-    RBTree_Destroy(building->residents, NULL);
+    PersonList_Free(&building->residents);
     free(building);
 }
@@ -12,9 +12,10 @@ typedef void *Building;
 typedef void *Commerce;
 typedef void *Person;
 
+// person.h primeiro: block.h usa PersonList
+#include "person.h"
 #include "block.h"
 #include "commerce.h"
-#include "person.h"
 
 Building Building_Create(Block block, char face, int num, double f, double p, double mrg);
 
@@ -25,7 +26,7 @@ void Building_MakeAddress(char *address, char *cep, char face, int num);
 // das coordenadas de origem e com direção horizontal à esquerda
 Segment *Building_PutSegments(Building building, Segment *vector, double x, double y);
 
-RBTree Building_GetResidents(Building building);
+PersonList *Building_GetResidents(Building building);
 
 RBTree Building_GetCommerces(Building building);
 
@@ -1,14 +1,41 @@
 #include "commerce_type.h"
 
+// Lado das células da grade; cada estabelecimento fica na célula da origem da sua quadra
+#define COMMERCE_TYPE_CELL_SIZE 256.0
+
+typedef struct commerce_entry_t {
+    void *commerce;
+    double x, y, w, h;
+} CommerceEntry;
+
+typedef struct commerce_cell_t {
+    CommerceEntry *entries;
+    int length, capacity;
+} *CommerceCell;
+
 typedef struct commerceType_t {
     char code[16];
     char description[64];
+    IntTable cellTable;      // chave da célula -> CommerceCell
+    IntTable commerceCells;  // endereço do estabelecimento -> CommerceCell
+    CommerceCell *cells;     // células já criadas, para percorrer todas
+    int cellCount, cellCapacity;
+    int commerceCount;
+    double maxW, maxH;       // maiores dimensões de quadra inseridas
 } *CommerceTypePtr;
 
 CommerceType CommerceType_Create(char code[], char description[]) {
     CommerceTypePtr commerceType = malloc(sizeof(struct commerceType_t));
     strcpy(commerceType->code, code);
     strcpy(commerceType->description, description);
+    commerceType->cellTable = IntTable_Create(16);
+    commerceType->commerceCells = IntTable_Create(16);
+    commerceType->cells = NULL;
+    commerceType->cellCount = 0;
+    commerceType->cellCapacity = 0;
+    commerceType->commerceCount = 0;
+    commerceType->maxW = 0;
+    commerceType->maxH = 0;
     return commerceType;
 }
 
@@ -32,6 +59,113 @@ void CommerceType_SetDescription(CommerceType commerceTypeVoid, char description
     strcpy(commerceType->description, description);
 }
 
+static int _cellCoord(double value) {
+    return (int) floor(value / COMMERCE_TYPE_CELL_SIZE);
+}
+
+static uint64_t _cellKey(int cx, int cy) {
+    // + 1 porque a chave 0 é reservada na IntTable
+    return ((((uint64_t) (uint32_t) cx) << 32) | (uint32_t) cy) + 1;
+}
+
+void CommerceType_InsertCommerce(CommerceType commerceTypeVoid, void *commerce, double x, double y, double w, double h) {
+    CommerceTypePtr commerceType = (CommerceTypePtr) commerceTypeVoid;
+    if (IntTable_Find(commerceType->commerceCells, (uintptr_t) commerce) != NULL)
+        return;
+
+    uint64_t key = _cellKey(_cellCoord(x), _cellCoord(y));
+    CommerceCell cell = IntTable_Find(commerceType->cellTable, key);
+    if (cell == NULL) {
+        cell = malloc(sizeof(struct commerce_cell_t));
+        cell->entries = NULL;
+        cell->length = 0;
+        cell->capacity = 0;
+        IntTable_Insert(commerceType->cellTable, key, cell);
+
+        if (commerceType->cellCount == commerceType->cellCapacity) {
+            commerceType->cellCapacity = commerceType->cellCapacity == 0 ? 8 : commerceType->cellCapacity * 2;
+            commerceType->cells = realloc(commerceType->cells, commerceType->cellCapacity * sizeof(CommerceCell));
+        }
+        commerceType->cells[commerceType->cellCount++] = cell;
+    }
+
+    if (cell->length == cell->capacity) {
+        cell->capacity = cell->capacity == 0 ? 4 : cell->capacity * 2;
+        cell->entries = realloc(cell->entries, cell->capacity * sizeof(CommerceEntry));
+    }
+    cell->entries[cell->length++] = (CommerceEntry) {commerce, x, y, w, h};
+    IntTable_Insert(commerceType->commerceCells, (uintptr_t) commerce, cell);
+    commerceType->commerceCount++;
+
+    if (w > commerceType->maxW)
+        commerceType->maxW = w;
+    if (h > commerceType->maxH)
+        commerceType->maxH = h;
+}
+
+void CommerceType_RemoveCommerce(CommerceType commerceTypeVoid, void *commerce) {
+    CommerceTypePtr commerceType = (CommerceTypePtr) commerceTypeVoid;
+    CommerceCell cell = IntTable_Remove(commerceType->commerceCells, (uintptr_t) commerce);
+    if (cell == NULL)
+        return;
+
+    for (int i = 0; i < cell->length; i++) {
+        if (cell->entries[i].commerce == commerce) {
+            cell->entries[i] = cell->entries[--cell->length];
+            break;
+        }
+    }
+    commerceType->commerceCount--;
+}
+
+int CommerceType_GetCommerceCount(CommerceType commerceType) {
+    return ((CommerceTypePtr) commerceType)->commerceCount;
+}
+
+static void _collectCell(CommerceCell cell, double minX, double minY, double maxX, double maxY,
+                         void **result, int *length) {
+    for (int i = 0; i < cell->length; i++) {
+        CommerceEntry *entry = &cell->entries[i];
+        if (entry->x <= maxX && entry->x + entry->w >= minX && entry->y <= maxY && entry->y + entry->h >= minY)
+            result[(*length)++] = entry->commerce;
+    }
+}
+
+void **CommerceType_FindInRect(CommerceType commerceTypeVoid, double minX, double minY,
+                               double maxX, double maxY, int *length) {
+    CommerceTypePtr commerceType = (CommerceTypePtr) commerceTypeVoid;
+    void **result = malloc((commerceType->commerceCount + 1) * sizeof(void *));
+    *length = 0;
+
+    // A origem de uma quadra que intersecta o retângulo pode estar até maxW/maxH antes dele
+    int cx0 = _cellCoord(minX - commerceType->maxW), cx1 = _cellCoord(maxX);
+    int cy0 = _cellCoord(minY - commerceType->maxH), cy1 = _cellCoord(maxY);
+    double rectCells = ((double) cx1 - cx0 + 1) * ((double) cy1 - cy0 + 1);
+
+    if (rectCells > commerceType->cellCount) {
+        // Retângulo grande: mais barato percorrer só as células existentes
+        for (int i = 0; i < commerceType->cellCount; i++)
+            _collectCell(commerceType->cells[i], minX, minY, maxX, maxY, result, length);
+    } else {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            for (int cy = cy0; cy <= cy1; cy++) {
+                CommerceCell cell = IntTable_Find(commerceType->cellTable, _cellKey(cx, cy));
+                if (cell != NULL)
+                    _collectCell(cell, minX, minY, maxX, maxY, result, length);
+            }
+        }
+    }
+    return result;
+}
+
 void CommerceType_Destroy(CommerceType commerceTypeVoid) {
-    free((CommerceTypePtr) commerceTypeVoid);
+    CommerceTypePtr commerceType = (CommerceTypePtr) commerceTypeVoid;
+    for (int i = 0; i < commerceType->cellCount; i++) {
+        free(commerceType->cells[i]->entries);
+        free(commerceType->cells[i]);
+    }
+    free(commerceType->cells);
+    IntTable_Destroy(commerceType->cellTable, NULL);
+    IntTable_Destroy(commerceType->commerceCells, NULL);
+    free(commerceType);
 }
@@ -3,9 +3,21 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
+#include "../data_structures/int_table.h"
+
+// Tipo de estabelecimento comercial. Cada tipo mantém um índice espacial dos seus
+// estabelecimentos (grade de células pela posição da quadra), para que consultas por tipo não
+// precisem percorrer todos os estabelecimentos da cidade
 typedef void *CommerceType;
 
+// Quantidade de estabelecimentos de um tipo (contagens mantidas por quadra)
+typedef struct commerce_count_t {
+    CommerceType type;
+    int count;
+} CommerceCount;
+
 CommerceType CommerceType_Create(char code[], char description[]);
 
 char *CommerceType_GetCode(CommerceType commerceType);
@@ -16,6 +28,20 @@ void CommerceType_SetCode(CommerceType commerceType, char code[]);
 
 void CommerceType_SetDescription(CommerceType commerceType, char description[]);
 
+// Insere o estabelecimento no índice do tipo; x, y, w e h são o retângulo da sua quadra, guardado
+// no índice: quando a quadra é movida o estabelecimento deve ser removido e inserido de novo, e
+// quando ela é removida, só removido
+void CommerceType_InsertCommerce(CommerceType commerceType, void *commerce, double x, double y, double w, double h);
+
+void CommerceType_RemoveCommerce(CommerceType commerceType, void *commerce);
+
+int CommerceType_GetCommerceCount(CommerceType commerceType);
+
+// Retorna um vetor (a ser liberado com free) com os estabelecimentos do tipo cuja quadra
+// intersecta o retângulo [minX, maxX] x [minY, maxY], escrevendo a quantidade em 'length'
+void **CommerceType_FindInRect(CommerceType commerceType, double minX, double minY,
+                               double maxX, double maxY, int *length);
+
 void CommerceType_Destroy(CommerceType commerceType);
 
 #endif
@@ -3,9 +3,9 @@
 typedef struct equip_t {
     char id[16];
     Point point;
-    char cFill[24];
-    char cStroke[24];
-    char wStroke[16];
+    char *cFill;
+    char *cStroke;
+    char *wStroke;
     bool highlighted;
 } *EquipPtr;
 
@@ -14,9 +14,9 @@ Equip Equip_Create(char id[], double x, double y, char cFill[], char cStroke[],
     strcpy(equip->id, id);
     equip->point = Point_Create(x, y);
     equip->highlighted = false;
-    strcpy(equip->cFill, cFill);
-    strcpy(equip->cStroke, cStroke);
-    strcpy(equip->wStroke, wStroke);
+    equip->cFill = StringPool_Intern(cFill);
+    equip->cStroke = StringPool_Intern(cStroke);
+    equip->wStroke = StringPool_Intern(wStroke);
     return equip;
 }
 
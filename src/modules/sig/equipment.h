@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include "../aux/point.h"
+#include "../util/string_pool.h"
 
 typedef void *Equip;
 
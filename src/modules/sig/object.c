@@ -3,9 +3,9 @@
 typedef struct object_t {
     void *content;
     ObjectType type;
-    char color1[24], color2[24];
+    char *color1, *color2;
     char id[8];
-    char stroke[16];
+    char *stroke;
 } *ObjectPtr;
 
 Object Object_Create(char id[], void *content, int type, char color1[], char color2[], char stroke[]) {
@@ -13,9 +13,9 @@ Object Object_Create(char id[], void *content, int type, char color1[], char col
     newObj->content = content;
     newObj->type = type;
     strcpy(newObj->id, id);
-    strcpy(newObj->color1, color1);
-    strcpy(newObj->color2, color2);
-    strcpy(newObj->stroke, stroke);
+    newObj->color1 = StringPool_Intern(color1);
+    newObj->color2 = StringPool_Intern(color2);
+    newObj->stroke = StringPool_Intern(stroke);
     return newObj;
 }
 
@@ -7,6 +7,7 @@
 #include <string.h>
 #include "circle.h"
 #include "rectangle.h"
+#include "../util/string_pool.h"
 
 typedef enum ObjectType {
     OBJ_CIRC,
@@ -1,51 +1,201 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include <pthread.h>
+
 #include "person.h"
 
+// Alfabeto do CPF codificado: 0 encerra o texto, os demais seguem a ordem ASCII
+static const char CPF_ALPHABET[] = "\0-./0123456789";
+#define CPF_MAX_CHARS 16
+
+// CPFs e datas fora do formato compacto guardam o ponteiro do texto (StringPool) com os 4 bits
+// mais altos em 1, valor que nenhum CPF codificado (primeiro código até 13) nem data alcança
+#define TEXT_TAG_MASK ((uint64_t) 0xF << 60)
+#define TEXT_TAG TEXT_TAG_MASK
+
 typedef struct person_t {
-    char cpf[16];
-    char name[32];
-    char surname[32];
-    char sex;
-    char birthDate[16];
+    uint64_t cpf;
+    char *name;
+    char *surname;
+    char *cep;         // NULL enquanto a pessoa não tiver endereço
+    char *complement;
     Block block;
     Building building;
-    char address[64];
-    char complement[16];
+    uint64_t birthDate;  // (ano << 9) | (mês << 5) | dia, ou o texto marcado com TEXT_TAG
+    int num;
+    char face;
+    char sex;
+    signed char ageBand;
 } *PersonPtr;
 
+// Data de referência para as faixas etárias, lida uma vez
+static pthread_once_t todayOnce = PTHREAD_ONCE_INIT;
+static int todayDay, todayMonth, todayYear;
+
+static uint64_t _tagText(char *interned) {
+    return TEXT_TAG | (uintptr_t) interned;
+}
+
+// Texto guardado em 'value', ou NULL se 'value' está no formato compacto
+static char *_taggedText(uint64_t value) {
+    if ((value & TEXT_TAG_MASK) != TEXT_TAG)
+        return NULL;
+    return (char *) (uintptr_t) (value & ~TEXT_TAG_MASK);
+}
+
+static int _cpfCode(char c) {
+    for (int i = 1; i < (int) sizeof(CPF_ALPHABET) - 1; i++) {
+        if (CPF_ALPHABET[i] == c)
+            return i;
+    }
+    return 0;
+}
+
+// CPF compactado, ou 0 se ele tem caracteres fora do alfabeto
+static uint64_t _packCpf(char cpf[]) {
+    int length = strlen(cpf);
+    if (length == 0 || length > CPF_MAX_CHARS)
+        return 0;
+
+    uint64_t key = 0;
+    for (int i = 0; i < CPF_MAX_CHARS; i++) {
+        int code = 0;
+        if (i < length) {
+            code = _cpfCode(cpf[i]);
+            if (code == 0)
+                return 0;
+        }
+        key = (key << 4) | code;
+    }
+    return key;
+}
+
+// Chave do CPF; um CPF fora do alfabeto é registrado no StringPool se 'intern', ou apenas procurado
+static uint64_t _cpfKey(char cpf[], bool intern) {
+    uint64_t key = _packCpf(cpf);
+    if (key != 0 || strlen(cpf) > CPF_MAX_CHARS)
+        return key;
+    char *text = intern ? StringPool_Intern(cpf) : StringPool_Find(cpf);
+    return text != NULL ? _tagText(text) : 0;
+}
+
+uint64_t Person_EncodeCpf(char cpf[]) {
+    return _cpfKey(cpf, false);
+}
+
+void Person_DecodeCpf(uint64_t key, char cpf[]) {
+    char *text = _taggedText(key);
+    if (text != NULL) {
+        strcpy(cpf, text);
+        return;
+    }
+
+    int length = 0;
+    for (int i = CPF_MAX_CHARS - 1; i >= 0; i--) {
+        int code = (key >> (i * 4)) & 0xF;
+        if (code == 0)
+            break;
+        cpf[length++] = CPF_ALPHABET[code];
+    }
+    cpf[length] = '\0';
+}
+
+// Data compactada, ou 0 se ela não for válida
+static uint64_t _packDate(char date[]) {
+    int day, month, year;
+    if (sscanf(date, "%d/%d/%d", &day, &month, &year) != 3 || day < 1 || day > 31 ||
+            month < 1 || month > 12 || year < 0 || year > 9999)
+        return 0;
+    return ((uint64_t) year << 9) | (month << 5) | day;
+}
+
+static void _formatDate(uint64_t packed, char date[]) {
+    sprintf(date, "%02d/%02d/%04d", (int) (packed & 0x1F), (int) ((packed >> 5) & 0xF), (int) (packed >> 9));
+}
+
+static void _readToday() {
+    time_t now = time(NULL);
+    struct tm today;
+    localtime_r(&now, &today);
+    todayDay = today.tm_mday;
+    todayMonth = today.tm_mon + 1;
+    todayYear = today.tm_year + 1900;
+}
+
+static int _ageBand(uint64_t birthDate) {
+    if (birthDate == 0)
+        return -1;
+    pthread_once(&todayOnce, _readToday);
+    int day = birthDate & 0x1F, month = (birthDate >> 5) & 0xF, year = birthDate >> 9;
+    int age = todayYear - year;
+    if (todayMonth < month || (todayMonth == month && todayDay < day))
+        age--;
+    if (age < 0)
+        age = 0;
+    int band = age / 15;
+    return band < PERSON_AGE_BANDS ? band : PERSON_AGE_BANDS - 1;
+}
+
 Person Person_Create(char cpf[], char name[], char surname[], char sex, char birthDate[]) {
+    uint64_t key = _cpfKey(cpf, true);
+    if (key == 0)
+        return NULL;
+
+    // A data é compactada só quando pode ser reescrita exatamente como foi lida
+    uint64_t packed = _packDate(birthDate);
+    char formatted[PERSON_BIRTH_DATE_LENGTH] = "";
+    if (packed != 0)
+        _formatDate(packed, formatted);
+
     PersonPtr person = malloc(sizeof(struct person_t));
-    strcpy(person->cpf, cpf);
-    strcpy(person->name, name);
-    strcpy(person->surname, surname);
+    person->cpf = key;
+    person->name = StringPool_Intern(name);
+    person->surname = StringPool_Intern(surname);
     person->sex = sex;
-    strcpy(person->birthDate, birthDate);
+    if (packed != 0 && strcmp(formatted, birthDate) == 0)
+        person->birthDate = packed;
+    else
+        person->birthDate = _tagText(StringPool_Intern(birthDate));
+    person->ageBand = _ageBand(packed);
     person->block = NULL;
     person->building = NULL;
-    person->address[0] = '\0';
-    person->complement[0] = '\0';
+    person->cep = NULL;
+    person->face = '\0';
+    person->num = 0;
+    person->complement = NULL;
     return person;
 }
 
 void Person_DumpToFile(Person personVoid, FILE *file) {
     PersonPtr person = (PersonPtr) personVoid;
+    char cpf[PERSON_CPF_LENGTH], birthDate[PERSON_BIRTH_DATE_LENGTH], address[64];
+    Person_GetCpf(person, cpf);
+    Person_GetBirthDate(person, birthDate);
+    Person_MakeAddress(person, address);
     fprintf(file, "\tCPF: %s\n"
                   "\tNome: %s\n"
                   "\tSobrenome: %s\n"
                   "\tSexo: %s\n"
                   "\tData de nascimento: %s\n"
                   "\tEndereço: %s %s\n",
-                  person->cpf, person->name, person->surname,
+                  cpf, person->name, person->surname,
                   person->sex == 'm' ? "masculino" : "feminino",
-                  person->birthDate,
-                  person->address,
-                  person->complement);
+                  birthDate,
+                  address,
+                  Person_GetComplement(person));
 }
 
-char *Person_GetCpf(Person personVoid) {
+uint64_t Person_GetCpfKey(Person personVoid) {
     PersonPtr person = (PersonPtr) personVoid;
     return person->cpf;
 }
 
+void Person_GetCpf(Person personVoid, char cpf[]) {
+    PersonPtr person = (PersonPtr) personVoid;
+    Person_DecodeCpf(person->cpf, cpf);
+}
+
 char *Person_GetName(Person personVoid) {
     PersonPtr person = (PersonPtr) personVoid;
     return person->name;
@@ -61,9 +211,18 @@ char Person_GetSex(Person personVoid) {
     return person->sex;
 }
 
-char *Person_GetBirthDate(Person personVoid) {
+void Person_GetBirthDate(Person personVoid, char birthDate[]) {
+    PersonPtr person = (PersonPtr) personVoid;
+    char *text = _taggedText(person->birthDate);
+    if (text != NULL)
+        snprintf(birthDate, PERSON_BIRTH_DATE_LENGTH, "%s", text);
+    else
+        _formatDate(person->birthDate, birthDate);
+}
+
+int Person_GetAgeBand(Person personVoid) {
     PersonPtr person = (PersonPtr) personVoid;
-    return person->birthDate;
+    return person->ageBand;
 }
 
 Block Person_GetBlock(Person personVoid) {
@@ -76,61 +235,136 @@ Building Person_GetBuilding(Person personVoid) {
     return person->building;
 }
 
-char *Person_GetAddress(Person personVoid) {
+bool Person_GetAddress(Person personVoid, char **cep, char *face, int *num) {
     PersonPtr person = (PersonPtr) personVoid;
-    return person->address;
+    if (person->cep == NULL)
+        return false;
+    *cep = person->cep;
+    *face = person->face;
+    *num = person->num;
+    return true;
 }
 
-char *Person_GetComplement(Person personVoid) {
+void Person_MakeAddress(Person personVoid, char address[]) {
     PersonPtr person = (PersonPtr) personVoid;
-    return person->complement;
+    if (person->cep == NULL)
+        address[0] = '\0';
+    else
+        Building_MakeAddress(address, person->cep, person->face, person->num);
 }
 
-void Person_SetCpf(Person personVoid, char cpf[]) {
+char *Person_GetComplement(Person personVoid) {
     PersonPtr person = (PersonPtr) personVoid;
-    strcpy(person->cpf, cpf);
+    return person->complement != NULL ? person->complement : "";
 }
 
-void Person_SetName(Person personVoid, char name[]) {
+void Person_SetBlock(Person personVoid, Block block) {
     PersonPtr person = (PersonPtr) personVoid;
-    strcpy(person->name, name);
+    person->block = block;
 }
 
-void Person_SetSurname(Person personVoid, char surname[]) {
+void Person_SetBuilding(Person personVoid, Building building) {
     PersonPtr person = (PersonPtr) personVoid;
-    strcpy(person->surname, surname);
+    person->building = building;
 }
 
-void Person_SetSex(Person personVoid, char sex) {
+void Person_SetAddress(Person personVoid, char cep[], char face, int num) {
     PersonPtr person = (PersonPtr) personVoid;
-    person->sex = sex;
+    person->cep = StringPool_Intern(cep);
+    person->face = face;
+    person->num = num;
 }
 
-void Person_SetBirthDate(Person personVoid, char birthDate[]) {
+void Person_SetComplement(Person personVoid, char complement[]) {
     PersonPtr person = (PersonPtr) personVoid;
-    strcpy(person->birthDate, birthDate);
+    person->complement = StringPool_Intern(complement);
 }
 
-void Person_SetBlock(Person personVoid, Block block) {
-    PersonPtr person = (PersonPtr) personVoid;
-    person->block = block;
+void Person_Destroy(Person personVoid) {
+    free((PersonPtr) personVoid);
 }
 
-void Person_SetBuilding(Person personVoid, Building building) {
-    PersonPtr person = (PersonPtr) personVoid;
-    person->building = building;
+void PersonList_Init(PersonList *list) {
+    list->items = NULL;
+    list->length = 0;
+    list->capacity = 0;
+    memset(&list->counts, 0, sizeof(ResidentCounts));
 }
 
-void Person_SetAddress(Person personVoid, char address[]) {
+static void _count(PersonList *list, Person personVoid, int delta) {
     PersonPtr person = (PersonPtr) personVoid;
-    strcpy(person->address, address);
+    if (person->sex == 'm')
+        list->counts.male += delta;
+    else
+        list->counts.female += delta;
+    if (person->ageBand < 0)
+        list->counts.unknownAge += delta;
+    else
+        list->counts.ageBands[(int) person->ageBand] += delta;
 }
 
-void Person_SetComplement(Person personVoid, char complement[]) {
-    PersonPtr person = (PersonPtr) personVoid;
-    strcpy(person->complement, complement);
+void ResidentCounts_Add(ResidentCounts *total, ResidentCounts *counts) {
+    total->male += counts->male;
+    total->female += counts->female;
+    for (int i = 0; i < PERSON_AGE_BANDS; i++)
+        total->ageBands[i] += counts->ageBands[i];
+    total->unknownAge += counts->unknownAge;
 }
 
-void Person_Destroy(Person personVoid) {
-    free((PersonPtr) personVoid);
+// Compara dois CPFs pelas chaves; só as compactadas têm a ordem dos textos
+static int _compareCpfKeys(uint64_t a, uint64_t b) {
+    if (_taggedText(a) == NULL && _taggedText(b) == NULL)
+        return a < b ? -1 : a > b;
+    char cpfA[PERSON_CPF_LENGTH], cpfB[PERSON_CPF_LENGTH];
+    Person_DecodeCpf(a, cpfA);
+    Person_DecodeCpf(b, cpfB);
+    return strcmp(cpfA, cpfB);
+}
+
+// Primeira posição cujo CPF não é menor que 'key'
+static int _lowerBound(PersonList *list, uint64_t key) {
+    int low = 0, high = list->length;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (_compareCpfKeys(Person_GetCpfKey(list->items[mid]), key) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+void PersonList_Insert(PersonList *list, Person person) {
+    uint64_t key = Person_GetCpfKey(person);
+    int i = _lowerBound(list, key);
+    if (i < list->length && Person_GetCpfKey(list->items[i]) == key) {
+        _count(list, list->items[i], -1);
+        _count(list, person, 1);
+        list->items[i] = person;
+        return;
+    }
+
+    if (list->length == list->capacity) {
+        list->capacity = list->capacity == 0 ? 4 : list->capacity * 2;
+        list->items = realloc(list->items, list->capacity * sizeof(Person));
+    }
+    memmove(&list->items[i + 1], &list->items[i], (list->length - i) * sizeof(Person));
+    list->items[i] = person;
+    list->length++;
+    _count(list, person, 1);
+}
+
+void PersonList_Remove(PersonList *list, Person person) {
+    uint64_t key = Person_GetCpfKey(person);
+    int i = _lowerBound(list, key);
+    if (i == list->length || Person_GetCpfKey(list->items[i]) != key)
+        return;
+    _count(list, list->items[i], -1);
+    memmove(&list->items[i], &list->items[i + 1], (list->length - i - 1) * sizeof(Person));
+    list->length--;
+}
+
+void PersonList_Free(PersonList *list) {
+    free(list->items);
+    PersonList_Init(list);
 }
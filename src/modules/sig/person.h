@@ -2,17 +2,58 @@
 #define PERSON_H
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 typedef void *Person;
 typedef void *Building;
 
+// Faixas etárias: 0-14, 15-29, 30-44, 45-59 e 60 anos ou mais
+#define PERSON_AGE_BANDS 5
+
+// Contagens mantidas junto de uma lista de moradores, atualizadas a cada inserção e remoção
+typedef struct resident_counts_t {
+    int male, female;
+    int ageBands[PERSON_AGE_BANDS];
+    int unknownAge;  // data de nascimento inválida
+} ResidentCounts;
+
+// Lista de pessoas ordenada pelo CPF (moradores de uma quadra ou de um prédio)
+typedef struct person_list_t {
+    Person *items;
+    int length, capacity;
+    ResidentCounts counts;
+} PersonList;
+
 #include "building.h"
+#include "../util/string_pool.h"
+
+// Tamanho mínimo do vetor que recebe um CPF decodificado
+#define PERSON_CPF_LENGTH 17
+
+// Tamanho mínimo do vetor que recebe uma data de nascimento
+#define PERSON_BIRTH_DATE_LENGTH 16
 
+// Converte o CPF em uma chave de 64 bits. Um CPF só com dígitos, '.', '-' e '/' é compactado, 4 bits
+// por caractere; qualquer outro texto (até 16 caracteres) é guardado como está (StringPool).
+// Retorna 0 se o CPF não puder ser representado ou, no segundo caso, se nenhuma pessoa o usar
+uint64_t Person_EncodeCpf(char cpf[]);
+
+// Escreve em 'cpf' (ao menos PERSON_CPF_LENGTH posições) o texto correspondente à chave
+void Person_DecodeCpf(uint64_t key, char cpf[]);
+
+// Cria a pessoa com nome e sobrenome compartilhados (StringPool) e data de nascimento (dd/mm/aaaa)
+// compactada em um inteiro; uma data em outro formato é guardada como está. Retorna NULL se o CPF
+// tiver mais de 16 caracteres
 Person Person_Create(char cpf[], char name[], char surname[], char sex, char birthDate[]);
 
 void Person_DumpToFile(Person person, FILE *file);
 
-char *Person_GetCpf(Person person);
+uint64_t Person_GetCpfKey(Person person);
+
+// Escreve o CPF em 'cpf' (ao menos PERSON_CPF_LENGTH posições)
+void Person_GetCpf(Person person, char cpf[]);
 
 char *Person_GetName(Person person);
 
@@ -20,34 +61,46 @@ char *Person_GetSurname(Person person);
 
 char Person_GetSex(Person person);
 
-char *Person_GetBirthDate(Person person);
+// Escreve a data de nascimento, como foi lida, em 'birthDate' (ao menos PERSON_BIRTH_DATE_LENGTH posições)
+void Person_GetBirthDate(Person person, char birthDate[]);
+
+// Faixa etária (0 a PERSON_AGE_BANDS - 1) na data em que o programa começou, -1 se a data de
+// nascimento for inválida
+int Person_GetAgeBand(Person person);
 
 Block Person_GetBlock(Person person);
 
 Building Person_GetBuilding(Person person);
 
-char *Person_GetAddress(Person person);
+// Retorna false se a pessoa ainda não tem endereço
+bool Person_GetAddress(Person person, char **cep, char *face, int *num);
+
+// Escreve o endereço no formato de Building_MakeAddress (vazio se não houver)
+void Person_MakeAddress(Person person, char address[]);
 
 char *Person_GetComplement(Person person);
 
-void Person_SetCpf(Person person, char cpf[]);
+void Person_SetBlock(Person person, Block block);
 
-void Person_SetName(Person person, char name[]);
+void Person_SetBuilding(Person person, Building building);
 
-void Person_SetSurname(Person person, char surname[]);
+void Person_SetAddress(Person person, char cep[], char face, int num);
 
-void Person_SetSex(Person person, char sex);
+void Person_SetComplement(Person person, char complement[]);
 
-void Person_SetBirthDate(Person person, char birthDate[]);
+void Person_Destroy(Person person);
 
-void Person_SetBlock(Person person, Block block);
+void PersonList_Init(PersonList *list);
 
-void Person_SetBuilding(Person person, Building building);
+// Insere a pessoa na posição de seu CPF, substituindo outra de mesmo CPF
+void PersonList_Insert(PersonList *list, Person person);
 
-void Person_SetAddress(Person person, char address[]);
+void PersonList_Remove(PersonList *list, Person person);
 
-void Person_SetComplement(Person person, char complement[]);
+// Soma as contagens de 'counts' em 'total'
+void ResidentCounts_Add(ResidentCounts *total, ResidentCounts *counts);
 
-void Person_Destroy(Person person);
+// Libera o vetor (mas não as pessoas)
+void PersonList_Free(PersonList *list);
 
 #endif
@@ -1,11 +1,10 @@
 #include "file_util.h"
 
-FILE *openFile(char *baseDir, char *path, char *flags) {
-    char *fullPath;
+char *joinPath(char *baseDir, char *path) {
     int len = strlen(path) + 2;
     if (baseDir != NULL)
         len += strlen(baseDir);
-    fullPath = malloc(len * sizeof(char));
+    char *fullPath = malloc(len * sizeof(char));
     if (baseDir != NULL) {
         if (baseDir[strlen(baseDir) - 1] == '/') {
             sprintf(fullPath, "%s%s", baseDir, path);
@@ -15,6 +14,11 @@ FILE *openFile(char *baseDir, char *path, char *flags) {
     } else {
         strcpy(fullPath, path);
     }
+    return fullPath;
+}
+
+FILE *openFile(char *baseDir, char *path, char *flags) {
+    char *fullPath = joinPath(baseDir, path);
     FILE *newFile = fopen(fullPath, flags);
     if (newFile == NULL) {
         char stringErro[128];
@@ -6,6 +6,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Caminho de 'path' no diretório 'baseDir' (ou o próprio 'path' se for NULL), alocado
+char *joinPath(char *baseDir, char *path);
+
 // Abre o arquivo no diretório especificado
 FILE *openFile(char *baseDir, char *path, char *flags);
 
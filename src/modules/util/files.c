@@ -24,6 +24,7 @@ Files Files_Create() {
     files->ecFile = NULL;
     files->pmFile = NULL;
     files->viaFile = NULL;
+    files->baseDir[0] = '\0';
     files->outputDir = NULL;
     files->qrySVGFileName[0] = '\0';
     return files;
@@ -32,14 +33,20 @@ Files Files_Create() {
 bool Files_OpenQueryFiles(Files *filesVoid, char *baseDir, char *entryFileName, char *queryFileName) {
     FilesPtr files = (FilesPtr) filesVoid;
 
-    strcpy(files->baseDir, baseDir);
+    Files_SetBaseDir(filesVoid, baseDir);
 
-    char outputTXTFileName[64];
-	char outputQrySVGFileName[64];
     files->queryFile = openFile(baseDir, queryFileName, "r");
     if (files->queryFile == NULL)
         return false;
-    
+
+    return Files_OpenQueryOutputs(filesVoid, entryFileName, queryFileName);
+}
+
+bool Files_OpenQueryOutputs(Files *filesVoid, char *entryFileName, char *queryFileName) {
+    FilesPtr files = (FilesPtr) filesVoid;
+
+    char outputTXTFileName[64];
+	char outputQrySVGFileName[64];
     char noExtName[32];
     // Copiar nome completo do arquivo de consulta
     strcpy(noExtName, queryFileName);
@@ -112,6 +119,8 @@ FILE *Files_GetViaFile(Files filesVoid) {
 
 char *Files_GetBaseDir(Files filesVoid) {
     FilesPtr files = (FilesPtr) filesVoid;
+    if (files->baseDir[0] == '\0')
+        return NULL;
     return files->baseDir;
 }
 
@@ -165,6 +174,14 @@ void Files_SetViaFile(Files filesVoid, FILE *viaFile) {
     files->viaFile = viaFile;
 }
 
+void Files_SetBaseDir(Files filesVoid, char *baseDir) {
+    FilesPtr files = (FilesPtr) filesVoid;
+    if (baseDir != NULL)
+        strcpy(files->baseDir, baseDir);
+    else
+        files->baseDir[0] = '\0';
+}
+
 void Files_SetOutputDir(Files filesVoid, char *outputDir) {
     FilesPtr files = (FilesPtr) filesVoid;
     files->outputDir = outputDir;
@@ -14,6 +14,9 @@ Files Files_Create();
 
 bool Files_OpenQueryFiles(Files *files, char *baseDir, char *entryFileName, char *queryFileName);
 
+// Abre apenas os arquivos de saída (.txt e .svg) de uma consulta, sem abrir o arquivo de consulta
+bool Files_OpenQueryOutputs(Files *files, char *entryFileName, char *queryFileName);
+
 FILE *Files_GetEntryFile(Files files);
 
 FILE *Files_GetOutputSVGFile(Files files);
@@ -52,6 +55,8 @@ void Files_SetPmFile(Files files, FILE *pmFile);
 
 void Files_SetViaFile(Files files, FILE *viaFile);
 
+void Files_SetBaseDir(Files files, char *baseDir);
+
 void Files_SetOutputDir(Files files, char *outputDir);
 
 void Files_SetQrySVGFileName(Files files, char *svgFileName);
@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include <pthread.h>
+
+#include "line_parser.h"
+
+// Tamanho mínimo de cada bloco lido em paralelo, para que arquivos pequenos não paguem por threads
+#define LINE_PARSER_MIN_CHUNK (1 << 20)
+#define LINE_PARSER_MAX_THREADS 16
+
+typedef struct chunk_t {
+    char *begin, *end;
+    void (*parseLine)(char *line, RecordList *records);
+    RecordList records;
+    pthread_t thread;
+    bool threaded;
+} Chunk;
+
+void RecordList_Init(RecordList *list, size_t itemSize) {
+    list->items = NULL;
+    list->length = 0;
+    list->capacity = 0;
+    list->itemSize = itemSize;
+}
+
+static void _reserve(RecordList *list, int capacity) {
+    if (capacity <= list->capacity)
+        return;
+    if (list->capacity == 0)
+        list->capacity = 256;
+    while (list->capacity < capacity)
+        list->capacity *= 2;
+    list->items = realloc(list->items, list->capacity * list->itemSize);
+}
+
+void *RecordList_Append(RecordList *list) {
+    _reserve(list, list->length + 1);
+    void *record = (char *) list->items + list->length * list->itemSize;
+    list->length++;
+    return record;
+}
+
+void RecordList_Free(RecordList *list) {
+    free(list->items);
+    RecordList_Init(list, list->itemSize);
+}
+
+// Lê o restante do arquivo para a memória, terminado em '\0'
+static char *_readAll(FILE *file, size_t *size) {
+    size_t capacity = 1 << 16, length = 0;
+    char *text = malloc(capacity);
+    size_t read;
+    while ((read = fread(text + length, 1, capacity - length - 1, file)) > 0) {
+        length += read;
+        if (capacity - length - 1 == 0) {
+            capacity *= 2;
+            text = realloc(text, capacity);
+        }
+    }
+    if (ferror(file)) {
+        free(text);
+        return NULL;
+    }
+    text[length] = '\0';
+    *size = length;
+    return text;
+}
+
+static void *_parseChunk(void *chunkVoid) {
+    Chunk *chunk = (Chunk *) chunkVoid;
+    char *line = chunk->begin;
+    while (line < chunk->end) {
+        char *lineEnd = memchr(line, '\n', chunk->end - line);
+        if (lineEnd == NULL)
+            lineEnd = chunk->end;
+        *lineEnd = '\0';
+        chunk->parseLine(line, &chunk->records);
+        line = lineEnd + 1;
+    }
+    return NULL;
+}
+
+static int _chunkCount(size_t size) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1)
+        cores = 1;
+    if (cores > LINE_PARSER_MAX_THREADS)
+        cores = LINE_PARSER_MAX_THREADS;
+    size_t bySize = size / LINE_PARSER_MIN_CHUNK;
+    if (bySize < 1)
+        bySize = 1;
+    return bySize < (size_t) cores ? (int) bySize : (int) cores;
+}
+
+bool LineParser_ParseFile(FILE *file, void (*parseLine)(char *line, RecordList *records), RecordList *records) {
+    size_t size;
+    char *text = _readAll(file, &size);
+    if (text == NULL)
+        return false;
+
+    int nChunks = _chunkCount(size);
+    Chunk *chunks = malloc(nChunks * sizeof(Chunk));
+
+    // Cada bloco termina logo após um '\n' (ou no fim do texto), então nenhuma linha é dividida
+    char *begin = text, *textEnd = text + size;
+    for (int i = 0; i < nChunks; i++) {
+        char *end = textEnd;
+        if (i < nChunks - 1) {
+            char *target = text + size * (i + 1) / nChunks;
+            if (target < begin)
+                target = begin;
+            char *newline = memchr(target, '\n', textEnd - target);
+            end = newline != NULL ? newline + 1 : textEnd;
+        }
+        chunks[i].begin = begin;
+        chunks[i].end = end;
+        chunks[i].parseLine = parseLine;
+        RecordList_Init(&chunks[i].records, records->itemSize);
+        begin = end;
+    }
+
+    // O primeiro bloco fica com a thread atual
+    for (int i = 1; i < nChunks; i++)
+        chunks[i].threaded = pthread_create(&chunks[i].thread, NULL, _parseChunk, &chunks[i]) == 0;
+    chunks[0].threaded = false;
+    _parseChunk(&chunks[0]);
+    for (int i = 1; i < nChunks; i++) {
+        if (chunks[i].threaded)
+            pthread_join(chunks[i].thread, NULL);
+        else
+            _parseChunk(&chunks[i]);
+    }
+
+    int total = records->length;
+    for (int i = 0; i < nChunks; i++)
+        total += chunks[i].records.length;
+    _reserve(records, total);
+    for (int i = 0; i < nChunks; i++) {
+        if (chunks[i].records.length > 0)
+            memcpy((char *) records->items + records->length * records->itemSize, chunks[i].records.items,
+                   chunks[i].records.length * records->itemSize);
+        records->length += chunks[i].records.length;
+        RecordList_Free(&chunks[i].records);
+    }
+
+    free(chunks);
+    free(text);
+    return true;
+}
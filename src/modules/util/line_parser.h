@@ -0,0 +1,29 @@
+#ifndef LINE_PARSER_H
+#define LINE_PARSER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Vetor de registros de tamanho fixo ('itemSize' bytes), que cresce conforme necessário
+typedef struct record_list_t {
+    void *items;
+    int length, capacity;
+    size_t itemSize;
+} RecordList;
+
+void RecordList_Init(RecordList *list, size_t itemSize);
+
+// Acrescenta um registro ao fim do vetor, retornando-o para ser preenchido
+void *RecordList_Append(RecordList *list);
+
+void RecordList_Free(RecordList *list);
+
+// Lê o arquivo inteiro e chama 'parseLine' para cada linha (sem o '\n'). Arquivos grandes são
+// divididos em blocos, em fins de linha, lidos em paralelo para vetores próprios de cada bloco,
+// que depois são concatenados em 'records' na ordem do arquivo. 'parseLine' não pode depender de
+// estado compartilhado entre linhas. Retorna false se o arquivo não puder ser lido
+bool LineParser_ParseFile(FILE *file, void (*parseLine)(char *line, RecordList *records), RecordList *records);
+
+#endif
@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/stat.h>
+
+#include "polygon_cache.h"
+
+typedef struct cache_entry_t {
+    char *path;
+    struct timespec mtime;
+    off_t size;
+    Polygon polygon;
+    int users;                        // consultas que obtiveram o polígono e ainda não o liberaram
+    bool retired;                     // já fora da tabela, liberado pelo último usuário
+    struct cache_entry_t *prev, *next;
+} *CacheEntry;
+
+// Tabela por caminho e lista de todas as entradas (inclusive as retiradas ainda em uso), para
+// achar a entrada de um polígono em PolygonCache_Release
+static HashTable cache = NULL;
+static CacheEntry entries = NULL;
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void _destroyEntry(CacheEntry entry) {
+    if (entry->prev != NULL)
+        entry->prev->next = entry->next;
+    else
+        entries = entry->next;
+    if (entry->next != NULL)
+        entry->next->prev = entry->prev;
+    Polygon_Destroy(entry->polygon);
+    free(entry->path);
+    free(entry);
+}
+
+// Tira a entrada da tabela; se alguma consulta ainda usa o polígono, a liberação fica para ela
+static void _retire(CacheEntry entry) {
+    HashTable_Remove(cache, entry->path);
+    entry->retired = true;
+    if (entry->users == 0)
+        _destroyEntry(entry);
+}
+
+static Polygon _get(char *fullPath) {
+    struct stat info;
+    bool statOk = stat(fullPath, &info) == 0;
+
+    CacheEntry entry = HashTable_Find(cache, fullPath);
+    if (entry != NULL) {
+        if (statOk && entry->size == info.st_size
+                && entry->mtime.tv_sec == info.st_mtim.tv_sec
+                && entry->mtime.tv_nsec == info.st_mtim.tv_nsec) {
+            free(fullPath);
+            entry->users++;
+            return entry->polygon;
+        }
+        // Arquivo modificado: descartar a versão antiga
+        _retire(entry);
+    }
+
+    FILE *polyFile = fopen(fullPath, "r");
+    if (polyFile == NULL) {
+        char stringErro[128];
+        snprintf(stringErro, 128, "Erro ao abrir arquivo '%s'", fullPath);
+        perror(stringErro);
+        free(fullPath);
+        return NULL;
+    }
+
+    Polygon polygon = Polygon_Create();
+    Polygon_ReadFromFile(polygon, polyFile);
+    fclose(polyFile);
+    Polygon_Prepare(polygon);
+
+    entry = malloc(sizeof(struct cache_entry_t));
+    entry->path = fullPath;
+    if (statOk) {
+        entry->mtime = info.st_mtim;
+        entry->size = info.st_size;
+    } else {
+        // Sem informações do arquivo, a entrada é lida novamente no próximo acesso
+        entry->mtime.tv_sec = entry->mtime.tv_nsec = 0;
+        entry->size = -1;
+    }
+    entry->polygon = polygon;
+    entry->users = 1;
+    entry->retired = false;
+    entry->prev = NULL;
+    entry->next = entries;
+    if (entries != NULL)
+        entries->prev = entry;
+    entries = entry;
+    HashTable_Insert(cache, entry->path, entry);
+    return polygon;
+}
+
+Polygon PolygonCache_Get(char *baseDir, char *path) {
+    pthread_mutex_lock(&cacheLock);
+    if (cache == NULL)
+        cache = HashTable_Create(101);
+    Polygon polygon = _get(joinPath(baseDir, path));
+    pthread_mutex_unlock(&cacheLock);
+    return polygon;
+}
+
+void PolygonCache_Release(Polygon polygon) {
+    pthread_mutex_lock(&cacheLock);
+    CacheEntry entry = entries;
+    while (entry != NULL && entry->polygon != polygon)
+        entry = entry->next;
+    if (entry != NULL && --entry->users == 0 && entry->retired)
+        _destroyEntry(entry);
+    pthread_mutex_unlock(&cacheLock);
+}
+
+void PolygonCache_Invalidate(char *baseDir, char *path) {
+    pthread_mutex_lock(&cacheLock);
+    if (cache != NULL) {
+        char *fullPath = joinPath(baseDir, path);
+        CacheEntry entry = HashTable_Find(cache, fullPath);
+        if (entry != NULL)
+            _retire(entry);
+        free(fullPath);
+    }
+    pthread_mutex_unlock(&cacheLock);
+}
+
+void PolygonCache_Destroy() {
+    pthread_mutex_lock(&cacheLock);
+    if (cache != NULL) {
+        HashTable_Destroy(cache, NULL);
+        cache = NULL;
+    }
+    while (entries != NULL)
+        _destroyEntry(entries);
+    pthread_mutex_unlock(&cacheLock);
+}
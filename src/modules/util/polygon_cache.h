@@ -0,0 +1,31 @@
+#ifndef POLYGON_CACHE_H
+#define POLYGON_CACHE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "../aux/polygon.h"
+#include "../data_structures/hash_table.h"
+#include "file_util.h"
+
+// Retorna o polígono lido do arquivo 'path' (em 'baseDir'), já preparado para consultas.
+// O arquivo só é lido novamente se tiver sido modificado (data de modificação ou tamanho
+// diferentes). O polígono pertence ao cache e não deve ser destruído; fica válido até
+// PolygonCache_Release, mesmo que outra thread o troque ou descarte. Retorna NULL se o
+// arquivo não puder ser aberto. Todas as funções podem ser chamadas por várias threads
+Polygon PolygonCache_Get(char *baseDir, char *path);
+
+// Devolve um polígono obtido com PolygonCache_Get
+void PolygonCache_Release(Polygon polygon);
+
+// Descarta o polígono do arquivo 'path' (em 'baseDir'), se estiver no cache (quem ainda o usa
+// continua com ele até liberá-lo)
+void PolygonCache_Invalidate(char *baseDir, char *path);
+
+// Destrói todos os polígonos do cache
+void PolygonCache_Destroy();
+
+#endif
@@ -0,0 +1,264 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+#include <malloc.h>
+#include <pthread.h>
+
+#include "stats.h"
+
+// Quantidade de linhas mais lentas listadas no resumo
+#define STATS_SLOWEST 10
+
+// Tempos guardados por tipo de comando para os percentis. Até esse número de linhas os percentis
+// são exatos; depois, vêm de uma amostra uniforme (reservatório), para que um processo longo (modo
+// servidor) não guarde todas as linhas
+#define STATS_RESERVOIR 1024
+
+// Bytes em uso no heap de todo o processo; a diferença entre o início e o fim de uma linha é o
+// quanto ela deixou alocado, não o total de alocações. Só vale para linhas que não rodaram ao
+// mesmo tempo que outras (ver 'overlapped')
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define STATS_HEAP_IN_USE() ((long) mallinfo2().uordblks)
+#else
+#define STATS_HEAP_IN_USE() 0L
+#endif
+
+__thread long Stats_Visits = 0;
+
+typedef struct line_stats_t {
+    int lineNumber;
+    int type;
+    double ms;
+    long visits;
+    long heapDelta;
+    bool overlapped;  // outra linha rodou durante esta: a variação do heap não é só dela
+    char text[128];
+} LineStats;
+
+typedef struct type_stats_t {
+    char name[16];
+    int count;
+    double total;
+    double max;
+    long visits;
+    long heapDelta;
+    int overlapped;   // linhas sem variação do heap confiável
+    double *samples;  // até STATS_RESERVOIR tempos
+    int nSamples;
+} TypeStats;
+
+static bool enabled = false;
+
+// Protege os dados coletados, que podem vir de várias threads (modo servidor)
+static pthread_mutex_t statsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Linhas mais lentas, fora de ordem
+static LineStats slowest[STATS_SLOWEST];
+static int nSlowest = 0;
+
+static TypeStats *types = NULL;
+static int nTypes = 0, capTypes = 0;
+
+// Linhas em medição em todas as threads (inclusive as suspensas, que não são registradas) e
+// quantas já começaram, para saber se uma linha rodou sozinha
+static int activeLines = 0;
+static unsigned long startedLines = 0;
+
+// Gerador congruente linear do reservatório, determinístico
+static unsigned long long reservoirSeed = 7;
+
+// Linha sendo medida pela thread
+static __thread bool measuring = false, paused = false, recording = false;
+static __thread LineStats current;
+static __thread struct timespec start;
+static __thread long startVisits, startHeap;
+static __thread unsigned long startedBefore;
+
+void Stats_Enable() {
+    enabled = true;
+}
+
+bool Stats_IsEnabled() {
+    return enabled;
+}
+
+void Stats_SetPaused(bool isPaused) {
+    Stats_End();
+    paused = isPaused;
+}
+
+bool Stats_IsPaused() {
+    return paused;
+}
+
+static int _findType(char *name) {
+    for (int i = 0; i < nTypes; i++) {
+        if (strcmp(types[i].name, name) == 0)
+            return i;
+    }
+    if (nTypes == capTypes) {
+        capTypes = capTypes == 0 ? 32 : capTypes * 2;
+        types = realloc(types, capTypes * sizeof(TypeStats));
+    }
+    TypeStats *t = &types[nTypes];
+    strncpy(t->name, name, 15);
+    t->name[15] = '\0';
+    t->count = 0;
+    t->total = 0;
+    t->max = 0;
+    t->visits = 0;
+    t->heapDelta = 0;
+    t->overlapped = 0;
+    t->samples = malloc(STATS_RESERVOIR * sizeof(double));
+    t->nSamples = 0;
+    return nTypes++;
+}
+
+// Acumula a linha no seu tipo e, se estiver entre as mais lentas, guarda-a. Chamada com statsMutex
+static void _record(LineStats *l) {
+    TypeStats *t = &types[l->type];
+    t->count++;
+    t->total += l->ms;
+    if (l->ms > t->max)
+        t->max = l->ms;
+    t->visits += l->visits;
+    if (l->overlapped)
+        t->overlapped++;
+    else
+        t->heapDelta += l->heapDelta;
+
+    // Amostragem por reservatório: cada uma das 'count' linhas fica na amostra com a mesma chance
+    if (t->nSamples < STATS_RESERVOIR) {
+        t->samples[t->nSamples++] = l->ms;
+    } else {
+        reservoirSeed = reservoirSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsigned long j = (reservoirSeed >> 33) % t->count;
+        if (j < STATS_RESERVOIR)
+            t->samples[j] = l->ms;
+    }
+
+    if (nSlowest < STATS_SLOWEST) {
+        slowest[nSlowest++] = *l;
+        return;
+    }
+    int fastest = 0;
+    for (int i = 1; i < STATS_SLOWEST; i++) {
+        if (slowest[i].ms < slowest[fastest].ms)
+            fastest = i;
+    }
+    if (l->ms > slowest[fastest].ms)
+        slowest[fastest] = *l;
+}
+
+// Uma linha suspensa também é medida, sem ser registrada, para que as linhas que rodam ao mesmo
+// tempo que ela saibam que a variação do heap não é só delas
+void Stats_Begin(char *type, char *line, int lineNumber) {
+    if (!enabled)
+        return;
+    Stats_End();
+
+    LineStats *l = &current;
+    recording = !paused;
+    l->lineNumber = lineNumber;
+    pthread_mutex_lock(&statsMutex);
+    if (recording)
+        l->type = _findType(type);
+    l->overlapped = activeLines > 0;
+    activeLines++;
+    startedBefore = ++startedLines;
+    pthread_mutex_unlock(&statsMutex);
+    if (recording) {
+        snprintf(l->text, sizeof(l->text), "%s", line);
+        // Remover quebra de linha
+        int len = strlen(l->text);
+        if (len > 0 && l->text[len - 1] == '\n')
+            l->text[len - 1] = '\0';
+    }
+
+    measuring = true;
+    startHeap = STATS_HEAP_IN_USE();
+    startVisits = Stats_Visits;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+}
+
+void Stats_End() {
+    if (!measuring)
+        return;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    measuring = false;
+
+    LineStats *l = &current;
+    l->ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    l->visits = Stats_Visits - startVisits;
+    l->heapDelta = STATS_HEAP_IN_USE() - startHeap;
+
+    pthread_mutex_lock(&statsMutex);
+    activeLines--;
+    if (startedLines != startedBefore)
+        l->overlapped = true;
+    if (recording)
+        _record(l);
+    pthread_mutex_unlock(&statsMutex);
+}
+
+static int _compareDoubles(const void *a, const void *b) {
+    double d1 = *(double *) a, d2 = *(double *) b;
+    return d1 > d2 ? 1 : d1 < d2 ? -1 : 0;
+}
+
+static int _compareLinesDescending(const void *a, const void *b) {
+    double d1 = ((LineStats *) a)->ms, d2 = ((LineStats *) b)->ms;
+    return d1 < d2 ? 1 : d1 > d2 ? -1 : 0;
+}
+
+// Percentil pelo método do posto mais próximo, em um vetor ordenado
+static double _percentile(double *sorted, int n, double p) {
+    int rank = (int) (p * n + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    return sorted[rank - 1];
+}
+
+void Stats_Dump(FILE *file) {
+    if (!enabled)
+        return;
+    Stats_End();
+
+    fprintf(file, "%-10s %8s %12s %10s %10s %10s %12s %12s\n",
+            "comando", "qtd", "total(ms)", "p50(ms)", "p99(ms)", "max(ms)", "visitados", "var.heap(B)");
+
+    pthread_mutex_lock(&statsMutex);
+    char heap[24];
+    for (int i = 0; i < nTypes; i++) {
+        TypeStats *t = &types[i];
+        if (t->count == 0)
+            continue;
+        qsort(t->samples, t->nSamples, sizeof(double), _compareDoubles);
+        if (t->overlapped > 0)
+            strcpy(heap, "-");
+        else
+            sprintf(heap, "%ld", t->heapDelta);
+        fprintf(file, "%-10s %8d %12.3lf %10.3lf %10.3lf %10.3lf %12ld %12s\n",
+                t->name, t->count, t->total, _percentile(t->samples, t->nSamples, 0.5),
+                _percentile(t->samples, t->nSamples, 0.99), t->max, t->visits, heap);
+    }
+
+    qsort(slowest, nSlowest, sizeof(LineStats), _compareLinesDescending);
+    fprintf(file, "\nLinhas mais lentas:\n");
+    for (int i = 0; i < nSlowest; i++) {
+        if (slowest[i].overlapped)
+            strcpy(heap, "-");
+        else
+            sprintf(heap, "%ld", slowest[i].heapDelta);
+        fprintf(file, "%6d: %10.3lf ms %10ld visitados %10s B no heap | %s\n",
+                slowest[i].lineNumber, slowest[i].ms, slowest[i].visits, heap, slowest[i].text);
+    }
+
+    for (int i = 0; i < nTypes; i++)
+        free(types[i].samples);
+    free(types);
+    types = NULL;
+    nSlowest = nTypes = capTypes = 0;
+    pthread_mutex_unlock(&statsMutex);
+}
@@ -0,0 +1,41 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Contador de entidades visitadas (incrementado pelas estruturas de dados), um por thread
+extern __thread long Stats_Visits;
+
+#define STATS_VISIT() (Stats_Visits++)
+
+// Ativa a coleta de estatísticas
+void Stats_Enable();
+
+bool Stats_IsEnabled();
+
+// Suspende (ou retoma) a coleta na thread atual, terminando a medição em andamento. Usado para
+// trabalho repetido que não deve contar duas vezes, como o das réplicas do modo servidor. As linhas
+// suspensas não são registradas, mas ainda contam como concorrentes para a variação do heap
+void Stats_SetPaused(bool paused);
+
+bool Stats_IsPaused();
+
+// Começa a medir uma linha (de um comando do tipo 'type'). Termina a medição anterior, se houver.
+// A medição é feita por thread
+void Stats_Begin(char *type, char *line, int lineNumber);
+
+// Termina a medição da linha atual, registrando tempo, entidades visitadas e a variação
+// líquida do heap em uso (o que foi alocado e liberado na linha não conta). O heap é o do
+// processo inteiro: se outra linha rodou ao mesmo tempo (modo servidor, leituras em paralelo),
+// a variação não é registrada e aparece como "-" no resumo
+void Stats_End();
+
+// Escreve o resumo por tipo de comando (quantidade, total, p50, p99) e as linhas mais lentas,
+// liberando os dados coletados. Só as linhas mais lentas são guardadas; os percentis de um tipo com
+// mais de 1024 linhas são estimados por amostragem
+void Stats_Dump(FILE *file);
+
+#endif
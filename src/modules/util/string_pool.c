@@ -0,0 +1,107 @@
+#include <pthread.h>
+
+#include "string_pool.h"
+
+// O conjunto é dividido em partes pelo hash, cada uma com sua trava, para que as threads de
+// leitura dos arquivos raramente esperem umas pelas outras. Cada parte é uma tabela de
+// espalhamento com endereçamento aberto, dobrada quando passa de metade da capacidade
+#define STRING_POOL_SHARDS 64
+#define STRING_POOL_INITIAL_CAPACITY 64
+
+typedef struct shard_t {
+    char **slots;
+    int capacity;
+    int length;
+    pthread_mutex_t mutex;
+} Shard;
+
+static Shard shards[STRING_POOL_SHARDS];
+static pthread_once_t shardsOnce = PTHREAD_ONCE_INIT;
+
+static void _initShards() {
+    for (int s = 0; s < STRING_POOL_SHARDS; s++) {
+        shards[s].slots = NULL;
+        shards[s].capacity = 0;
+        shards[s].length = 0;
+        pthread_mutex_init(&shards[s].mutex, NULL);
+    }
+}
+
+static unsigned long _hash(char *string) {
+    unsigned long hash = 5381;
+    for (unsigned char *c = (unsigned char *) string; *c != '\0'; c++)
+        hash = hash * 33 + *c;
+    return hash;
+}
+
+// Posição de 'string' em 'table', ou da vaga onde ela deveria estar. O resto da divisão do hash
+// escolhe a parte; o quociente, a posição dentro dela
+static int _findSlot(char **table, int tableCapacity, char *string, unsigned long hash) {
+    int i = (hash / STRING_POOL_SHARDS) & (tableCapacity - 1);
+    while (table[i] != NULL && strcmp(table[i], string) != 0)
+        i = (i + 1) & (tableCapacity - 1);
+    return i;
+}
+
+static void _grow(Shard *shard) {
+    int newCapacity = shard->capacity == 0 ? STRING_POOL_INITIAL_CAPACITY : shard->capacity * 2;
+    char **newSlots = calloc(newCapacity, sizeof(char *));
+    for (int i = 0; i < shard->capacity; i++) {
+        char *string = shard->slots[i];
+        if (string != NULL)
+            newSlots[_findSlot(newSlots, newCapacity, string, _hash(string))] = string;
+    }
+    free(shard->slots);
+    shard->slots = newSlots;
+    shard->capacity = newCapacity;
+}
+
+char *StringPool_Intern(char *string) {
+    pthread_once(&shardsOnce, _initShards);
+    unsigned long hash = _hash(string);
+    Shard *shard = &shards[hash % STRING_POOL_SHARDS];
+
+    pthread_mutex_lock(&shard->mutex);
+    if ((shard->length + 1) * 2 > shard->capacity)
+        _grow(shard);
+
+    int i = _findSlot(shard->slots, shard->capacity, string, hash);
+    if (shard->slots[i] == NULL) {
+        shard->slots[i] = malloc((strlen(string) + 1) * sizeof(char));
+        strcpy(shard->slots[i], string);
+        shard->length++;
+    }
+    char *interned = shard->slots[i];
+    pthread_mutex_unlock(&shard->mutex);
+    return interned;
+}
+
+char *StringPool_Find(char *string) {
+    pthread_once(&shardsOnce, _initShards);
+    unsigned long hash = _hash(string);
+    Shard *shard = &shards[hash % STRING_POOL_SHARDS];
+
+    pthread_mutex_lock(&shard->mutex);
+    char *interned = NULL;
+    if (shard->capacity > 0)
+        interned = shard->slots[_findSlot(shard->slots, shard->capacity, string, hash)];
+    pthread_mutex_unlock(&shard->mutex);
+    return interned;
+}
+
+void StringPool_Destroy() {
+    pthread_once(&shardsOnce, _initShards);
+    for (int s = 0; s < STRING_POOL_SHARDS; s++) {
+        Shard *shard = &shards[s];
+        pthread_mutex_lock(&shard->mutex);
+        for (int i = 0; i < shard->capacity; i++) {
+            if (shard->slots[i] != NULL)
+                free(shard->slots[i]);
+        }
+        free(shard->slots);
+        shard->slots = NULL;
+        shard->capacity = 0;
+        shard->length = 0;
+        pthread_mutex_unlock(&shard->mutex);
+    }
+}
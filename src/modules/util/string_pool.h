@@ -0,0 +1,21 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <stdlib.h>
+#include <string.h>
+
+// Conjunto global de strings compartilhadas (cores, espessuras de borda, nomes de rua...), que se
+// repetem muito entre os elementos da cidade. Pode ser usado por várias threads ao mesmo tempo;
+// strings em partes diferentes do conjunto não disputam a mesma trava
+
+// Retorna a cópia compartilhada de 'string', criando-a na primeira vez. O resultado vale até
+// StringPool_Destroy e não deve ser alterado nem liberado; strings iguais retornam o mesmo ponteiro
+char *StringPool_Intern(char *string);
+
+// Retorna a cópia compartilhada de 'string' se ela já existir, NULL caso contrário
+char *StringPool_Find(char *string);
+
+// Libera todas as strings do conjunto
+void StringPool_Destroy();
+
+#endif
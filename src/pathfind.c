@@ -5,10 +5,38 @@
 
 typedef struct stack_item_t {
     GraphNode node;
+    char *streetName;
     struct stack_item_t *next;
     struct stack_item_t *base;
 } *StackItem;
 
+// Estado de uma busca, indexado por GraphNode_GetIndex. Fica fora dos vértices para que buscas
+// simultâneas na mesma cidade não interfiram entre si
+typedef struct search_t {
+    int size;
+    double *distance;
+    GraphNode *parent;
+    char **streetName;
+} Search;
+
+static void _createSearch(City city, Search *search) {
+    search->size = City_GetNodeCount(city);
+    search->distance = malloc(search->size * sizeof(double));
+    search->parent = malloc(search->size * sizeof(GraphNode));
+    search->streetName = malloc(search->size * sizeof(char *));
+    for (int i = 0; i < search->size; i++) {
+        search->distance[i] = INFINITY;
+        search->parent[i] = NULL;
+        search->streetName[i] = NULL;
+    }
+}
+
+static void _destroySearch(Search *search) {
+    free(search->distance);
+    free(search->parent);
+    free(search->streetName);
+}
+
 static GraphNode _findClosestNode(RBTree tree, Node node, double x, double y, double *minDist) {
     if (node == NULL)
         return NULL;
@@ -21,8 +49,14 @@ static GraphNode _findClosestNode(RBTree tree, Node node, double x, double y, do
         distSet = true;
     }
 
-    GraphNode closestLeft = _findClosestNode(tree, RBTreeN_GetLeftChild(tree, node), x, y, minDist);
-    GraphNode closestRight = _findClosestNode(tree, RBTreeN_GetRightChild(tree, node), x, y, minDist);
+    // A árvore é ordenada por x: uma subárvore inteira do outro lado de uma distância horizontal
+    // já maior ou igual à menor encontrada não tem vértice mais próximo
+    double dx = x - GraphNode_GetX(currentNode);
+    GraphNode closestLeft = NULL, closestRight = NULL;
+    if (dx < *minDist)
+        closestLeft = _findClosestNode(tree, RBTreeN_GetLeftChild(tree, node), x, y, minDist);
+    if (-dx < *minDist)
+        closestRight = _findClosestNode(tree, RBTreeN_GetRightChild(tree, node), x, y, minDist);
 
     if (closestRight != NULL)
         return closestRight;
@@ -33,35 +67,172 @@ static GraphNode _findClosestNode(RBTree tree, Node node, double x, double y, do
     return NULL;
 }
 
-static void _resetNode(GraphNode node, void *v) {
-    GraphNode_SetDistance(node, INFINITY);
-    GraphNode_SetParent(node, NULL);
-    GraphNode_SetClosed(node, false);
+// Relaxa as arestas de 'node' na busca 'search': para frente pelas arestas que saem dele, para trás
+// pelas que chegam (na busca para trás, 'parent' é o próximo vértice rumo ao destino). Cada vértice
+// alcançado também pela outra busca é candidato a ponto de encontro
+static void _relax(Search *search, Search *other, IndexHeap heap, GraphNode *nodes, GraphNode node, double distance,
+                   bool backward, bool quickest, double *best, GraphNode *meet) {
+    GraphEdge first = backward ? GraphNode_GetFirstInEdge(node) : GraphNode_GetFirstEdge(node);
+    for (GraphEdge edge = first; edge != NULL; edge = GraphEdge_GetNext(edge)) {
+        double newDistance = distance + GraphEdge_GetCost(edge, !quickest);
+        GraphNode neighbor = backward ? GraphEdge_GetSource(edge) : GraphEdge_GetTarget(edge);
+        int index = GraphNode_GetIndex(neighbor);
+        if (isfinite(newDistance) && newDistance < search->distance[index]) {
+            search->distance[index] = newDistance;
+            search->parent[index] = node;
+            search->streetName[index] = GraphEdge_GetName(edge);
+            nodes[index] = neighbor;
+            IndexHeap_Push(heap, index, newDistance);
+            if (newDistance + other->distance[index] < *best) {
+                *best = newDistance + other->distance[index];
+                *meet = neighbor;
+            }
+        }
+    }
 }
 
-static bool _dijkstra(GraphNode start, GraphNode end, bool quickest) {
-    RBTree_Execute(getNodeTree(), _resetNode, NULL);
-    GraphNode_SetDistance(start, 0);
+// Dijkstra bidirecional de 'start' até 'end': uma busca para frente a partir de 'start' e outra para
+// trás a partir de 'end', avançando sempre a de menor chave, até que a soma das menores chaves das
+// duas alcance o melhor caminho já encontrado. Não depende de pré-processamento, então vale logo
+// após ruas serem bloqueadas. Ao final, o caminho inteiro fica nos pais de 'forward'
+static bool _dijkstra(Search *forward, Search *backward, GraphNode start, GraphNode end, bool quickest) {
+    GraphNode *nodes = malloc(forward->size * sizeof(GraphNode));
+    IndexHeap forwardHeap = IndexHeap_Create(forward->size);
+    IndexHeap backwardHeap = IndexHeap_Create(forward->size);
+
+    int startIndex = GraphNode_GetIndex(start), endIndex = GraphNode_GetIndex(end);
+    nodes[startIndex] = start;
+    nodes[endIndex] = end;
+    forward->distance[startIndex] = 0;
+    backward->distance[endIndex] = 0;
+    IndexHeap_Push(forwardHeap, startIndex, 0);
+    IndexHeap_Push(backwardHeap, endIndex, 0);
+
+    double best = start == end ? 0 : INFINITY;
+    GraphNode meet = start == end ? start : NULL;
+    while (true) {
+        double forwardKey = IndexHeap_PeekKey(forwardHeap);
+        double backwardKey = IndexHeap_PeekKey(backwardHeap);
+        // Nenhum caminho ainda não visto pode ser menor que 'best' (ou uma das buscas se esgotou)
+        if (forwardKey + backwardKey >= best)
+            break;
+
+        STATS_VISIT();
+        double distance;
+        if (forwardKey <= backwardKey) {
+            GraphNode node = nodes[IndexHeap_Extract(forwardHeap, &distance)];
+            _relax(forward, backward, forwardHeap, nodes, node, distance, false, quickest, &best, &meet);
+        } else {
+            GraphNode node = nodes[IndexHeap_Extract(backwardHeap, &distance)];
+            _relax(backward, forward, backwardHeap, nodes, node, distance, true, quickest, &best, &meet);
+        }
+    }
 
-    BinaryHeap heap = BinHeap_Create(RBTree_GetLength(getNodeTree()), GraphNode_CompareAsc);
-    BinHeap_Insert(heap, start);
+    IndexHeap_Destroy(forwardHeap);
+    IndexHeap_Destroy(backwardHeap);
+    free(nodes);
+    if (meet == NULL)
+        return false;
+
+    // Continua os pais da busca para frente pelo trecho encontrado na busca para trás
+    GraphNode current = meet;
+    while (current != end) {
+        int index = GraphNode_GetIndex(current);
+        GraphNode next = backward->parent[index];
+        forward->parent[GraphNode_GetIndex(next)] = current;
+        forward->streetName[GraphNode_GetIndex(next)] = backward->streetName[index];
+        current = next;
+    }
+    return true;
+}
 
-    while (!BinHeap_IsEmpty(heap)) {
-        GraphNode currentNode = BinHeap_Extract(heap);
-        GraphNode_CollectNeighbors(currentNode, heap, !quickest);
+// A* de 'start' até 'end' com limites inferiores dos marcos (ALT) como heurística. Os limites são
+// consistentes, então cada vértice é fechado uma única vez
+static bool _astar(Search *search, Landmarks landmarks, GraphNode start, GraphNode end, bool quickest) {
+    GraphNode *nodes = malloc(search->size * sizeof(GraphNode));
+    IndexHeap heap = IndexHeap_Create(search->size);
+
+    int startIndex = GraphNode_GetIndex(start);
+    nodes[startIndex] = start;
+    search->distance[startIndex] = 0;
+    IndexHeap_Push(heap, startIndex, Landmarks_LowerBound(landmarks, start, end, !quickest));
+
+    bool found = false;
+    while (!IndexHeap_IsEmpty(heap)) {
+        GraphNode currentNode = nodes[IndexHeap_Extract(heap, NULL)];
+        STATS_VISIT();
+        if (currentNode == end) {
+            found = true;
+            break;
+        }
+
+        double distance = search->distance[GraphNode_GetIndex(currentNode)];
+        for (GraphEdge edge = GraphNode_GetFirstEdge(currentNode); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double newDistance = distance + GraphEdge_GetCost(edge, !quickest);
+            GraphNode neighbor = GraphEdge_GetTarget(edge);
+            int index = GraphNode_GetIndex(neighbor);
+            if (!isfinite(newDistance) || newDistance >= search->distance[index])
+                continue;
+            // Limite infinito: o destino não é alcançável a partir do vizinho
+            double bound = Landmarks_LowerBound(landmarks, neighbor, end, !quickest);
+            if (!isfinite(bound))
+                continue;
+            search->distance[index] = newDistance;
+            search->parent[index] = currentNode;
+            search->streetName[index] = GraphEdge_GetName(edge);
+            nodes[index] = neighbor;
+            IndexHeap_Push(heap, index, newDistance + bound);
+        }
     }
 
-    BinHeap_Destroy(heap);
+    IndexHeap_Destroy(heap);
+    free(nodes);
+    return found;
+}
+
+// Caminho de 'start' até 'end', deixado nos pais de 'search': pela árvore de caminhos de 'start' no
+// cache, se houver (obtida em 'tree' até _endRoute), ou por uma busca própria de 'search': pelo
+// índice de partição, A* com marcos, se a cidade os tiver calculado, ou Dijkstra bidirecional
+static bool _route(City city, Search *search, PathTree *tree, GraphNode start, GraphNode end, bool quickest) {
+    *tree = PathTreeCache_Acquire(City_GetPathTreeCache(city), City_GetNodeCount(city), start, quickest,
+                                  City_GetGraphVersion(city));
+    if (*tree != NULL) {
+        search->size = City_GetNodeCount(city);
+        search->distance = PathTree_GetDistances(*tree);
+        search->parent = PathTree_GetParents(*tree);
+        search->streetName = PathTree_GetStreetNames(*tree);
+        return PathTree_Reach(*tree, end);
+    }
 
-    return GraphNode_IsClosed(end);
+    _createSearch(city, search);
+    RoutePartition partition = City_GetRoutePartition(city);
+    if (partition != NULL)
+        return RoutePartition_Route(partition, start, end, quickest, search->distance, search->parent,
+                                    search->streetName);
+    Landmarks landmarks = City_GetLandmarks(city);
+    if (landmarks != NULL)
+        return _astar(search, landmarks, start, end, quickest);
+
+    Search backward;
+    _createSearch(city, &backward);
+    bool found = _dijkstra(search, &backward, start, end, quickest);
+    _destroySearch(&backward);
+    return found;
 }
 
-static StackItem backtrace(GraphNode start, GraphNode end, FILE *svgFile, char color[], bool quickest, bool noWrite) {
+static void _endRoute(City city, Search *search, PathTree tree) {
+    if (tree != NULL)
+        PathTreeCache_Release(City_GetPathTreeCache(city), tree);
+    else
+        _destroySearch(search);
+}
+
+static StackItem backtrace(Search *search, GraphNode start, GraphNode end, FILE *svgFile, char color[], bool quickest, bool noWrite) {
     GraphNode currentNode = end;
     StackItem stackTop = NULL;
     StackItem stackBase = NULL;
     while (currentNode != start) {
-        GraphNode parent = GraphNode_GetParent(currentNode);
+        GraphNode parent = search->parent[GraphNode_GetIndex(currentNode)];
 
         if (!noWrite)
             putSVGPath(svgFile, GraphNode_GetX(parent), GraphNode_GetY(parent),
@@ -73,6 +244,7 @@ static StackItem backtrace(GraphNode start, GraphNode end, FILE *svgFile, char c
             stackBase = newItem;
         newItem->next = stackTop;
         newItem->node = currentNode;
+        newItem->streetName = search->streetName[GraphNode_GetIndex(currentNode)];
         newItem->base = stackBase;
         stackTop = newItem;
 
@@ -82,6 +254,7 @@ static StackItem backtrace(GraphNode start, GraphNode end, FILE *svgFile, char c
     StackItem newItem = malloc(sizeof(struct stack_item_t));
     newItem->next = stackTop;
     newItem->node = start;
+    newItem->streetName = NULL;
     newItem->base = stackBase == NULL ? newItem : stackBase;
     stackTop = newItem;
 
@@ -95,8 +268,8 @@ static void putPathText(StackItem stackTop, FILE *txtFile, bool quickest, bool f
     double currentDistance = 0;
     while (stackTop->next != NULL) {
         currentNode = stackTop->node;
-        //printf("%s: %s\n", GraphNode_GetStreetName(currentNode), GraphNode_GetId(currentNode));
         GraphNode nextNode = stackTop->next->node;
+        char *streetName = stackTop->next->streetName;
         char newDir;
         double dx = GraphNode_GetX(nextNode) - GraphNode_GetX(currentNode);
         double dy = GraphNode_GetY(nextNode) - GraphNode_GetY(currentNode);
@@ -119,7 +292,7 @@ static void putPathText(StackItem stackTop, FILE *txtFile, bool quickest, bool f
             currentDistance = dist;
             fprintf(txtFile, "Siga a %s na rua %s",
                 direction(newDir),
-                GraphNode_GetStreetName(nextNode));
+                streetName);
         } else if (newDir != lastDir) {
             fprintf(txtFile, " por %.0lf metros", currentDistance);
             currentDistance = 0;
@@ -127,10 +300,10 @@ static void putPathText(StackItem stackTop, FILE *txtFile, bool quickest, bool f
                     || lastDir == 'N' && newDir == 'S' || lastDir == 'S' && newDir == 'N') {
                 fprintf(txtFile, " e faça o retorno. \nSiga a %s na rua %s", 
                     direction(newDir),
-                    GraphNode_GetStreetName(nextNode));
+                    streetName);
             } else {
                 fprintf(txtFile, " até o cruzamento com a rua %s. \nVire na direção %s e siga",
-                    GraphNode_GetStreetName(nextNode),
+                    streetName,
                     direction(newDir));
             }
         } else {
@@ -149,30 +322,300 @@ static void putPathText(StackItem stackTop, FILE *txtFile, bool quickest, bool f
         free(stackTop);
 }
 
-PathStack fullPathFind(GraphNode start, GraphNode end, FILE *svgFile, FILE *txtFile, char color[], bool quickest, bool freeStack) {
+PathStack fullPathFind(City city, GraphNode start, GraphNode end, FILE *svgFile, FILE *txtFile, char color[], bool quickest, bool freeStack) {
     fprintf(txtFile, "CAMINHO MAIS %s:\n", quickest ? "RÁPIDO" : "CURTO");
-    if (_dijkstra(start, end, quickest)) {
-        StackItem stackTop = backtrace(start, end, svgFile, color, quickest, false);
+    Search search;
+    PathTree tree;
+    StackItem stackTop = NULL;
+    if (_route(city, &search, &tree, start, end, quickest)) {
+        stackTop = backtrace(&search, start, end, svgFile, color, quickest, false);
         putPathText(stackTop, txtFile, quickest, freeStack);
-        return stackTop;
     } else {
         fprintf(txtFile, "Caminho não encontrado\n\n");
     }
-    return NULL;
+    _endRoute(city, &search, tree);
+    return stackTop;
+}
+
+void findDistances(City city, GraphNode start, GraphNode targets[], int count, bool quickest, double distances[]) {
+    int threads = City_GetSearchThreads(city);
+    if (threads > 0) {
+        // Árvore completa em paralelo, sem parada antecipada
+        int size = City_GetNodeCount(city);
+        double *distance = malloc(size * sizeof(double));
+        DeltaStepping_Run(size, &start, 1, quickest, false, INFINITY, threads, distance, NULL);
+        for (int i = 0; i < count; i++)
+            distances[i] = targets[i] != NULL ? distance[GraphNode_GetIndex(targets[i])] : INFINITY;
+        free(distance);
+        return;
+    }
+
+    Search search;
+    _createSearch(city, &search);
+    GraphNode *nodes = malloc(search.size * sizeof(GraphNode));
+    IndexHeap heap = IndexHeap_Create(search.size);
+
+    // Quantos destinos há em cada vértice, e quantos vértices de destino ainda não foram fechados
+    int *pending = calloc(search.size, sizeof(int));
+    int remaining = 0;
+    for (int i = 0; i < count; i++) {
+        if (targets[i] != NULL && pending[GraphNode_GetIndex(targets[i])]++ == 0)
+            remaining++;
+    }
+
+    int startIndex = GraphNode_GetIndex(start);
+    nodes[startIndex] = start;
+    search.distance[startIndex] = 0;
+    IndexHeap_Push(heap, startIndex, 0);
+
+    while (remaining > 0 && !IndexHeap_IsEmpty(heap)) {
+        double distance;
+        int index = IndexHeap_Extract(heap, &distance);
+        STATS_VISIT();
+        if (pending[index] > 0)
+            remaining--;
+
+        for (GraphEdge edge = GraphNode_GetFirstEdge(nodes[index]); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double newDistance = distance + GraphEdge_GetCost(edge, !quickest);
+            GraphNode neighbor = GraphEdge_GetTarget(edge);
+            int neighborIndex = GraphNode_GetIndex(neighbor);
+            if (isfinite(newDistance) && newDistance < search.distance[neighborIndex]) {
+                search.distance[neighborIndex] = newDistance;
+                nodes[neighborIndex] = neighbor;
+                IndexHeap_Push(heap, neighborIndex, newDistance);
+            }
+        }
+    }
+
+    // A busca só para antes de esgotar o heap quando todos os destinos foram fechados; se esgotou,
+    // os destinos restantes são inalcançáveis e ficaram com INFINITY
+    for (int i = 0; i < count; i++)
+        distances[i] = targets[i] != NULL ? search.distance[GraphNode_GetIndex(targets[i])] : INFINITY;
+
+    free(pending);
+    IndexHeap_Destroy(heap);
+    free(nodes);
+    _destroySearch(&search);
 }
 
-GraphNode findClosestNodeToPoint(Point point) {
+typedef struct reached_t {
+    GraphNode node;
+    double distance;
+} Reached;
+
+static int _compareReached(const void *a, const void *b) {
+    const Reached *ra = a, *rb = b;
+    if (ra->distance != rb->distance)
+        return ra->distance < rb->distance ? -1 : 1;
+    return GraphNode_GetIndex(ra->node) - GraphNode_GetIndex(rb->node);
+}
+
+// Ordena os vértices alcançados por custo e, nos empates, por índice, para que a ordem não dependa
+// de como a busca foi feita
+static void _sortReached(GraphNode nodes[], double distances[], int length) {
+    Reached *reached = malloc((length > 0 ? length : 1) * sizeof(Reached));
+    for (int i = 0; i < length; i++)
+        reached[i] = (Reached) {nodes[i], distances[i]};
+    qsort(reached, length, sizeof(Reached), _compareReached);
+    for (int i = 0; i < length; i++) {
+        nodes[i] = reached[i].node;
+        distances[i] = reached[i].distance;
+    }
+    free(reached);
+}
+
+// findReachable por delta-stepping; os vértices saem em ordem de índice
+static GraphNode *_findReachableParallel(City city, GraphNode start, double budget, bool quickest, int threads,
+                                         int *length, double **distancesOut) {
+    int size = City_GetNodeCount(city);
+    double *distance = malloc(size * sizeof(double));
+    GraphEdge *via = malloc(size * sizeof(GraphEdge));
+    DeltaStepping_Run(size, &start, 1, quickest, false, budget, threads, distance, via);
+
+    GraphNode *nodes = malloc((size > 0 ? size : 1) * sizeof(GraphNode));
+    double *reachedDistances = malloc((size > 0 ? size : 1) * sizeof(double));
+    *length = 0;
+    for (int i = 0; i < size; i++) {
+        if (isfinite(distance[i])) {
+            nodes[*length] = via[i] != NULL ? GraphEdge_GetTarget(via[i]) : start;
+            reachedDistances[(*length)++] = distance[i];
+        }
+    }
+    free(via);
+    free(distance);
+    *distancesOut = reachedDistances;
+    return nodes;
+}
+
+// findReachable por Dijkstra, parando no limite
+static GraphNode *_findReachableSequential(City city, GraphNode start, double budget, bool quickest, int *length,
+                                           double **distancesOut) {
+    Search search;
+    _createSearch(city, &search);
+    GraphNode *nodes = malloc(search.size * sizeof(GraphNode));
+    IndexHeap heap = IndexHeap_Create(search.size);
+    GraphNode *reached = malloc(16 * sizeof(GraphNode));
+    double *reachedDistances = malloc(16 * sizeof(double));
+    int capacity = 16;
+    *length = 0;
+
+    int startIndex = GraphNode_GetIndex(start);
+    nodes[startIndex] = start;
+    search.distance[startIndex] = 0;
+    IndexHeap_Push(heap, startIndex, 0);
+
+    // Só entram no heap vértices dentro do limite, então a busca não passa da área alcançável
+    while (!IndexHeap_IsEmpty(heap)) {
+        double distance;
+        int index = IndexHeap_Extract(heap, &distance);
+        STATS_VISIT();
+        if (*length == capacity) {
+            capacity *= 2;
+            reached = realloc(reached, capacity * sizeof(GraphNode));
+            reachedDistances = realloc(reachedDistances, capacity * sizeof(double));
+        }
+        reached[*length] = nodes[index];
+        reachedDistances[(*length)++] = distance;
+
+        for (GraphEdge edge = GraphNode_GetFirstEdge(nodes[index]); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            double newDistance = distance + GraphEdge_GetCost(edge, !quickest);
+            GraphNode neighbor = GraphEdge_GetTarget(edge);
+            int neighborIndex = GraphNode_GetIndex(neighbor);
+            if (newDistance <= budget && newDistance < search.distance[neighborIndex]) {
+                search.distance[neighborIndex] = newDistance;
+                nodes[neighborIndex] = neighbor;
+                IndexHeap_Push(heap, neighborIndex, newDistance);
+            }
+        }
+    }
+
+    IndexHeap_Destroy(heap);
+    free(nodes);
+    _destroySearch(&search);
+    *distancesOut = reachedDistances;
+    return reached;
+}
+
+GraphNode *findReachable(City city, GraphNode start, double budget, bool quickest, double **distances, int *length) {
+    GraphNode *reached;
+    double *reachedDistances;
+    int threads = City_GetSearchThreads(city);
+    if (threads > 0)
+        reached = _findReachableParallel(city, start, budget, quickest, threads, length, &reachedDistances);
+    else
+        reached = _findReachableSequential(city, start, budget, quickest, length, &reachedDistances);
+
+    // O Dijkstra já sai em ordem de custo, mas com os empates na ordem do heap
+    _sortReached(reached, reachedDistances, *length);
+    if (distances != NULL)
+        *distances = reachedDistances;
+    else
+        free(reachedDistances);
+    return reached;
+}
+
+typedef struct inside_job_t {
+    Polygon polygon;
+    bool *inside;
+    GraphNode *nodes;
+} InsideJob;
+
+static void _markInside(Value node, void *jobVoid) {
+    InsideJob *job = (InsideJob *) jobVoid;
+    double x = GraphNode_GetX(node), y = GraphNode_GetY(node);
+    int index = GraphNode_GetIndex(node);
+    job->nodes[index] = node;
+    job->inside[index] = x >= Polygon_GetMinX(job->polygon) && x <= Polygon_GetMaxX(job->polygon)
+                         && y >= Polygon_GetMinY(job->polygon) && y <= Polygon_GetMaxY(job->polygon)
+                         && Polygon_IsPointInside(job->polygon, x, y);
+}
+
+void findExits(City city, Polygon polygon, GraphNode next[], double distance[]) {
+    int size = City_GetNodeCount(city);
+    InsideJob job = {polygon, calloc(size, sizeof(bool)), calloc(size, sizeof(GraphNode))};
+    RBTree_Execute(City_GetNodeTree(city), _markInside, &job);
+
+    // Vértices de fora já estão salvos; as origens da busca são os que têm aresta vinda de dentro
+    IndexHeap heap = IndexHeap_Create(size);
+    for (int i = 0; i < size; i++) {
+        next[i] = NULL;
+        distance[i] = job.nodes[i] != NULL && !job.inside[i] ? 0 : INFINITY;
+    }
+    for (int i = 0; i < size; i++) {
+        if (job.nodes[i] == NULL || job.inside[i])
+            continue;
+        for (GraphEdge edge = GraphNode_GetFirstInEdge(job.nodes[i]); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            if (job.inside[GraphNode_GetIndex(GraphEdge_GetSource(edge))]) {
+                IndexHeap_Push(heap, i, 0);
+                break;
+            }
+        }
+    }
+
+    // Para trás, só por vértices de dentro: o primeiro vértice de fora de qualquer caminho que sai é
+    // uma das origens. As arestas de dentro foram fechadas pelo brn, então o bloqueio é ignorado
+    while (!IndexHeap_IsEmpty(heap)) {
+        double current;
+        int index = IndexHeap_Extract(heap, &current);
+        STATS_VISIT();
+        GraphNode node = job.nodes[index];
+        for (GraphEdge edge = GraphNode_GetFirstInEdge(node); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            GraphNode neighbor = GraphEdge_GetSource(edge);
+            int neighborIndex = GraphNode_GetIndex(neighbor);
+            double newDistance = current + GraphEdge_GetUnblockedCost(edge, true);
+            if (job.inside[neighborIndex] && newDistance < distance[neighborIndex]) {
+                distance[neighborIndex] = newDistance;
+                next[neighborIndex] = node;
+                IndexHeap_Push(heap, neighborIndex, newDistance);
+            }
+        }
+    }
+
+    IndexHeap_Destroy(heap);
+    free(job.inside);
+    free(job.nodes);
+}
+
+GraphNode findClosestNodeToPoint(City city, Point point) {
     double x = Point_GetX(point), y = Point_GetY(point);
     double minDist = INFINITY;
-    return _findClosestNode(getNodeTree(), RBTree_GetRoot(getNodeTree()), x, y, &minDist);
+    return _findClosestNode(City_GetNodeTree(city), RBTree_GetRoot(City_GetNodeTree(city)), x, y, &minDist);
 }
 
-PathStack findPathStack(GraphNode start, GraphNode end, bool quickest) {
-    if (_dijkstra(start, end, quickest)) {
-        return backtrace(start, end, NULL, NULL, quickest, true);
+PathStack findPathStack(City city, GraphNode start, GraphNode end, bool quickest) {
+    Search search;
+    PathTree tree;
+    StackItem stackTop = NULL;
+    if (_route(city, &search, &tree, start, end, quickest)) {
+        stackTop = backtrace(&search, start, end, NULL, NULL, quickest, true);
     }
+    _endRoute(city, &search, tree);
+    return stackTop;
+}
 
-    return NULL;
+PathStack findPathStackInTree(PathTree reverseTree, GraphNode start) {
+    if (!PathTree_Reach(reverseTree, start))
+        return NULL;
+
+    // Na árvore reversa o pai é o próximo vértice do caminho, e o nome guardado é o da rua até ele
+    GraphNode *parent = PathTree_GetParents(reverseTree);
+    char **streetName = PathTree_GetStreetNames(reverseTree);
+    StackItem stackTop = malloc(sizeof(struct stack_item_t));
+    stackTop->node = start;
+    stackTop->streetName = NULL;
+    stackTop->next = NULL;
+    StackItem last = stackTop;
+    for (GraphNode node = start; parent[GraphNode_GetIndex(node)] != NULL; node = parent[GraphNode_GetIndex(node)]) {
+        StackItem newItem = malloc(sizeof(struct stack_item_t));
+        newItem->node = parent[GraphNode_GetIndex(node)];
+        newItem->streetName = streetName[GraphNode_GetIndex(node)];
+        newItem->next = NULL;
+        last->next = newItem;
+        last = newItem;
+    }
+    for (StackItem item = stackTop; item != NULL; item = item->next)
+        item->base = last;
+    return stackTop;
 }
 
 GraphNode peekPathStack(PathStack stackTop) {
@@ -199,22 +642,22 @@ void destroyPathStack(PathStack stackTopVoid) {
     }
 }
 
-PathStack findPath(Point pointA, Point pointB, FILE *svgFile, FILE *txtFile, 
+PathStack findPath(City city, Point pointA, Point pointB, FILE *svgFile, FILE *txtFile, 
                    char color1[], char color2[], PathFindMode mode) {
     double x1 = Point_GetX(pointA), y1 = Point_GetY(pointA);
     double x2 = Point_GetX(pointB), y2 = Point_GetY(pointB);
     double minDist = INFINITY;
-    GraphNode start = _findClosestNode(getNodeTree(), RBTree_GetRoot(getNodeTree()), x1, y1, &minDist);
+    GraphNode start = _findClosestNode(City_GetNodeTree(city), RBTree_GetRoot(City_GetNodeTree(city)), x1, y1, &minDist);
     minDist = INFINITY;
-    GraphNode end = _findClosestNode(getNodeTree(), RBTree_GetRoot(getNodeTree()), x2, y2, &minDist);
+    GraphNode end = _findClosestNode(City_GetNodeTree(city), RBTree_GetRoot(City_GetNodeTree(city)), x2, y2, &minDist);
 
-    PathStack shortestPathStack = fullPathFind(start, end, svgFile, txtFile, color1, false, mode != SHORTEST);
+    PathStack shortestPathStack = fullPathFind(city, start, end, svgFile, txtFile, color1, false, mode != SHORTEST);
     if (shortestPathStack != NULL) {
         putSVGPath(svgFile, x1, y1, GraphNode_GetX(start), GraphNode_GetY(start), color1, 5);
         putSVGPath(svgFile, x2, y2, GraphNode_GetX(end), GraphNode_GetY(end), color1, 5);
     }
 
-    PathStack quickestPathStack = fullPathFind(start, end, svgFile, txtFile, color2, true, mode != QUICKEST);
+    PathStack quickestPathStack = fullPathFind(city, start, end, svgFile, txtFile, color2, true, mode != QUICKEST);
     if (quickestPathStack != NULL) {
         putSVGPath(svgFile, x1, y1, GraphNode_GetX(start), GraphNode_GetY(start), color2, 3);
         putSVGPath(svgFile, x2, y2, GraphNode_GetX(end), GraphNode_GetY(end), color2, 3);
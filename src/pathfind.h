@@ -2,8 +2,11 @@
 #define PATHFIND_H
 
 #include "modules/aux/point.h"
+#include "modules/aux/delta_stepping.h"
 #include "modules/util/svg.h"
-#include "data.h"
+#include "modules/data_structures/index_heap.h"
+#include "modules/util/stats.h"
+#include "city.h"
 
 typedef enum PathFindMode {
     ALL, QUICKEST, SHORTEST
@@ -11,7 +14,32 @@ typedef enum PathFindMode {
 
 typedef void *PathStack;
 
-PathStack findPathStack(GraphNode start, GraphNode end, bool fastest);
+GraphNode findClosestNodeToPoint(City city, Point point);
+
+// Custo do caminho mínimo de 'start' a cada um dos 'count' vértices de 'targets' (comprimento ou
+// tempo), numa única busca de Dijkstra que para quando todos foram alcançados. Destinos NULL ou
+// inalcançáveis ficam com INFINITY. Com City_GetSearchThreads, calcula a árvore inteira por
+// delta-stepping
+void findDistances(City city, GraphNode start, GraphNode targets[], int count, bool quickest, double distances[]);
+
+// Vértices alcançáveis a partir de 'start' com custo (comprimento ou tempo) até 'budget', em ordem
+// crescente de custo (empates em ordem de índice), com a quantidade em 'length'. A busca para no
+// limite. 'distances', se não for NULL, recebe o custo de cada um. Os vetores retornados devem ser
+// liberados. Com City_GetSearchThreads, a busca é por delta-stepping, com o mesmo resultado
+GraphNode *findReachable(City city, GraphNode start, double budget, bool quickest, double **distances, int *length);
+
+// Rota de fuga de cada vértice dentro de 'polygon': menor comprimento, ignorando bloqueios, até o
+// vértice de fora mais próximo, numa única busca reversa a partir dos vértices de fora ligados aos
+// de dentro. Os vetores têm City_GetNodeCount posições, por índice: 'next' recebe o próximo vértice
+// da rota (NULL fora do polígono ou sem saída) e 'distance' o comprimento (0 fora do polígono,
+// infinito onde não há rota)
+void findExits(City city, Polygon polygon, GraphNode next[], double distance[]);
+
+PathStack findPathStack(City city, GraphNode start, GraphNode end, bool fastest);
+
+// Caminho de 'start' até a raiz de uma árvore reversa (PathTree_Create com 'reverse'), seguindo
+// os pais; a busca da árvore só avança se 'start' ainda não tiver sido fechado. NULL se não houver
+PathStack findPathStackInTree(PathTree reverseTree, GraphNode start);
 
 GraphNode peekPathStack(PathStack stackTop);
 
@@ -21,7 +49,7 @@ GraphNode getPathStackBase(PathStack stackTop);
 
 void destroyPathStack(PathStack stackTop);
 
-PathStack findPath(Point pointA, Point pointB, FILE *svgFile, FILE *txtFile, 
+PathStack findPath(City city, Point pointA, Point pointB, FILE *svgFile, FILE *txtFile, 
                    char color1[], char color2[], PathFindMode mode);
 
 #endif
\ No newline at end of file
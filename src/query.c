@@ -1,6 +1,5 @@
 #include "query.h"
 
-static int _dumpBlockResidents(RBTree tree, Node node, FILE *file);
 
 typedef struct BBParameters {
     FILE *file;
@@ -48,9 +47,9 @@ static bool blockInDistanceL2(void *block, void *dVoid) {
     return topLeftCornerInside && topRightCornerInside && bottomLeftCornerInside && bottomRightCornerInside;
 }
 
-bool Query_Overlaps(FILE *txtFile, FILE *outputFile, char idA[], char idB[]) {
-    Object a = HashTable_Find(getObjTable(), idA);
-    Object b = HashTable_Find(getObjTable(), idB);
+bool Query_Overlaps(City city, FILE *txtFile, FILE *outputFile, char idA[], char idB[]) {
+    Object a = HashTable_Find(City_GetObjTable(city), idA);
+    Object b = HashTable_Find(City_GetObjTable(city), idB);
     if (a == NULL || b == NULL) {
         #ifdef __DEBUG__
         printf("Erro: Elemento não encontrado!\n");
@@ -82,8 +81,8 @@ bool Query_Overlaps(FILE *txtFile, FILE *outputFile, char idA[], char idB[]) {
     return true;
 }
 
-bool Query_Inside(FILE *txtFile, FILE *outputFile, char id[], double x, double y) {
-    Object o = HashTable_Find(getObjTable(), id);
+bool Query_Inside(City city, FILE *txtFile, FILE *outputFile, char id[], double x, double y) {
+    Object o = HashTable_Find(City_GetObjTable(city), id);
     if (o == NULL) {
         #ifdef __DEBUG__
         printf("Erro: Elemento não encontrado: %s!\n", id);
@@ -106,10 +105,10 @@ bool Query_Inside(FILE *txtFile, FILE *outputFile, char id[], double x, double y
     return true;
 }
 
-bool Query_Distance(FILE *txtFile, FILE *outputFile, char j[], char k[]) {
+bool Query_Distance(City city, FILE *txtFile, FILE *outputFile, char j[], char k[]) {
     double c1x, c1y, c2x, c2y;
-    Object a = HashTable_Find(getObjTable(), j);
-    Object b = HashTable_Find(getObjTable(), k);
+    Object a = HashTable_Find(City_GetObjTable(city), j);
+    Object b = HashTable_Find(City_GetObjTable(city), k);
     if (a == NULL || b == NULL) {
         #ifdef __DEBUG__
         printf("Erro: Elemento não encontrado!\n");
@@ -127,7 +126,7 @@ bool Query_Distance(FILE *txtFile, FILE *outputFile, char j[], char k[]) {
     putSVGText(outputFile, c1x + (c2x - c1x) / 2, c1y + (c2y - c1y) / 2, distText);
 }
 
-bool Query_Bb(FILE *txtFile, FILE *outputFile, char outputDir[], char svgFileName[], char suffix[], char color[]) {
+bool Query_Bb(City city, FILE *txtFile, FILE *outputFile, char outputDir[], char svgFileName[], char suffix[], char color[]) {
     char nameWithSuffix[128];
     strcpy(nameWithSuffix, svgFileName);
     addSuffix(nameWithSuffix, suffix);
@@ -138,17 +137,78 @@ bool Query_Bb(FILE *txtFile, FILE *outputFile, char outputDir[], char svgFileNam
 
     putSVGStart(bbFile);
     BBParameters params = {bbFile, color};
-    RBTree_Execute(getObjTree(), insertBoundingBoxElement, &params);
+    RBTree_Execute(City_GetObjTree(city), insertBoundingBoxElement, &params);
     putSVGEnd(bbFile);
     fclose(bbFile);
 }
 
-bool Query_Dq(FILE *txtFile, char metric[], char id[], double dist) {
-    Equip e = HashTable_Find(getHydTable(), id);
+// Vetor crescente usado para juntar os elementos de uma consulta antes de alterá-los em lote
+typedef struct Batch {
+    void **items;
+    int length;
+    int capacity;
+} Batch;
+
+static void _batchAppend(Batch *batch, void *item) {
+    if (batch->length == batch->capacity) {
+        batch->capacity = batch->capacity == 0 ? 16 : batch->capacity * 2;
+        batch->items = realloc(batch->items, batch->capacity * sizeof(void *));
+    }
+    batch->items[batch->length++] = item;
+}
+
+static bool _canBeOnLeftSubtree(double x, double r, double xChild) {
+    return xChild >= x - r;
+}
+
+static bool _canBeOnRightSubtree(double x, double r, double xChild) {
+    return xChild <= x + r;
+}
+
+typedef struct InfosDq {
+    double dInfos[3];
+    bool (*blockInDistance)(void *, void *);
+} InfosDq;
+
+// Percorre apenas as subárvores cujo x pode estar no raio, juntando as quadras encontradas
+static void _collectBlocksInDistance(RBTree tree, Node node, InfosDq *infos, Batch *batch) {
+    if (node == NULL)
+        return;
+    double *d = infos->dInfos;
+    Block b = RBTreeN_GetValue(tree, node);
+    if (_canBeOnLeftSubtree(d[0], d[2], Block_GetX(b)))
+        _collectBlocksInDistance(tree, RBTreeN_GetLeftChild(tree, node), infos, batch);
+    if (infos->blockInDistance(b, (void *) d))
+        _batchAppend(batch, b);
+    if (_canBeOnRightSubtree(d[0], d[2], Block_GetX(b)))
+        _collectBlocksInDistance(tree, RBTreeN_GetRightChild(tree, node), infos, batch);
+}
+
+// Tira (ou, com 'reinsert', recoloca com a posição atual da quadra) os estabelecimentos da árvore
+// de uma quadra no índice por tipo, que guarda o retângulo da quadra de cada um
+static void _reindexBlockCommerces(RBTree tree, Node node, Block block, bool reinsert) {
+    if (node == NULL)
+        return;
+    _reindexBlockCommerces(tree, RBTreeN_GetLeftChild(tree, node), block, reinsert);
+    Commerce commerce = RBTreeN_GetValue(tree, node);
+    CommerceType_RemoveCommerce(Commerce_GetType(commerce), commerce);
+    if (reinsert)
+        CommerceType_InsertCommerce(Commerce_GetType(commerce), commerce, Block_GetX(block), Block_GetY(block),
+                                    Block_GetW(block), Block_GetH(block));
+    _reindexBlockCommerces(tree, RBTreeN_GetRightChild(tree, node), block, reinsert);
+}
+
+static void _unindexBlockCommerces(Block block) {
+    _reindexBlockCommerces(Block_GetCommerces(block), RBTree_GetRoot(Block_GetCommerces(block)), block, false);
+}
+
+bool Query_Dq(City city, FILE *txtFile, char metric[], char id[], double dist) {
+    City_AdvanceEquipVersion(city);
+    Equip e = HashTable_Find(City_GetHydTable(city), id);
     if (e == NULL)
-        e = HashTable_Find(getCTowerTable(), id);
+        e = HashTable_Find(City_GetCTowerTable(city), id);
     if (e == NULL)
-        e = HashTable_Find(getTLightTable(), id);
+        e = HashTable_Find(City_GetTLightTable(city), id);
     if (e == NULL) {
         #ifdef __DEBUG__
         printf("Erro: Elemento não encontrado: %s!\n", id);
@@ -158,11 +218,11 @@ bool Query_Dq(FILE *txtFile, char metric[], char id[], double dist) {
 
     fprintf(txtFile, "Equipamento ID: %s\n", Equip_GetID(e));
 
-    bool (*_blockInDistance)(void *, void *);
+    InfosDq infos = {{Equip_GetX(e), Equip_GetY(e), dist}, NULL};
     if (strcmp(metric, "L1") == 0) {
-        _blockInDistance = blockInDistanceL1;
+        infos.blockInDistance = blockInDistanceL1;
     } else if (strcmp(metric, "L2") == 0) {
-        _blockInDistance = blockInDistanceL2;
+        infos.blockInDistance = blockInDistanceL2;
     } else {
         printf("Métrica não reconhecida: %s\n", metric);
         fprintf(txtFile, "Métrica não reconhecida: %s\n\n", metric);
@@ -172,66 +232,80 @@ bool Query_Dq(FILE *txtFile, char metric[], char id[], double dist) {
     Equip_SetHighlighted(e, true);
     fprintf(txtFile, "Quadras removidas: ");
 
-    double dInfos[3] = {Equip_GetX(e), Equip_GetY(e), dist};
-    Block b;
-    while (b = RBTree_FindWhere(getBlockTree(), _blockInDistance, (void *) dInfos), b != NULL) {
-        fprintf(txtFile, "\n\t- %s", Block_GetCep(b));
-        RBTree_Remove(getBlockTree(), Block_GetPoint(b));
-        HashTable_Remove(getBlockTable(), Block_GetCep(b));
-        Block_Destroy(b);
+    // Uma única busca por faixa na árvore, e depois a remoção de todas as quadras de uma vez
+    Batch blocks = {NULL, 0, 0};
+    _collectBlocksInDistance(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), &infos, &blocks);
+
+    if (blocks.length > 0) {
+        Key *keys = malloc(blocks.length * sizeof(Key));
+        for (int i = 0; i < blocks.length; i++) {
+            fprintf(txtFile, "\n\t- %s", Block_GetCep(blocks.items[i]));
+            keys[i] = Block_GetPoint(blocks.items[i]);
+        }
+        RBTree_RemoveMany(City_GetBlockTree(city), keys, blocks.length);
+        free(keys);
+
+        for (int i = 0; i < blocks.length; i++) {
+            HashTable_Remove(City_GetBlockTable(city), Block_GetCep(blocks.items[i]));
+            _unindexBlockCommerces(blocks.items[i]);
+            Block_Destroy(blocks.items[i]);
+        }
     }
+    free(blocks.items);
 
     fprintf(txtFile, "\n\n");
     return true;
 }
 
-bool Query_Del(FILE *txtFile, char id[]) {
-    Block b = HashTable_Find(getBlockTable(), id);
+bool Query_Del(City city, FILE *txtFile, char id[]) {
+    City_AdvanceEquipVersion(city);
+    Block b = HashTable_Find(City_GetBlockTable(city), id);
     if (b != NULL) {
         fprintf(txtFile, "Informações da quadra removida:\n"
                             "CEP: %s\nPos: (%.2lf, %.2lf)\n"
                             "Largura: %.2lf\nAltura: %.2lf\n\n",
                             Block_GetCep(b), Block_GetX(b), Block_GetY(b), 
                             Block_GetW(b), Block_GetH(b));
-        RBTree_Remove(getBlockTree(), Block_GetPoint(b));
-        HashTable_Remove(getBlockTable(), id);
+        RBTree_Remove(City_GetBlockTree(city), Block_GetPoint(b));
+        HashTable_Remove(City_GetBlockTable(city), id);
+        _unindexBlockCommerces(b);
         Block_Destroy(b);
         return true;
     }
 
-    Equip e = HashTable_Find(getHydTable(), id);
+    Equip e = HashTable_Find(City_GetHydTable(city), id);
     if (e != NULL) {
         fprintf(txtFile, "Informações do hidrante removido:\n"
                             "ID: %s\nPos: (%.2lf, %.2lf)\n\n",
                             Equip_GetID(e), Equip_GetX(e), Equip_GetY(e));
-        RBTree_Remove(getHydTree(), Equip_GetPoint(e));
-        HashTable_Remove(getHydTable(), id);
+        RBTree_Remove(City_GetHydTree(city), Equip_GetPoint(e));
+        HashTable_Remove(City_GetHydTable(city), id);
         Equip_Destroy(e);
 
         return true;
     }
 
-    e = HashTable_Find(getCTowerTable(), id);
+    e = HashTable_Find(City_GetCTowerTable(city), id);
     if (e != NULL) {
         fprintf(txtFile, "Informações da rádio-base removida:\n"
                             "ID: %s\nPos: (%.2lf, %.2lf)\n\n",
                             Equip_GetID(e), Equip_GetX(e), Equip_GetY(e));
         
-        RBTree_Remove(getCTowerTree(), Equip_GetPoint(e));
-        HashTable_Remove(getCTowerTable(), id);
+        RBTree_Remove(City_GetCTowerTree(city), Equip_GetPoint(e));
+        HashTable_Remove(City_GetCTowerTable(city), id);
         Equip_Destroy(e);
 
         return true;
     }
 
-    e = HashTable_Find(getTLightTable(), id);
+    e = HashTable_Find(City_GetTLightTable(city), id);
     if (e != NULL) {
         fprintf(txtFile, "Informações do semáforo removido:\n"
                             "ID: %s\nPos: (%.2lf, %.2lf)\n\n",
                             Equip_GetID(e), Equip_GetX(e), Equip_GetY(e));
         
-        RBTree_Remove(getTLightTree(), Equip_GetPoint(e));
-        HashTable_Remove(getTLightTable(), id);
+        RBTree_Remove(City_GetTLightTree(city), Equip_GetPoint(e));
+        HashTable_Remove(City_GetTLightTable(city), id);
         Equip_Destroy(e);
 
         return true;
@@ -252,14 +326,6 @@ typedef struct InfosCbq {
     FILE *txtFile;
 } InfosCbq;
 
-static bool _canBeOnLeftSubtree(double x, double r, double xChild) {
-    return xChild >= x - r;
-}
-
-static bool _canBeOnRightSubtree(double x, double r, double xChild) {
-    return xChild <= x + r;
-}
-
 static void _changeBlockColorTree(RBTree tree, Node node, InfosCbq *infos) {
     if (node == NULL)
         return;
@@ -276,35 +342,35 @@ static void _changeBlockColorTree(RBTree tree, Node node, InfosCbq *infos) {
     }
 }
 
-bool Query_Cbq(FILE *txtFile, double x, double y, double r, char cStrk[]) {
+bool Query_Cbq(City city, FILE *txtFile, double x, double y, double r, char cStrk[]) {
     fprintf(txtFile, "Quadras que tiveram as bordas alteradas: ");
 
     InfosCbq infos = {{x, y, r}, cStrk, txtFile};
-    _changeBlockColorTree(getBlockTree(), RBTree_GetRoot(getBlockTree()), &infos);
+    _changeBlockColorTree(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), &infos);
 
     fprintf(txtFile, "\n\n");
     return true;
 }
 
-bool Query_Crd(FILE *txtFile, char id[]) {
+bool Query_Crd(City city, FILE *txtFile, char id[]) {
     char eqType[24] = "";
     double x, y;
 
     Equip e;
     Block b;
-    if (b = HashTable_Find(getBlockTable(), id), b != NULL) {
+    if (b = HashTable_Find(City_GetBlockTable(city), id), b != NULL) {
         strcpy(eqType, "Quadra");
         x = Block_GetX(b);
         y = Block_GetY(b);
-    } else if (e = HashTable_Find(getHydTable(), id), e != NULL) {
+    } else if (e = HashTable_Find(City_GetHydTable(city), id), e != NULL) {
         strcpy(eqType, "Hidrante");
         x = Equip_GetX(e);
         y = Equip_GetY(e);
-    } else if (e = HashTable_Find(getCTowerTable(), id), e != NULL) {
+    } else if (e = HashTable_Find(City_GetCTowerTable(city), id), e != NULL) {
         strcpy(eqType, "Rádio-base");
         x = Equip_GetX(e);
         y = Equip_GetY(e);
-    } else if (e = HashTable_Find(getTLightTable(), id), e != NULL) {
+    } else if (e = HashTable_Find(City_GetTLightTable(city), id), e != NULL) {
         strcpy(eqType, "Semáforo");
         x = Equip_GetX(e);
         y = Equip_GetY(e);
@@ -338,132 +404,118 @@ typedef struct list_node_t {
     struct list_node_t *next;
 } ListNode;
 
-static void _translateBlockTree(RBTree tree, Node node, InfosTrns *infos, ListNode **list) {
+static void _translateBlockTree(RBTree tree, Node node, InfosTrns *infos, Batch *batch) {
     if (node == NULL)
         return;
     Block block = RBTreeN_GetValue(tree, node);
-    if (_canBeOnLeftSubtree(infos->x + infos->w, infos->w, Block_GetX(block)))
-        _translateBlockTree(tree, RBTreeN_GetLeftChild(tree, node), infos, list);
+    if (_canBeOnLeftSubtree(infos->x, 0, Block_GetX(block)))
+        _translateBlockTree(tree, RBTreeN_GetLeftChild(tree, node), infos, batch);
 
     if (Block_GetX(block) >= infos->x && Block_GetX(block) + Block_GetW(block) <= infos->x + infos->w &&
             Block_GetY(block) >= infos->y && Block_GetY(block) + Block_GetH(block) <= infos->y + infos->h) {
-        // Se a quadra estiver dentro do retângulo, adicioná-la à lista
-        ListNode *node = malloc(sizeof(struct list_node_t));
-        node->element = block;
-        node->tree = tree;
-        node->next = NULL;
-        (*list)->next = node;
-        *list = node;
+        // Se a quadra estiver dentro do retângulo, adicioná-la ao lote
+        _batchAppend(batch, block);
     }
 
-    if (_canBeOnRightSubtree(infos->x, infos->x + infos->w, Block_GetX(block))) {
-        _translateBlockTree(tree, RBTreeN_GetRightChild(tree, node), infos, list);
+    if (_canBeOnRightSubtree(infos->x, infos->w, Block_GetX(block))) {
+        _translateBlockTree(tree, RBTreeN_GetRightChild(tree, node), infos, batch);
     }
 }
 
-static void _translateEquipTree(RBTree tree, Node node, InfosTrns *infos, ListNode **list) {
+static void _translateEquipTree(RBTree tree, Node node, InfosTrns *infos, Batch *batch) {
     if (node == NULL)
         return;
     Equip equip = RBTreeN_GetValue(tree, node);
-    if (_canBeOnLeftSubtree(infos->x + infos->w, infos->w, Equip_GetX(equip)))
-        _translateEquipTree(tree, RBTreeN_GetLeftChild(tree, node), infos, list);
+    if (_canBeOnLeftSubtree(infos->x, 0, Equip_GetX(equip)))
+        _translateEquipTree(tree, RBTreeN_GetLeftChild(tree, node), infos, batch);
 
     if (Equip_GetX(equip) >= infos->x && Equip_GetX(equip) <= infos->x + infos->w &&
             Equip_GetY(equip) >= infos->y && Equip_GetY(equip) <= infos->y + infos->h) {
-        // Se o equipamento estiver dentro do retângulo, adicioná-lo à lista
-        ListNode *node = malloc(sizeof(struct list_node_t));
-        node->element = equip;
-        node->tree = tree;
-        node->next = NULL;
-        (*list)->next = node;
-        *list = node;
+        // Se o equipamento estiver dentro do retângulo, adicioná-lo ao lote
+        _batchAppend(batch, equip);
     }
 
-    if (_canBeOnRightSubtree(infos->x, infos->x + infos->w, Equip_GetX(equip))) {
-        _translateEquipTree(tree, RBTreeN_GetRightChild(tree, node), infos, list);
+    if (_canBeOnRightSubtree(infos->x, infos->w, Equip_GetX(equip))) {
+        _translateEquipTree(tree, RBTreeN_GetRightChild(tree, node), infos, batch);
     }
 }
 
-bool Query_Trns(FILE *txtFile, double x, double y, double w, double h, double dx, double dy) {
-    InfosTrns infos;
-    
-    infos.x = x;
-    infos.y = y;
-    infos.w = w;
-    infos.h = h;
-
-    fprintf(txtFile, "Equipamentos movidos:");
-    
-    // Primeiro nó vazio
-    ListNode *node = malloc(sizeof(struct list_node_t));
-    node->next = NULL;
-    ListNode *nodeP = node;
-
-    // Preencher lista
-    _translateBlockTree(getBlockTree(), RBTree_GetRoot(getBlockTree()), &infos, &nodeP);
-    
-    // Descartar primeiro nó (vazio)
-    ListNode *next = node->next;
-    free(node);
-    node = next;
+// Move em lote os equipamentos de uma árvore: todos são removidos de uma vez (pois a chave
+// muda), transladados e depois inseridos de uma vez com as chaves novas
+static void _translateEquips(FILE *txtFile, RBTree tree, InfosTrns *infos, double dx, double dy) {
+    Batch equips = {NULL, 0, 0};
+    _translateEquipTree(tree, RBTree_GetRoot(tree), infos, &equips);
+    if (equips.length == 0)
+        return;
 
-    // Percorrer a lista de quadras a serem transladadas
-    while (node != NULL) {
-        // Remover devido à mudança de chave
-        Block block = RBTree_Remove(node->tree, Block_GetPoint(node->element));
+    Key *keys = malloc(equips.length * sizeof(Key));
+    for (int i = 0; i < equips.length; i++)
+        keys[i] = Equip_GetPoint(equips.items[i]);
+    RBTree_RemoveMany(tree, keys, equips.length);
 
+    for (int i = 0; i < equips.length; i++) {
+        Equip equip = equips.items[i];
         fprintf(txtFile, "\n%s:"
                          "\n\tPosição anterior: (%.2lf, %.2lf)"
                          "\n\tNova posição: (%.2lf, %.2lf)",
-                         Block_GetCep(block), Block_GetX(block), Block_GetY(block),
-                         Block_GetX(block) + dx, Block_GetY(block) + dy);
-
-        Block_SetX(block, Block_GetX(block) + dx);
-        Block_SetY(block, Block_GetY(block) + dy);
-
-        // Inserir novamente com a chave nova
-        RBTree_Insert(node->tree, Block_GetPoint(block), block);
-
-        next = node->next;
-        free(node);
-        node = next;
+                         Equip_GetID(equip), Equip_GetX(equip), Equip_GetY(equip),
+                         Equip_GetX(equip) + dx, Equip_GetY(equip) + dy);
+        Equip_SetX(equip, Equip_GetX(equip) + dx);
+        Equip_SetY(equip, Equip_GetY(equip) + dy);
+        keys[i] = Equip_GetPoint(equip);
     }
 
-    // Primeiro nó vazio
-    node = malloc(sizeof(struct list_node_t));
-    node->next = NULL;
-    nodeP = node;
-
-    // Preencher lista
-    _translateEquipTree(getHydTree(), RBTree_GetRoot(getHydTree()), &infos, &nodeP);
-    _translateEquipTree(getCTowerTree(), RBTree_GetRoot(getCTowerTree()), &infos, &nodeP);
-    _translateEquipTree(getTLightTree(), RBTree_GetRoot(getTLightTree()), &infos, &nodeP);
+    RBTree_InsertMany(tree, keys, equips.items, equips.length);
+    free(keys);
+    free(equips.items);
+}
 
-    // Descartar primeiro nó (vazio)
-    next = node->next;
-    free(node);
-    node = next;
+bool Query_Trns(City city, FILE *txtFile, double x, double y, double w, double h, double dx, double dy) {
+    City_AdvanceEquipVersion(city);
+    InfosTrns infos;
+    
+    infos.x = x;
+    infos.y = y;
+    infos.w = w;
+    infos.h = h;
 
-    // Percorrer a lista de equipamentos a serem transladados
-    while (node != NULL) {
-        // Remover devido à mudança de chave
-        Equip equip = RBTree_Remove(node->tree, Equip_GetPoint(node->element));
+    fprintf(txtFile, "Equipamentos movidos:");
 
-        fprintf(txtFile, "\n%s:"
-                         "\n\tPosição anterior: (%.2lf, %.2lf)"
-                         "\n\tNova posição: (%.2lf, %.2lf)",
-                         Equip_GetID(equip), Equip_GetX(equip), Equip_GetY(equip),
-                         Equip_GetX(equip) + dx, Equip_GetY(equip) + dy);
-        Equip_SetX(equip, Equip_GetX(equip) + dx);
-        Equip_SetY(equip, Equip_GetY(equip) + dy);
-        
-        // Inserir novamente com a chave nova
-        RBTree_Insert(node->tree, Equip_GetPoint(equip), equip);
+    // Juntar as quadras a serem transladadas
+    Batch blocks = {NULL, 0, 0};
+    _translateBlockTree(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), &infos, &blocks);
+
+    if (blocks.length > 0) {
+        // Remover todas de uma vez devido à mudança de chave
+        Key *keys = malloc(blocks.length * sizeof(Key));
+        for (int i = 0; i < blocks.length; i++)
+            keys[i] = Block_GetPoint(blocks.items[i]);
+        RBTree_RemoveMany(City_GetBlockTree(city), keys, blocks.length);
+
+        for (int i = 0; i < blocks.length; i++) {
+            Block block = blocks.items[i];
+            fprintf(txtFile, "\n%s:"
+                             "\n\tPosição anterior: (%.2lf, %.2lf)"
+                             "\n\tNova posição: (%.2lf, %.2lf)",
+                             Block_GetCep(block), Block_GetX(block), Block_GetY(block),
+                             Block_GetX(block) + dx, Block_GetY(block) + dy);
+
+            Block_SetX(block, Block_GetX(block) + dx);
+            Block_SetY(block, Block_GetY(block) + dy);
+            keys[i] = Block_GetPoint(block);
+            // O índice por tipo guarda a posição antiga da quadra
+            _reindexBlockCommerces(Block_GetCommerces(block), RBTree_GetRoot(Block_GetCommerces(block)), block, true);
+        }
 
-        next = node->next;
-        free(node);
-        node = next;
+        // Inserir novamente com as chaves novas
+        RBTree_InsertMany(City_GetBlockTree(city), keys, blocks.items, blocks.length);
+        free(keys);
     }
+    free(blocks.items);
+
+    _translateEquips(txtFile, City_GetHydTree(city), &infos, dx, dy);
+    _translateEquips(txtFile, City_GetCTowerTree(city), &infos, dx, dy);
+    _translateEquips(txtFile, City_GetTLightTree(city), &infos, dx, dy);
     
     fprintf(txtFile, "\n\n");
 
@@ -500,15 +552,15 @@ static void buildDistances(RBTree tree, Node node, Distance **distances, int x,
     buildDistances(tree, RBTreeN_GetRightChild(tree, node), distances, x, y);
 }
 
-bool Query_Fi(FILE *txtFile, FILE *outputFile, double x, double y, int ns, double r) {
+bool Query_Fi(City city, FILE *txtFile, FILE *outputFile, double x, double y, int ns, double r) {
     fprintf(txtFile, "Semáforos com a programação alterada:");
 
-    int n = RBTree_GetLength(getTLightTree());
+    int n = RBTree_GetLength(City_GetTLightTree(city));
     Distance *distances = malloc(n * sizeof(Distance));
     Distance *distancesP = distances;
 
     // Construir vetor de distâncias dos semáforos ao ponto (x, y)
-    buildDistances(getTLightTree(), RBTree_GetRoot(getTLightTree()), &distancesP, x, y);
+    buildDistances(City_GetTLightTree(city), RBTree_GetRoot(City_GetTLightTree(city)), &distancesP, x, y);
 
     // Ordenar as distâncias até que se tenha as 'ns' maiores
     heapsort(distances, n, ns, compareDistancesDescending);
@@ -529,8 +581,8 @@ bool Query_Fi(FILE *txtFile, FILE *outputFile, double x, double y, int ns, doubl
     fprintf(txtFile, "Hidrantes ativados:");
 
     // Percorrer a árvore de hidrantes
-    for (Node node = RBTree_GetFirstNode(getHydTree()); node != NULL; node = RBTreeN_GetSuccessor(getHydTree(), node)) {
-        Equip hydrant = RBTreeN_GetValue(getHydTree(), node);
+    for (Node node = RBTree_GetFirstNode(City_GetHydTree(city)); node != NULL; node = RBTreeN_GetSuccessor(City_GetHydTree(city), node)) {
+        Equip hydrant = RBTreeN_GetValue(City_GetHydTree(city), node);
         double dist = euclideanDistance(Equip_GetX(hydrant), Equip_GetY(hydrant), x, y);
         if (dist <= r) {
             Equip_SetHighlighted(hydrant, true);
@@ -544,9 +596,9 @@ bool Query_Fi(FILE *txtFile, FILE *outputFile, double x, double y, int ns, doubl
     return true;
 }
 
-bool Query_Fh(FILE *txtFile, FILE *outputFile, char signal, int k, char cep[], char face, double num) {
+bool Query_Fh(City city, FILE *txtFile, FILE *outputFile, char signal, int k, char cep[], char face, double num) {
 
-    Block b = HashTable_Find(getBlockTable(), cep);
+    Block b = HashTable_Find(City_GetBlockTable(city), cep);
     if (b == NULL) {
         #ifdef __DEBUG__
         printf("Erro: Elemento não encontrado!\n");
@@ -565,12 +617,12 @@ bool Query_Fh(FILE *txtFile, FILE *outputFile, char signal, int k, char cep[], c
         return true;
     }
 
-    int n = RBTree_GetLength(getHydTree());
+    int n = RBTree_GetLength(City_GetHydTree(city));
     Distance *distances = malloc(n * sizeof(Distance));
     Distance *distancesP = distances;
 
     // Construir vetor de distâncias dos hidrantes ao ponto (x, y)
-    buildDistances(getHydTree(), RBTree_GetRoot(getHydTree()), &distancesP, x, y);
+    buildDistances(City_GetHydTree(city), RBTree_GetRoot(City_GetHydTree(city)), &distancesP, x, y);
 
     if (signal == '+') {
         fprintf(txtFile, "%d hidrantes mais distantes:", k);
@@ -606,9 +658,9 @@ bool Query_Fh(FILE *txtFile, FILE *outputFile, char signal, int k, char cep[], c
     return true;
 }
 
-bool Query_Fs(FILE *txtFile, FILE *outputFile, int k, char cep[], char face, double num) {
+bool Query_Fs(City city, FILE *txtFile, FILE *outputFile, int k, char cep[], char face, double num) {
 
-    Block b = HashTable_Find(getBlockTable(), cep);
+    Block b = HashTable_Find(City_GetBlockTable(city), cep);
     if (b == NULL) {
         #ifdef __DEBUG__
         printf("Erro: Elemento não encontrado!\n");
@@ -627,12 +679,12 @@ bool Query_Fs(FILE *txtFile, FILE *outputFile, int k, char cep[], char face, dou
         return true;
     }
 
-    int n = RBTree_GetLength(getTLightTree());
+    int n = RBTree_GetLength(City_GetTLightTree(city));
     Distance *distances = malloc(n * sizeof(Distance));
     Distance *distancesP = distances;
 
     // Construir vetor de distâncias dos semáforos ao ponto (x, y)
-    buildDistances(getTLightTree(), RBTree_GetRoot(getTLightTree()), &distancesP, x, y);
+    buildDistances(City_GetTLightTree(city), RBTree_GetRoot(City_GetTLightTree(city)), &distancesP, x, y);
 
     fprintf(txtFile, "%d semáforos mais próximos:", k);
     heapsort(distances, n, k, compareDistancesDescending);
@@ -654,11 +706,95 @@ bool Query_Fs(FILE *txtFile, FILE *outputFile, int k, char cep[], char face, dou
     return true;
 }
 
+// Mapa de equipamento mais próximo da árvore 'tree' na posição 'slot' do cache, calculado se a versão
+// dos equipamentos mudou. Chamar com o cache travado
+static FacilityMap _getFacilityMap(City city, RBTree tree, int slot, bool quickest) {
+    FacilityMapCache cache = City_GetFacilityMaps(city);
+    FacilityMap map = FacilityMapCache_Get(cache, slot, City_GetEquipVersion(city));
+    if (map != NULL)
+        return map;
+
+    int n = RBTree_GetLength(tree), count = 0;
+    void **facilities = malloc((n + 1) * sizeof(void *));
+    GraphNode *seeds = malloc((n + 1) * sizeof(GraphNode));
+    for (Node node = RBTree_GetFirstNode(tree); node != NULL; node = RBTreeN_GetSuccessor(tree, node)) {
+        Equip equip = RBTreeN_GetValue(tree, node);
+        facilities[count] = equip;
+        seeds[count++] = findClosestNodeToPoint(city, Equip_GetPoint(equip));
+    }
+    map = FacilityMap_Create(City_GetNodeCount(city), seeds, facilities, count, quickest, City_GetSearchThreads(city));
+    FacilityMapCache_Set(cache, slot, City_GetEquipVersion(city), map);
+    free(facilities);
+    free(seeds);
+    return map;
+}
+
+bool Query_Nf(City city, FILE *txtFile, FILE *outputFile, char type[], bool quickest, char cep[], char face, double num,
+              char color[]) {
+    RBTree tree;
+    int slot;
+    if (strcmp(type, "h") == 0) {
+        tree = City_GetHydTree(city);
+        slot = 0;
+    } else if (strcmp(type, "s") == 0) {
+        tree = City_GetTLightTree(city);
+        slot = 2;
+    } else if (strcmp(type, "rb") == 0) {
+        tree = City_GetCTowerTree(city);
+        slot = 4;
+    } else {
+        fprintf(txtFile, "Tipo de equipamento desconhecido: '%s'\n\n", type);
+        return true;
+    }
+    slot += quickest;
+
+    Block b = HashTable_Find(City_GetBlockTable(city), cep);
+    if (b == NULL) {
+        fprintf(txtFile, "Elemento não encontrado\n\n");
+        return true;
+    }
+    double x, y;
+    if (!Block_GetCoordinates(b, face, num, &x, &y)) {
+        fprintf(txtFile, "Direção desconhecida: '%c'\n\n", face);
+        return true;
+    }
+
+    Point point = Point_Create(x, y);
+    GraphNode start = findClosestNodeToPoint(city, point);
+    Point_Destroy(point);
+    if (start == NULL) {
+        fputs("Nenhum vértice no mapa\n\n", txtFile);
+        return true;
+    }
+
+    FacilityMapCache cache = City_GetFacilityMaps(city);
+    FacilityMapCache_Lock(cache);
+    FacilityMap map = _getFacilityMap(city, tree, slot, quickest);
+    double distance;
+    Equip equip = FacilityMap_GetNearest(map, start, &distance);
+    if (equip == NULL) {
+        fputs("Nenhum equipamento alcançável pelas ruas\n\n", txtFile);
+    } else {
+        fprintf(txtFile, "Mais próximo pelas ruas: %s (%s %.2lf)\n\n", Equip_GetID(equip),
+                quickest ? "tempo" : "comprimento", distance);
+        putSVGPath(outputFile, x, y, GraphNode_GetX(start), GraphNode_GetY(start), color, 3);
+        GraphNode node = start;
+        for (GraphNode next = FacilityMap_GetNext(map, node); next != NULL; next = FacilityMap_GetNext(map, node)) {
+            putSVGPath(outputFile, GraphNode_GetX(node), GraphNode_GetY(node), GraphNode_GetX(next), GraphNode_GetY(next),
+                       color, 3);
+            node = next;
+        }
+        putSVGPath(outputFile, GraphNode_GetX(node), GraphNode_GetY(node), Equip_GetX(equip), Equip_GetY(equip), color, 3);
+    }
+    FacilityMapCache_Unlock(cache);
+    return true;
+}
+
 bool compareAddr(Segment s1, Segment s2) {
     return s1 == s2;
 }
 
-bool _pointVisibility(FILE *outputFile, double x, double y, bool buildings, Polygon poly) {
+bool _pointVisibility(City city, FILE *outputFile, double x, double y, bool buildings, Polygon poly) {
 
     if (x == 0 && y == 0) {
         Polygon_InsertPoint(poly, 0, 0);
@@ -666,8 +802,8 @@ bool _pointVisibility(FILE *outputFile, double x, double y, bool buildings, Poly
 
     // int nBuildings = StList_GetNumElements(getBuildingList());
     // int nWalls = StList_GetNumElements(getWallList());
-    int nBuildings = RBTree_GetLength(getBuildingTree());
-    int nWalls = RBTree_GetLength(getWallTree());
+    int nBuildings = RBTree_GetLength(City_GetBuildingTree(city));
+    int nWalls = RBTree_GetLength(City_GetWallTree(city));
 
     int nSegments = nBuildings * 4 + nWalls;
 
@@ -678,9 +814,9 @@ bool _pointVisibility(FILE *outputFile, double x, double y, bool buildings, Poly
 
     if (buildings) {
         // Colocar segmentos dos prédios na lista
-        for (Node node = RBTree_GetFirstNode(getBuildingTree()); node != NULL; node = RBTreeN_GetSuccessor(getBuildingTree(), node)) {
+        for (Node node = RBTree_GetFirstNode(City_GetBuildingTree(city)); node != NULL; node = RBTreeN_GetSuccessor(City_GetBuildingTree(city), node)) {
             //Building b = StList_Get(getBuildingList(), p);
-            Building b = RBTreeN_GetValue(getBuildingTree(), node);
+            Building b = RBTreeN_GetValue(City_GetBuildingTree(city), node);
             // if (Building_GetNum(b) != 78)
             //     continue;
             segmentsP = Building_PutSegments(b, segmentsP, x, y);
@@ -695,9 +831,9 @@ bool _pointVisibility(FILE *outputFile, double x, double y, bool buildings, Poly
     
     // Colocar segmentos dos muros na lista
     //for (int p = StList_GetFirstPos(getWallList()); p != -1; p = StList_GetNextPos(getWallList(), p)) {
-    for (Node node = RBTree_GetFirstNode(getWallTree()); node != NULL; node = RBTreeN_GetSuccessor(getWallTree(), node)) {
+    for (Node node = RBTree_GetFirstNode(City_GetWallTree(city)); node != NULL; node = RBTreeN_GetSuccessor(City_GetWallTree(city), node)) {
         //Wall w = StList_Get(getWallList(), p);
-        Wall w = RBTreeN_GetValue(getWallTree(), node);
+        Wall w = RBTreeN_GetValue(City_GetWallTree(city), node);
         segmentsP = Wall_PutSegments(w, segmentsP, x, y);
         double wallMaxX = max(Wall_GetX1(w), Wall_GetX2(w));
         if (wallMaxX > maxX)
@@ -874,36 +1010,22 @@ bool _pointVisibility(FILE *outputFile, double x, double y, bool buildings, Poly
     return true;
 }
 
-bool Query_Brl(FILE *outputFile, double x, double y) {
+bool Query_Brl(City city, FILE *outputFile, double x, double y) {
     Polygon poly = Polygon_Create();
     
-    _pointVisibility(outputFile, x, y, true, poly);
+    _pointVisibility(city, outputFile, x, y, true, poly);
     putSVGPolygon(outputFile, poly, "gold");
     Polygon_Destroy(poly);
 
     return true;
 }
 
-static int _dumpBlockResidents(RBTree tree, Node node, FILE *file) {
-    if (node == NULL)
-        return 0;
-    int i = 1;
-    i += _dumpBlockResidents(tree, RBTreeN_GetLeftChild(tree, node), file);
-    fprintf(file, "%d)\n", i);
-    Person_DumpToFile(RBTreeN_GetValue(tree, node), file);
-    i += _dumpBlockResidents(tree, RBTreeN_GetRightChild(tree, node), file);
-    return i;
-}
-
-static int _dumpBuildingResidents(RBTree tree, Node node, FILE *file) {
-    if (node == NULL)
-        return 0;
-    int i = 1;
-    i += _dumpBuildingResidents(tree, RBTreeN_GetLeftChild(tree, node), file);
-    fprintf(file, "%d)\n", i);
-    Person_DumpToFile(RBTreeN_GetValue(tree, node), file);
-    i += _dumpBuildingResidents(tree, RBTreeN_GetRightChild(tree, node), file);
-    return i;
+static int _dumpResidents(PersonList *residents, FILE *file) {
+    for (int i = 0; i < residents->length; i++) {
+        fprintf(file, "%d)\n", i + 1);
+        Person_DumpToFile(residents->items[i], file);
+    }
+    return residents->length;
 }
 
 static void _executeBrnBlocks(RBTree tree, Node node, Polygon polygon, FILE *txtFile) {
@@ -914,8 +1036,7 @@ static void _executeBrnBlocks(RBTree tree, Node node, Polygon polygon, FILE *txt
         _executeBrnBlocks(tree, RBTreeN_GetLeftChild(tree, node), polygon, txtFile);
     if (Polygon_IsBlockInside(polygon, block, true)) {
         fprintf(txtFile, "Moradores da quadra %s:\n", Block_GetCep(block));
-        RBTree residents = Block_GetResidents(block);
-        int total = _dumpBlockResidents(residents, RBTree_GetRoot(residents), txtFile);
+        int total = _dumpResidents(Block_GetResidents(block), txtFile);
         fprintf(txtFile, "TOTAL: %d\n", total);
     }
     if (Block_GetX(block) <= Polygon_GetMaxX(polygon))
@@ -930,39 +1051,48 @@ static void _executeBrnBuildings(RBTree tree, Node node, Polygon polygon, FILE *
         _executeBrnBuildings(tree, RBTreeN_GetLeftChild(tree, node), polygon, txtFile);
     if (Polygon_IsBuildingInside(polygon, building)) {
         fprintf(txtFile, "Moradores do predio %s:\n", Building_GetKey(building));
-        RBTree residents = Building_GetResidents(building);
-        int total = _dumpBuildingResidents(residents, RBTree_GetRoot(residents), txtFile);
+        int total = _dumpResidents(Building_GetResidents(building), txtFile);
         fprintf(txtFile, "TOTAL: %d\n", total);
     }
     if (Building_GetX(building) <= Polygon_GetMaxX(polygon))
         _executeBrnBuildings(tree, RBTreeN_GetRightChild(tree, node), polygon, txtFile);
 }
 
-static void _executeBrnNodes(RBTree tree, Node node, Polygon polygon) {
+// Bloqueia as arestas; as células do índice de partição (se houver) que as contêm são marcadas
+static void _executeBrnNodes(RBTree tree, Node node, Polygon polygon, RoutePartition partition) {
     if (node == NULL)
         return;
     GraphNode graphNode = RBTreeN_GetValue(tree, node);
-    _executeBrnNodes(tree, RBTreeN_GetLeftChild(tree, node), polygon);
-    GraphNode_DestroyEdgesAffected(graphNode, polygon);
-    _executeBrnNodes(tree, RBTreeN_GetRightChild(tree, node), polygon);
+    _executeBrnNodes(tree, RBTreeN_GetLeftChild(tree, node), polygon, partition);
+    if (GraphNode_DestroyEdgesAffected(graphNode, polygon) && partition != NULL)
+        RoutePartition_MarkChanged(partition, graphNode);
+    _executeBrnNodes(tree, RBTreeN_GetRightChild(tree, node), polygon, partition);
 }
 
-bool Query_Brn(FILE *txtFile, FILE *outputFile, double x, double y, char *outputDir, char *arqPol) {
+bool Query_Brn(City city, FILE *txtFile, FILE *outputFile, double x, double y, char *outputDir, char *arqPol) {
     FILE *polyFile = openFile(outputDir, arqPol, "w");
     if (polyFile == NULL)
         return false;
     
     Polygon poly = Polygon_Create();
     
-    _pointVisibility(outputFile, x, y, false, poly);
+    _pointVisibility(city, outputFile, x, y, false, poly);
     putSVGPolygon(outputFile, poly, "gold");
 
     Polygon_DumpToFile(poly, polyFile);
     fclose(polyFile);
-
-    _executeBrnBlocks(getBlockTree(), RBTree_GetRoot(getBlockTree()), poly, txtFile);
-    _executeBrnBuildings(getBuildingTree(), RBTree_GetRoot(getBuildingTree()), poly, txtFile);
-    _executeBrnNodes(getNodeTree(), RBTree_GetRoot(getNodeTree()), poly);
+    // O arquivo foi reescrito, uma versão antiga no cache não vale mais
+    PolygonCache_Invalidate(outputDir, arqPol);
+
+    _executeBrnBlocks(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), poly, txtFile);
+    _executeBrnBuildings(City_GetBuildingTree(city), RBTree_GetRoot(City_GetBuildingTree(city)), poly, txtFile);
+    RoutePartition partition = City_GetRoutePartition(city);
+    _executeBrnNodes(City_GetNodeTree(city), RBTree_GetRoot(City_GetNodeTree(city)), poly, partition);
+    if (partition != NULL)
+        RoutePartition_Customize(partition);
+    // Árvores de caminhos e mapas de equipamento já calculados usaram as arestas removidas
+    City_AdvanceGraphVersion(city);
+    City_AdvanceEquipVersion(city);
 
     fputs("\n", txtFile);
     Polygon_Destroy(poly);
@@ -970,16 +1100,83 @@ bool Query_Brn(FILE *txtFile, FILE *outputFile, double x, double y, char *output
     return true;
 }
 
-bool Query_M(FILE *txtFile, char *cep) {
-    Block block = HashTable_Find(getBlockTable(), cep);
+typedef struct evac_job_t {
+    City city;
+    Polygon polygon;
+    GraphNode *next;
+    double *distance;
+    FILE *txtFile, *outputFile;
+    char *color;
+    int blocks, residents, stranded;
+} EvacJob;
+
+static void _executeEvacBlocks(RBTree tree, Node node, EvacJob *job) {
+    if (node == NULL)
+        return;
+    Block block = RBTreeN_GetValue(tree, node);
+    if (Block_GetX(block) >= Polygon_GetMinX(job->polygon))
+        _executeEvacBlocks(tree, RBTreeN_GetLeftChild(tree, node), job);
+    if (Polygon_IsBlockInside(job->polygon, block, true)) {
+        double x = Block_GetX(block) + Block_GetW(block) / 2, y = Block_GetY(block) + Block_GetH(block) / 2;
+        Point center = Point_Create(x, y);
+        GraphNode start = findClosestNodeToPoint(job->city, center);
+        Point_Destroy(center);
+
+        int residents = Block_GetResidents(block)->length;
+        job->blocks++;
+        job->residents += residents;
+        fprintf(job->txtFile, "Quadra %s (%d moradores): ", Block_GetCep(block), residents);
+        double distance = start != NULL ? job->distance[GraphNode_GetIndex(start)] : INFINITY;
+        if (!isfinite(distance)) {
+            fputs("sem rota de saída\n", job->txtFile);
+            job->stranded += residents;
+        } else {
+            putSVGPath(job->outputFile, x, y, GraphNode_GetX(start), GraphNode_GetY(start), job->color, 3);
+            GraphNode current = start;
+            for (GraphNode next = job->next[GraphNode_GetIndex(current)]; next != NULL;
+                    next = job->next[GraphNode_GetIndex(current)]) {
+                putSVGPath(job->outputFile, GraphNode_GetX(current), GraphNode_GetY(current),
+                           GraphNode_GetX(next), GraphNode_GetY(next), job->color, 3);
+                current = next;
+            }
+            fprintf(job->txtFile, "saída pelo vértice %s a %.2lf metros\n", GraphNode_GetId(current), distance);
+        }
+    }
+    if (Block_GetX(block) <= Polygon_GetMaxX(job->polygon))
+        _executeEvacBlocks(tree, RBTreeN_GetRightChild(tree, node), job);
+}
+
+bool Query_Evac(City city, FILE *txtFile, FILE *outputFile, char *outputDir, char *arqPol, char *color) {
+    // O polígono pertence ao cache: liberá-lo com PolygonCache_Release, não destruí-lo
+    Polygon poly = PolygonCache_Get(outputDir, arqPol);
+    if (poly == NULL) {
+        fprintf(txtFile, "Polígono não encontrado: %s\n\n", arqPol);
+        return true;
+    }
+
+    int size = City_GetNodeCount(city);
+    EvacJob job = {city, poly, malloc(size * sizeof(GraphNode)), malloc(size * sizeof(double)), txtFile, outputFile,
+                   color, 0, 0, 0};
+    findExits(city, poly, job.next, job.distance);
+    _executeEvacBlocks(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), &job);
+    fprintf(txtFile, "TOTAL: %d quadras, %d moradores, %d sem rota de saída\n\n", job.blocks, job.residents,
+            job.stranded);
+
+    free(job.next);
+    free(job.distance);
+    PolygonCache_Release(poly);
+    return true;
+}
+
+bool Query_M(City city, FILE *txtFile, char *cep) {
+    Block block = HashTable_Find(City_GetBlockTable(city), cep);
     if (block == NULL) {
         fprintf(txtFile, "Quadra de CEP %s não encontrada\n\n", cep);
         return true;
     }
 
     fprintf(txtFile, "Moradores da quadra %s:\n", cep);
-    RBTree residents = Block_GetResidents(block);
-    int total = _dumpBlockResidents(residents, RBTree_GetRoot(residents), txtFile);
+    int total = _dumpResidents(Block_GetResidents(block), txtFile);
     fprintf(txtFile, "TOTAL: %d\n", total);
 
     fputs("\n", txtFile);
@@ -995,8 +1192,7 @@ static void _executeMplgBlocks(RBTree tree, Node node, Polygon polygon, FILE *ou
         _executeMplgBlocks(tree, RBTreeN_GetLeftChild(tree, node), polygon, outputFile);
     if (Polygon_IsBlockInside(polygon, block, true)) {
         Block_SetWStroke(block, "4.00000");
-        RBTree residents = Block_GetResidents(block);
-        int total = RBTree_GetLength(residents);
+        int total = Block_GetResidents(block)->length;
         fprintf(outputFile, "<text x=\"%lf\" y=\"%lf\" text-anchor=\"middle\" "
                             "dominant-baseline=\"middle\" font-size=\"20\">%d</text>",
                             Block_GetX(block) + Block_GetW(block) / 2,
@@ -1015,33 +1211,176 @@ static void _executeMplgBuildings(RBTree tree, Node node, Polygon polygon, FILE
         _executeMplgBuildings(tree, RBTreeN_GetLeftChild(tree, node), polygon, txtFile);
     if (Polygon_IsBuildingInside(polygon, building)) {
         fprintf(txtFile, "Moradores do predio %s:\n", Building_GetKey(building));
-        RBTree residents = Building_GetResidents(building);
-        if (RBTree_GetLength(residents) > 0)
+        PersonList *residents = Building_GetResidents(building);
+        if (residents->length > 0)
             Building_SetPainted(building, true);
-        int total = _dumpBuildingResidents(residents, RBTree_GetRoot(residents), txtFile);
+        int total = _dumpResidents(residents, txtFile);
         fprintf(txtFile, "TOTAL: %d\n", total);
     }
     if (Building_GetX(building) + Building_GetW(building) <= Polygon_GetMaxX(polygon))
         _executeMplgBuildings(tree, RBTreeN_GetRightChild(tree, node), polygon, txtFile);
 }
 
-bool Query_Mplg(FILE *txtFile, FILE *outputFile, char* baseDir, char *arqPolig) {
-    FILE *polyFile = openFile(baseDir, arqPolig, "r");
-    if (polyFile == NULL)
+bool Query_Mplg(City city, FILE *txtFile, FILE *outputFile, char* baseDir, char *arqPolig) {
+    // O polígono pertence ao cache: liberá-lo com PolygonCache_Release, não destruí-lo
+    Polygon poly = PolygonCache_Get(baseDir, arqPolig);
+    if (poly == NULL)
         return false;
-    
-    Polygon poly = Polygon_Create();
-    Polygon_ReadFromFile(poly, polyFile);
-    fclose(polyFile);
 
-    _executeMplgBlocks(getBlockTree(), RBTree_GetRoot(getBlockTree()), poly, outputFile);
-    _executeMplgBuildings(getBuildingTree(), RBTree_GetRoot(getBuildingTree()), poly, txtFile);
+    _executeMplgBlocks(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), poly, outputFile);
+    _executeMplgBuildings(City_GetBuildingTree(city), RBTree_GetRoot(City_GetBuildingTree(city)), poly, txtFile);
 
-    Polygon_Destroy(poly);
+    PolygonCache_Release(poly);
+    return true;
+}
+
+typedef struct aggregate_t {
+    int blocks, residents, commerces;
+    ResidentCounts counts;
+    CommerceCount *commerceCounts;
+    int commerceTypes;
+} Aggregate;
+
+static void _addCommerceCount(Aggregate *aggregate, CommerceCount *count) {
+    aggregate->commerces += count->count;
+    for (int i = 0; i < aggregate->commerceTypes; i++) {
+        if (aggregate->commerceCounts[i].type == count->type) {
+            aggregate->commerceCounts[i].count += count->count;
+            return;
+        }
+    }
+    aggregate->commerceCounts = realloc(aggregate->commerceCounts, 
+                                        (aggregate->commerceTypes + 1) * sizeof(CommerceCount));
+    aggregate->commerceCounts[aggregate->commerceTypes++] = *count;
+}
+
+static void _executeAgrBlocks(RBTree tree, Node node, Polygon polygon, Aggregate *aggregate) {
+    if (node == NULL)
+        return;
+    Block block = RBTreeN_GetValue(tree, node);
+    if (Block_GetX(block) >= Polygon_GetMinX(polygon))
+        _executeAgrBlocks(tree, RBTreeN_GetLeftChild(tree, node), polygon, aggregate);
+    if (Polygon_IsBlockInside(polygon, block, true)) {
+        PersonList *residents = Block_GetResidents(block);
+        aggregate->blocks++;
+        aggregate->residents += residents->length;
+        ResidentCounts_Add(&aggregate->counts, &residents->counts);
+
+        int length;
+        CommerceCount *counts = Block_GetCommerceCounts(block, &length);
+        for (int i = 0; i < length; i++)
+            _addCommerceCount(aggregate, &counts[i]);
+    }
+    if (Block_GetX(block) + Block_GetW(block) <= Polygon_GetMaxX(polygon))
+        _executeAgrBlocks(tree, RBTreeN_GetRightChild(tree, node), polygon, aggregate);
 }
 
-bool Query_Dm(FILE *txtFile, char *cpf) {
-    Person person = HashTable_Find(getPersonTable(), cpf);
+static int _compareCommerceCounts(const void *a, const void *b) {
+    return strcmp(CommerceType_GetCode(((CommerceCount *) a)->type), 
+                  CommerceType_GetCode(((CommerceCount *) b)->type));
+}
+
+bool Query_Agr(City city, FILE *txtFile, char *baseDir, char *arqPolig) {
+    // O polígono pertence ao cache: liberá-lo com PolygonCache_Release, não destruí-lo
+    Polygon poly = PolygonCache_Get(baseDir, arqPolig);
+    if (poly == NULL)
+        return false;
+
+    Aggregate aggregate;
+    memset(&aggregate, 0, sizeof(Aggregate));
+    _executeAgrBlocks(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), poly, &aggregate);
+
+    static char *bands[PERSON_AGE_BANDS] = {"0 a 14", "15 a 29", "30 a 44", "45 a 59", "60 ou mais"};
+    fprintf(txtFile, "Quadras no polígono: %d\n", aggregate.blocks);
+    fprintf(txtFile, "Moradores: %d\n", aggregate.residents);
+    fprintf(txtFile, "\tmasculino: %d\n\tfeminino: %d\n", aggregate.counts.male, aggregate.counts.female);
+    for (int i = 0; i < PERSON_AGE_BANDS; i++)
+        fprintf(txtFile, "\t%s anos: %d\n", bands[i], aggregate.counts.ageBands[i]);
+    if (aggregate.counts.unknownAge > 0)
+        fprintf(txtFile, "\tidade desconhecida: %d\n", aggregate.counts.unknownAge);
+
+    fprintf(txtFile, "Estabelecimentos comerciais: %d\n", aggregate.commerces);
+    qsort(aggregate.commerceCounts, aggregate.commerceTypes, sizeof(CommerceCount), _compareCommerceCounts);
+    for (int i = 0; i < aggregate.commerceTypes; i++) {
+        CommerceType type = aggregate.commerceCounts[i].type;
+        fprintf(txtFile, "\t%s (%s): %d\n", CommerceType_GetCode(type), CommerceType_GetDescription(type),
+                aggregate.commerceCounts[i].count);
+    }
+    fputs("\n", txtFile);
+
+    free(aggregate.commerceCounts);
+    PolygonCache_Release(poly);
+    return true;
+}
+
+static int _compareCeps(const void *a, const void *b) {
+    return strcmp(*(char **) a, *(char **) b);
+}
+
+// Guarda o CEP (internado, então comparável pelo endereço) se ainda não estiver em 'ceps'
+static void _addCep(IntTable seen, char ***ceps, int *length, int *capacity, char *cep) {
+    if (cep == NULL || IntTable_Find(seen, (uintptr_t) cep) != NULL)
+        return;
+    IntTable_Insert(seen, (uintptr_t) cep, cep);
+    if (*length == *capacity) {
+        *capacity *= 2;
+        *ceps = realloc(*ceps, *capacity * sizeof(char *));
+    }
+    (*ceps)[(*length)++] = cep;
+}
+
+bool Query_Iso(City city, FILE *txtFile, FILE *outputFile, Point origin, bool quickest, double budget, char color[]) {
+    GraphNode start = findClosestNodeToPoint(city, origin);
+    if (start == NULL) {
+        fputs("Nenhum vértice no mapa\n\n", txtFile);
+        return true;
+    }
+
+    int length;
+    double *distances;
+    GraphNode *reached = findReachable(city, start, budget, quickest, &distances, &length);
+
+    putSVGPath(outputFile, Point_GetX(origin), Point_GetY(origin), GraphNode_GetX(start), GraphNode_GetY(start),
+               color, 3);
+    fprintf(txtFile, "Vértices alcançados: %d\n", length);
+    IntTable seen = IntTable_Create(64);
+    int cepCount = 0, cepCapacity = 16;
+    char **ceps = malloc(cepCapacity * sizeof(char *));
+    for (int i = 0; i < length; i++) {
+        fprintf(txtFile, "\t%s: %.2lf\n", GraphNode_GetId(reached[i]), distances[i]);
+        // Ruas percorridas por inteiro dentro do limite
+        for (GraphEdge edge = GraphNode_GetFirstEdge(reached[i]); edge != NULL; edge = GraphEdge_GetNext(edge)) {
+            if (distances[i] + GraphEdge_GetCost(edge, !quickest) > budget)
+                continue;
+            GraphNode target = GraphEdge_GetTarget(edge);
+            putSVGPath(outputFile, GraphNode_GetX(reached[i]), GraphNode_GetY(reached[i]),
+                       GraphNode_GetX(target), GraphNode_GetY(target), color, 3);
+            _addCep(seen, &ceps, &cepCount, &cepCapacity, GraphEdge_GetLeftCep(edge));
+            _addCep(seen, &ceps, &cepCount, &cepCapacity, GraphEdge_GetRightCep(edge));
+        }
+    }
+
+    // Quadras ao lado dessas ruas que ainda existem
+    qsort(ceps, cepCount, sizeof(char *), _compareCeps);
+    int blocks = 0;
+    for (int i = 0; i < cepCount; i++) {
+        if (HashTable_Find(City_GetBlockTable(city), ceps[i]) != NULL)
+            ceps[blocks++] = ceps[i];
+    }
+    fprintf(txtFile, "Quadras alcançadas: %d\n", blocks);
+    for (int i = 0; i < blocks; i++)
+        fprintf(txtFile, "\t%s\n", ceps[i]);
+    fputs("\n", txtFile);
+
+    IntTable_Destroy(seen, NULL);
+    free(ceps);
+    free(reached);
+    free(distances);
+    return true;
+}
+
+bool Query_Dm(City city, FILE *txtFile, char *cpf) {
+    Person person = IntTable_Find(City_GetPersonTable(city), Person_EncodeCpf(cpf));
     if (person == NULL) {
         fputs("Morador não encontrado\n\n", txtFile);
         return true;
@@ -1054,8 +1393,8 @@ bool Query_Dm(FILE *txtFile, char *cpf) {
     return true;
 }
 
-bool Query_De(FILE *txtFile, char *cnpj) {
-    Commerce commerce = HashTable_Find(getCommerceTable(), cnpj);
+bool Query_De(City city, FILE *txtFile, char *cnpj) {
+    Commerce commerce = HashTable_Find(City_GetCommerceTable(city), cnpj);
     if (commerce == NULL) {
         fputs("Estabelecimento não encontrado\n\n", txtFile);
         return true;
@@ -1068,8 +1407,8 @@ bool Query_De(FILE *txtFile, char *cnpj) {
     return true;
 }
 
-bool Query_Mud(FILE *txtFile, char *cpf, char *cep, char face, int num, char *compl) {
-    Person person = HashTable_Find(getPersonTable(), cpf);
+bool Query_Mud(City city, FILE *txtFile, char *cpf, char *cep, char face, int num, char *compl) {
+    Person person = IntTable_Find(City_GetPersonTable(city), Person_EncodeCpf(cpf));
     if (person == NULL) {
         fputs("Morador não encontrado\n\n", txtFile);
         return true;
@@ -1078,7 +1417,7 @@ bool Query_Mud(FILE *txtFile, char *cpf, char *cep, char face, int num, char *co
     char address[64];
     Building_MakeAddress(address, cep, face, num);
 
-    Block newBlock = HashTable_Find(getBlockTable(), cep);
+    Block newBlock = HashTable_Find(City_GetBlockTable(city), cep);
     if (newBlock == NULL) {
         fprintf(txtFile, "Quadra de CEP %s não encontrada\n\n", cep);
         return true;
@@ -1095,7 +1434,7 @@ bool Query_Mud(FILE *txtFile, char *cpf, char *cep, char face, int num, char *co
         Block_RemoveResident(Person_GetBlock(person), person);
     Person_SetBlock(person, newBlock);
     Person_SetBuilding(person, newBuilding);
-    Person_SetAddress(person, address);
+    Person_SetAddress(person, cep, face, num);
     Person_SetComplement(person, compl);
     if (newBuilding != NULL)
         Building_InsertResident(newBuilding, person);
@@ -1104,6 +1443,50 @@ bool Query_Mud(FILE *txtFile, char *cpf, char *cep, char face, int num, char *co
     return true;
 }
 
+// Estabelecimentos de um tipo em uma quadra
+typedef struct block_commerces_t {
+    Commerce *items;
+    int length, capacity;
+} BlockCommerces;
+
+static void _freeBlockCommerces(void *groupVoid) {
+    BlockCommerces *group = groupVoid;
+    free(group->items);
+    free(group);
+}
+
+// Agrupa por quadra, em 'groups', os estabelecimentos do tipo cujas quadras intersectam a caixa do
+// polígono, usando o índice espacial do tipo. Os prédios não usam o índice: não acompanham a
+// quadra quando ela é movida, então o retângulo guardado no índice não serve para eles
+static void _groupCommercesByBlock(CommerceType commType, Polygon polygon, IntTable groups) {
+    int length;
+    Commerce *found = CommerceType_FindInRect(commType, Polygon_GetMinX(polygon), Polygon_GetMinY(polygon),
+                                              Polygon_GetMaxX(polygon), Polygon_GetMaxY(polygon), &length);
+    for (int i = 0; i < length; i++) {
+        Block block = Commerce_GetBlock(found[i]);
+        BlockCommerces *group = IntTable_Find(groups, (uintptr_t) block);
+        if (group == NULL) {
+            group = calloc(1, sizeof(BlockCommerces));
+            IntTable_Insert(groups, (uintptr_t) block, group);
+        }
+        if (group->length == group->capacity) {
+            group->capacity = group->capacity == 0 ? 4 : group->capacity * 2;
+            group->items = realloc(group->items, group->capacity * sizeof(Commerce));
+        }
+        group->items[group->length++] = found[i];
+    }
+    free(found);
+}
+
+static void _dumpCommerce(Commerce commerce, int number, FILE *file) {
+    fprintf(file, "%d)\n", number);
+    Commerce_DumpToFile(commerce, file);
+    Person owner = Commerce_GetOwner(commerce);
+    if (owner != NULL) {
+        fprintf(file, "\tNome do proprietário: %s\n", Person_GetName(owner));
+    }
+}
+
 static int _dumpCommerces(RBTree tree, Node node, FILE *file, char *type, bool isBuilding) {
     if (node == NULL)
         return 0;
@@ -1113,29 +1496,73 @@ static int _dumpCommerces(RBTree tree, Node node, FILE *file, char *type, bool i
     CommerceType commType = Commerce_GetType(commerce);
     if (strcmp(type, "*") == 0 || strcmp(type, CommerceType_GetCode(commType)) == 0) {
         i++;
-        if (isBuilding || Commerce_GetBuilding(commerce) == NULL) {
-            fprintf(file, "%d)\n", i);
-            Commerce_DumpToFile(commerce, file);
-            Person owner = Commerce_GetOwner(commerce);
-            if (owner != NULL) {
-                fprintf(file, "\tNome do proprietário: %s\n", Person_GetName(owner));
-            }
-        }
+        if (isBuilding || Commerce_GetBuilding(commerce) == NULL)
+            _dumpCommerce(commerce, i, file);
     }
     i += _dumpCommerces(tree, RBTreeN_GetRightChild(tree, node), file, type, isBuilding);
     return i;
 }
 
-static void _executeEplgBlocks(RBTree tree, Node node, Polygon polygon, FILE *txtFile, FILE *outputFile, char *type) {
+static int _compareCommerceCnpjs(const void *a, const void *b) {
+    return strcmp(Commerce_GetCnpj(*(Commerce *) a), Commerce_GetCnpj(*(Commerce *) b));
+}
+
+// Como _dumpCommerces, mas visitando só os estabelecimentos do tipo da quadra ('group'), em ordem de
+// CNPJ. O número de cada um é o mesmo de _dumpCommerces: 1 + quantos do tipo estão na sua subárvore
+// esquerda, isto é, quantos têm o caminho a partir da raiz passando à esquerda do seu nó
+static int _dumpBlockCommerces(RBTree tree, BlockCommerces *group, FILE *file) {
+    qsort(group->items, group->length, sizeof(Commerce), _compareCommerceCnpjs);
+    CommerceType commType = Commerce_GetType(group->items[0]);
+    int *numbers = malloc(group->length * sizeof(int));
+    for (int i = 0; i < group->length; i++)
+        numbers[i] = 1;
+
+    for (int i = 0; i < group->length; i++) {
+        char *cnpj = Commerce_GetCnpj(group->items[i]);
+        Node node = RBTree_GetRoot(tree);
+        while (node != NULL) {
+            Commerce commerce = RBTreeN_GetValue(tree, node);
+            int cmpResult = strcmp(cnpj, Commerce_GetCnpj(commerce));
+            if (cmpResult == 0)
+                break;
+            if (cmpResult < 0) {
+                if (Commerce_GetType(commerce) == commType) {
+                    Commerce *ancestor = bsearch(&commerce, group->items, group->length, sizeof(Commerce),
+                                                 _compareCommerceCnpjs);
+                    numbers[ancestor - group->items]++;
+                }
+                node = RBTreeN_GetLeftChild(tree, node);
+            } else {
+                node = RBTreeN_GetRightChild(tree, node);
+            }
+        }
+    }
+
+    for (int i = 0; i < group->length; i++) {
+        if (Commerce_GetBuilding(group->items[i]) == NULL)
+            _dumpCommerce(group->items[i], numbers[i], file);
+    }
+    free(numbers);
+    return group->length;
+}
+
+// Com índice ('groups' != NULL), só visita os estabelecimentos do tipo agrupados por quadra
+static void _executeEplgBlocks(RBTree tree, Node node, Polygon polygon, FILE *txtFile, char *type, IntTable groups) {
     if (node == NULL)
         return;
     Block block = RBTreeN_GetValue(tree, node);
     if (Block_GetX(block) >= Polygon_GetMinX(polygon))
-        _executeEplgBlocks(tree, RBTreeN_GetLeftChild(tree, node), polygon, txtFile, outputFile, type);
+        _executeEplgBlocks(tree, RBTreeN_GetLeftChild(tree, node), polygon, txtFile, type, groups);
     if (Polygon_IsBlockInside(polygon, block, false)) {
-        RBTree commerces = Block_GetCommerces(block);
         fprintf(txtFile, "Estabelecimentos comerciais do tipo %s na quadra %s:\n", type, Block_GetCep(block));
-        int total = _dumpCommerces(commerces, RBTree_GetRoot(commerces), txtFile, type, false);
+        int total = 0;
+        if (groups == NULL) {
+            total = _dumpCommerces(Block_GetCommerces(block), RBTree_GetRoot(Block_GetCommerces(block)), txtFile, type, false);
+        } else {
+            BlockCommerces *group = IntTable_Find(groups, (uintptr_t) block);
+            if (group != NULL)
+                total = _dumpBlockCommerces(Block_GetCommerces(block), group, txtFile);
+        }
         if (total > 0) {
             if (strcmp(Block_GetCFill(block), "darkolivegreen") == 0)
                 Block_SetCFill(block, "indigo");
@@ -1144,7 +1571,7 @@ static void _executeEplgBlocks(RBTree tree, Node node, Polygon polygon, FILE *tx
         }
     }
     if (Block_GetX(block) + Block_GetW(block) <= Polygon_GetMaxX(polygon))
-        _executeEplgBlocks(tree, RBTreeN_GetRightChild(tree, node), polygon, txtFile, outputFile, type);
+        _executeEplgBlocks(tree, RBTreeN_GetRightChild(tree, node), polygon, txtFile, type, groups);
 }
 
 static void _executeEplgBuildings(RBTree tree, Node node, Polygon polygon, FILE *txtFile, char *type) {
@@ -1165,19 +1592,29 @@ static void _executeEplgBuildings(RBTree tree, Node node, Polygon polygon, FILE
         _executeEplgBuildings(tree, RBTreeN_GetRightChild(tree, node), polygon, txtFile, type);
 }
 
-bool Query_Eplg(FILE *txtFile, FILE *outputFile, char *baseDir, char *arqPolig, char *type) {
-    FILE *polyFile = openFile(baseDir, arqPolig, "r");
-    if (polyFile == NULL)
+bool Query_Eplg(City city, FILE *txtFile, FILE *outputFile, char *baseDir, char *arqPolig, char *type) {
+    // O polígono pertence ao cache: liberá-lo com PolygonCache_Release, não destruí-lo
+    Polygon poly = PolygonCache_Get(baseDir, arqPolig);
+    if (poly == NULL)
         return false;
-    
-    Polygon poly = Polygon_Create();
-    Polygon_ReadFromFile(poly, polyFile);
-    fclose(polyFile);
-    
-    _executeEplgBlocks(getBlockTree(), RBTree_GetRoot(getBlockTree()), poly, txtFile, outputFile, type);
-    _executeEplgBuildings(getBuildingTree(), RBTree_GetRoot(getBuildingTree()), poly, txtFile, type);
 
-    Polygon_Destroy(poly);
+    // Com um tipo específico, as quadras só visitam os estabelecimentos dele encontrados pelo índice
+    IntTable groups = NULL;
+    if (strcmp(type, "*") != 0) {
+        groups = IntTable_Create(64);
+        CommerceType commType = HashTable_Find(City_GetCommTypeTable(city), type);
+        if (commType != NULL)
+            _groupCommercesByBlock(commType, poly, groups);
+    }
+
+    _executeEplgBlocks(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), poly, txtFile, type, groups);
+    _executeEplgBuildings(City_GetBuildingTree(city), RBTree_GetRoot(City_GetBuildingTree(city)), poly, txtFile, type);
+
+    if (groups != NULL)
+        IntTable_Destroy(groups, _freeBlockCommerces);
+
+    PolygonCache_Release(poly);
+    return true;
 }
 
 static void _executeCatacBlocks(RBTree tree, Node node, Polygon polygon, ListNode **list) {
@@ -1216,29 +1653,28 @@ static void _executeCatacBuildings(RBTree tree, Node node, Polygon polygon, List
         _executeCatacBuildings(tree, RBTreeN_GetRightChild(tree, node), polygon, list);
 }
 
-static void _executeCatacResidents(RBTree tree, Node node, FILE *txtFile, bool removeFromTrees) {
-    if (node == NULL)
-        return;
-    Person person = RBTreeN_GetValue(tree, node);
-    _executeCatacResidents(tree, RBTreeN_GetLeftChild(tree, node), txtFile, removeFromTrees);
-
-    fprintf(txtFile, "\t- Pessoa %s\n", Person_GetCpf(person));
+static void _executeCatacResidents(City city, PersonList *residents, FILE *txtFile, bool removeFromTrees) {
+    for (int i = 0; i < residents->length; i++) {
+        Person person = residents->items[i];
 
-    if (Person_GetBlock(person) != NULL) {
-        if (removeFromTrees)
-            Block_RemoveResident(Person_GetBlock(person), person);
-        Person_SetBlock(person, NULL);
-    }
-    if (Person_GetBuilding(person) != NULL) {
-        //Building_RemoveResident(Person_GetBuilding(person), person);
-        Person_SetBuilding(person, NULL);
-    }
+        char cpf[PERSON_CPF_LENGTH];
+        Person_GetCpf(person, cpf);
+        fprintf(txtFile, "\t- Pessoa %s\n", cpf);
 
-    HashTable_Remove(getPersonTable(), Person_GetCpf(person));
+        if (Person_GetBlock(person) != NULL) {
+            if (removeFromTrees)
+                Block_RemoveResident(Person_GetBlock(person), person);
+            Person_SetBlock(person, NULL);
+        }
+        if (Person_GetBuilding(person) != NULL) {
+            //Building_RemoveResident(Person_GetBuilding(person), person);
+            Person_SetBuilding(person, NULL);
+        }
 
-    Person_Destroy(person);
+        IntTable_Remove(City_GetPersonTable(city), Person_GetCpfKey(person));
 
-    _executeCatacResidents(tree, RBTreeN_GetRightChild(tree, node), txtFile, removeFromTrees);
+        Person_Destroy(person);
+    }
 }
 
 static void _executeCatacEquips(RBTree tree, Node node, HashTable table, Polygon polygon, ListNode **list) {
@@ -1265,14 +1701,12 @@ static void _executeCatacEquips(RBTree tree, Node node, HashTable table, Polygon
         _executeCatacEquips(tree, RBTreeN_GetRightChild(tree, node), table, polygon, list);
 }
 
-bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig) {
-    FILE *polyFile = openFile(baseDir, arqPolig, "r");
-    if (polyFile == NULL)
+bool Query_Catac(City city, FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig) {
+    City_AdvanceEquipVersion(city);
+    // O polígono pertence ao cache: liberá-lo com PolygonCache_Release, não destruí-lo
+    Polygon poly = PolygonCache_Get(baseDir, arqPolig);
+    if (poly == NULL)
         return false;
-    
-    Polygon poly = Polygon_Create();
-    Polygon_ReadFromFile(poly, polyFile);
-    fclose(polyFile);
 
 
     fprintf(txtFile, "Itens removidos:\n");
@@ -1284,7 +1718,7 @@ bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig)
     ListNode *nodeP = node;
 
     // Preencher lista de prédios a serem removidos
-    _executeCatacBuildings(getBuildingTree(), RBTree_GetRoot(getBuildingTree()), poly, &nodeP);
+    _executeCatacBuildings(City_GetBuildingTree(city), RBTree_GetRoot(City_GetBuildingTree(city)), poly, &nodeP);
     
     // Descartar primeiro nó (vazio)
     ListNode *next = node->next;
@@ -1294,20 +1728,20 @@ bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig)
     while (node != NULL) {
         Building building = node->element;
 
-        RBTree residents = Building_GetResidents(building);
+        PersonList *residents = Building_GetResidents(building);
         // X nas diagonais do prédio
         putSVGCross(outputFile, building);
         // Número de residentes
         fprintf(outputFile, "<text x=\"%lf\" y=\"%lf\" font-size=\"12\">%d</text>",
                             Building_GetX(building) + Building_GetW(building) / 2,
                             Building_GetY(building) + Building_GetH(building) / 2,
-                            RBTree_GetLength(residents));
+                            residents->length);
 
         // Excluir residentes
-        _executeCatacResidents(residents, RBTree_GetRoot(residents), txtFile, true);
+        _executeCatacResidents(city, residents, txtFile, true);
         fprintf(txtFile, "\t- Prédio %s\n", Building_GetKey(building));
         // Remover prédio das estruturas
-        RBTree_Remove(getBuildingTree(), Building_GetPoint(building));
+        RBTree_Remove(City_GetBuildingTree(city), Building_GetPoint(building));
         RBTree_Remove(Block_GetBuildings(Building_GetBlock(building)), Building_GetKey(building));
 
         Building_Destroy(building);
@@ -1324,7 +1758,7 @@ bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig)
     nodeP = node;
 
     // Preencher lista de quadras a serem removidas
-    _executeCatacBlocks(getBlockTree(), RBTree_GetRoot(getBlockTree()), poly, &nodeP);
+    _executeCatacBlocks(City_GetBlockTree(city), RBTree_GetRoot(City_GetBlockTree(city)), poly, &nodeP);
     
     // Descartar primeiro nó (vazio)
     next = node->next;
@@ -1334,14 +1768,14 @@ bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig)
     while (node != NULL) {
         Block block = node->element;
 
-        RBTree residents = Block_GetResidents(block);
-
         // Excluir residentes
-        _executeCatacResidents(residents, RBTree_GetRoot(residents), txtFile, false);
+        _executeCatacResidents(city, Block_GetResidents(block), txtFile, false);
         fprintf(txtFile, "\t- Quadra %s\n", Block_GetCep(block));
         // Remover quadra das estruturas
-        RBTree_Remove(getBlockTree(), Block_GetPoint(block));
-        HashTable_Remove(getBlockTable(), Block_GetCep(block));
+        RBTree_Remove(City_GetBlockTree(city), Block_GetPoint(block));
+        HashTable_Remove(City_GetBlockTable(city), Block_GetCep(block));
+        // Os estabelecimentos da quadra saem do índice por tipo
+        _unindexBlockCommerces(block);
 
         Block_Destroy(block);
 
@@ -1357,9 +1791,9 @@ bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig)
     nodeP = node;
 
     // Preencher lista dos equipamentos urbanos a serem removidos
-    _executeCatacEquips(getHydTree(), RBTree_GetRoot(getHydTree()), getHydTable(), poly, &nodeP);
-    _executeCatacEquips(getCTowerTree(), RBTree_GetRoot(getCTowerTree()), getCTowerTable(), poly, &nodeP);
-    _executeCatacEquips(getTLightTree(), RBTree_GetRoot(getTLightTree()), getTLightTable(), poly, &nodeP);
+    _executeCatacEquips(City_GetHydTree(city), RBTree_GetRoot(City_GetHydTree(city)), City_GetHydTable(city), poly, &nodeP);
+    _executeCatacEquips(City_GetCTowerTree(city), RBTree_GetRoot(City_GetCTowerTree(city)), City_GetCTowerTable(city), poly, &nodeP);
+    _executeCatacEquips(City_GetTLightTree(city), RBTree_GetRoot(City_GetTLightTree(city)), City_GetTLightTable(city), poly, &nodeP);
 
     // Descartar primeiro nó (vazio)
     next = node->next;
@@ -1383,12 +1817,12 @@ bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig)
 
     // Desenhar polígono no SVG
     putSVGPolygon(outputFile, poly, "white");
-    Polygon_Destroy(poly);
 
+    PolygonCache_Release(poly);
     return true;
 }
 
-bool Query_Dmprbt(char *outputDir, char t, char *arq) {
+bool Query_Dmprbt(City city, char *outputDir, char t, char *arq) {
     strcat(arq, ".svg");
     FILE *file = openFile(outputDir, arq, "w");
     if (file == NULL)
@@ -1398,22 +1832,22 @@ bool Query_Dmprbt(char *outputDir, char t, char *arq) {
 
     switch (t) {
         case 'q':
-            putSVGRBTree(file, getBlockTree(), Block_Describe);
+            putSVGRBTree(file, City_GetBlockTree(city), Block_Describe);
             break;
         case 'h':
-            putSVGRBTree(file, getHydTree(), Equip_Describe);
+            putSVGRBTree(file, City_GetHydTree(city), Equip_Describe);
             break;
         case 's':
-            putSVGRBTree(file, getTLightTree(), Equip_Describe);
+            putSVGRBTree(file, City_GetTLightTree(city), Equip_Describe);
             break;
         case 't':
-            putSVGRBTree(file, getCTowerTree(), Equip_Describe);
+            putSVGRBTree(file, City_GetCTowerTree(city), Equip_Describe);
             break;
         case 'p':
-            putSVGRBTree(file, getBuildingTree(), Building_Describe);
+            putSVGRBTree(file, City_GetBuildingTree(city), Building_Describe);
             break;
         case 'm':
-            putSVGRBTree(file, getWallTree(), Wall_Describe);
+            putSVGRBTree(file, City_GetWallTree(city), Wall_Describe);
             break;
         default:
             printf("Árvore inexistente: %c!\n", t);
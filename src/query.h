@@ -13,60 +13,80 @@
 #include "modules/sig/geometry.h"
 #include "modules/sig/object.h"
 #include "modules/util/file_util.h"
+#include "modules/util/polygon_cache.h"
 #include "modules/util/svg.h"
-#include "data.h"
+#include "city.h"
+#include "pathfind.h"
 
 // T1
-bool Query_Overlaps(FILE *txtFile, FILE *outputFile, char idA[], char idB[]);
+bool Query_Overlaps(City city, FILE *txtFile, FILE *outputFile, char idA[], char idB[]);
 
-bool Query_Inside(FILE *txtFile, FILE *outputFile, char id[], double x, double y);
+bool Query_Inside(City city, FILE *txtFile, FILE *outputFile, char id[], double x, double y);
 
-bool Query_Distance(FILE *txtFile, FILE *outputFile, char j[], char k[]);
+bool Query_Distance(City city, FILE *txtFile, FILE *outputFile, char j[], char k[]);
 
-bool Query_Bb(FILE *txtFile, FILE *outputFile, char outputDir[], char svgFileName[], char suffix[], char color[]);
+bool Query_Bb(City city, FILE *txtFile, FILE *outputFile, char outputDir[], char svgFileName[], char suffix[], char color[]);
 /* ------------------------*/
 
 // T2
-bool Query_Dq(FILE *txtFile, char metric[], char id[], double dist);
+bool Query_Dq(City city, FILE *txtFile, char metric[], char id[], double dist);
 
-bool Query_Del(FILE *txtFile, char id[]);
+bool Query_Del(City city, FILE *txtFile, char id[]);
 
-bool Query_Cbq(FILE *txtFile, double x, double y, double r, char cStrk[]);
+bool Query_Cbq(City city, FILE *txtFile, double x, double y, double r, char cStrk[]);
 
-bool Query_Crd(FILE *txtFile, char id[]);
+bool Query_Crd(City city, FILE *txtFile, char id[]);
 
-bool Query_Trns(FILE *txtFile, double x, double y, double w, double h, double dx, double dy);
+bool Query_Trns(City city, FILE *txtFile, double x, double y, double w, double h, double dx, double dy);
 /* ------------------------*/
 
 // T3
-bool Query_Brl(FILE *outputFile, double x, double y);
+bool Query_Brl(City city, FILE *outputFile, double x, double y);
 
-bool Query_Fi(FILE *txtFile, FILE *outputFile, double x, double y, int ns, double r);
+bool Query_Fi(City city, FILE *txtFile, FILE *outputFile, double x, double y, int ns, double r);
 
-bool Query_Fh(FILE *txtFile, FILE *outputFile, char signal, int k, char cep[], char face, double num);
+bool Query_Fh(City city, FILE *txtFile, FILE *outputFile, char signal, int k, char cep[], char face, double num);
 
-bool Query_Fs(FILE *txtFile, FILE *outputFile, int k, char cep[], char face, double num);
+bool Query_Fs(City city, FILE *txtFile, FILE *outputFile, int k, char cep[], char face, double num);
+
+// Equipamento do tipo dado (h, s ou rb) mais próximo do endereço pelas ruas, por comprimento ou
+// tempo, com o caminho desenhado em 'color'. Os vértices de todos os equipamentos ficam rotulados
+// num mapa guardado na cidade até a próxima alteração (ver FacilityMap)
+bool Query_Nf(City city, FILE *txtFile, FILE *outputFile, char type[], bool quickest, char cep[], char face, double num,
+              char color[]);
 /* ------------------------*/
 
 // T4
 
-bool Query_Brn(FILE *txtFile, FILE *outputFile, double x, double y, char *outputDir, char *arqPol);
+bool Query_Brn(City city, FILE *txtFile, FILE *outputFile, double x, double y, char *outputDir, char *arqPol);
+
+// Rota de fuga de cada quadra atingida pelo polígono gravado por um brn (no diretório de saída): do
+// vértice mais próximo do centro da quadra até o vértice de fora mais próximo (ver findExits)
+bool Query_Evac(City city, FILE *txtFile, FILE *outputFile, char *outputDir, char *arqPol, char *color);
+
+bool Query_M(City city, FILE *txtFile, char *cep);
+
+bool Query_Mplg(City city, FILE *txtFile, FILE *outputFile, char* baseDir, char *arqPolig);
 
-bool Query_M(FILE *txtFile, char *cep);
+// Soma as contagens mantidas das quadras no polígono (moradores por sexo e faixa etária e
+// estabelecimentos por tipo), sem percorrer pessoas nem estabelecimentos
+bool Query_Agr(City city, FILE *txtFile, char *baseDir, char *arqPolig);
 
-bool Query_Mplg(FILE *txtFile, FILE *outputFile, char* baseDir, char *arqPolig);
+// Vértices alcançáveis pelas ruas a partir do vértice mais próximo de 'origin' com comprimento ou
+// tempo até 'budget', e as quadras ao lado das ruas percorridas por inteiro, desenhadas em 'color'
+bool Query_Iso(City city, FILE *txtFile, FILE *outputFile, Point origin, bool quickest, double budget, char color[]);
 
-bool Query_Dm(FILE *txtFile, char *cpf);
+bool Query_Dm(City city, FILE *txtFile, char *cpf);
 
-bool Query_De(FILE *txtFile, char *cnpj);
+bool Query_De(City city, FILE *txtFile, char *cnpj);
 
-bool Query_Mud(FILE *txtFile, char *cpf, char *cep, char face, int num, char *compl);
+bool Query_Mud(City city, FILE *txtFile, char *cpf, char *cep, char face, int num, char *compl);
 
-bool Query_Eplg(FILE *txtFile, FILE *outputFile, char *baseDir, char *arqPolig, char *type);
+bool Query_Eplg(City city, FILE *txtFile, FILE *outputFile, char *baseDir, char *arqPolig, char *type);
 
-bool Query_Catac(FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig);
+bool Query_Catac(City city, FILE *outputFile, FILE *txtFile, char *baseDir, char *arqPolig);
 
-bool Query_Dmprbt(char *outputDir, char t, char *arq);
+bool Query_Dmprbt(City city, char *outputDir, char t, char *arq);
 /* ------------------------*/
 
 #endif
\ No newline at end of file
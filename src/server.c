@@ -0,0 +1,481 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <dirent.h>
+
+#include "server.h"
+
+// Cada conexão é atendida por uma thread. Os dados são mantidos em duas cópias (réplicas) da
+// cidade, e uma delas é a publicada: um trabalho só de leitura (isReadOnlyCommand) fixa a réplica
+// publicada ao começar e roda sobre ela até o fim, sem esperar por ninguém. Um trabalho com
+// alterações (um por vez) roda sobre a outra réplica, que ninguém lê, e a publica como a versão
+// seguinte. Depois de responder, espera os leitores que ainda usam a versão anterior terminarem e
+// repete o mesmo trabalho nela, com as saídas descartadas, para que as duas voltem a ser iguais.
+// Assim um escritor nunca bloqueia os leitores, ao custo do dobro de memória e de refazer cada
+// trabalho de escrita
+static City replicas[2];
+static int published = 0;
+static int pinned[2] = {0, 0};
+static pthread_mutex_t publishMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t unpinnedCond = PTHREAD_COND_INITIALIZER;
+
+// Trabalhos com alterações, executados um de cada vez
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Resultado do trabalho de escrita em andamento, conferido na repetição: versão produzida e
+// resumo do .txt gerado. Se a repetição der outro resultado (um polígono que não abriu, por
+// exemplo), as réplicas deixaram de ser iguais; a publicada continua atendendo as leituras, mas
+// novas escritas são recusadas, pois publicariam a réplica errada. Protegidos por writerMutex
+static unsigned long writeVersion = 0;
+static unsigned long writeChecksum = 0;
+static bool replicasDiverged = false;
+
+// Diretório temporário que recebe as saídas das repetições nas réplicas
+static char replayDir[] = "/tmp/siguel-XXXXXX";
+
+// Conexões ativas, aguardadas antes de encerrar o servidor; 'stopping' também é protegido por activeMutex
+static pthread_mutex_t activeMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t activeCond = PTHREAD_COND_INITIALIZER;
+static int activeConnections = 0;
+static bool stopping = false;
+
+static int serverSocket = -1;
+
+static void _closeQueryFiles(Files files) {
+    FILE *opened[] = {Files_GetQueryFile(files), Files_GetTxtFile(files), Files_GetOutputQryFile(files)};
+    for (int i = 0; i < 3; i++) {
+        if (opened[i] != NULL)
+            fclose(opened[i]);
+    }
+}
+
+typedef struct connection_t {
+    int fd;
+    char *baseDir;
+    char *entryFileName;
+    char *outputDir;
+} Connection;
+
+static bool _isStopping() {
+    pthread_mutex_lock(&activeMutex);
+    bool result = stopping;
+    pthread_mutex_unlock(&activeMutex);
+    return result;
+}
+
+// Fixa a réplica publicada, que não muda enquanto estiver fixada
+static int _pin() {
+    pthread_mutex_lock(&publishMutex);
+    int replica = published;
+    pinned[replica]++;
+    pthread_mutex_unlock(&publishMutex);
+    return replica;
+}
+
+static void _unpin(int replica) {
+    pthread_mutex_lock(&publishMutex);
+    if (--pinned[replica] == 0)
+        pthread_cond_broadcast(&unpinnedCond);
+    pthread_mutex_unlock(&publishMutex);
+}
+
+// Publica a réplica 'replica'; novos leitores passam a usá-la
+static void _publish(int replica) {
+    pthread_mutex_lock(&publishMutex);
+    published = replica;
+    pthread_mutex_unlock(&publishMutex);
+}
+
+// Espera a réplica 'replica' (já não publicada) deixar de ser usada
+static void _waitUnpinned(int replica) {
+    pthread_mutex_lock(&publishMutex);
+    while (pinned[replica] > 0)
+        pthread_cond_wait(&unpinnedCond, &publishMutex);
+    pthread_mutex_unlock(&publishMutex);
+}
+
+// Caminho completo de um arquivo de saída, como em openFile
+static void _outputPath(char *out, int size, char *outputDir, char *fileName) {
+    if (outputDir[strlen(outputDir) - 1] == '/')
+        snprintf(out, size, "%s%s", outputDir, fileName);
+    else
+        snprintf(out, size, "%s/%s", outputDir, fileName);
+}
+
+// Caminho do .txt gerado pela consulta de 'files'
+static void _txtPath(char *out, int size, Files files) {
+    char txtName[128];
+    strcpy(txtName, Files_GetQrySVGFileName(files));
+    changeExtension(txtName, "txt");
+    _outputPath(out, size, Files_GetOutputDir(files), txtName);
+}
+
+// Resumo (hash djb2) do .txt gerado pela consulta de 'files', para comparar as duas execuções
+static unsigned long _txtChecksum(Files files) {
+    char path[256];
+    _txtPath(path, 256, files);
+    FILE *txtFile = fopen(path, "r");
+    if (txtFile == NULL)
+        return 0;
+    unsigned long hash = 5381;
+    int c;
+    while ((c = fgetc(txtFile)) != EOF)
+        hash = hash * 33 + c;
+    fclose(txtFile);
+    return hash;
+}
+
+// Prepara a repetição do arquivo de consulta (que processAndGenerateQuery fecha) na outra réplica:
+// uma cópia dele, o mesmo diretório de entrada (dos polígonos) e saídas no diretório temporário.
+// Retorna NULL se não for possível
+static Files _prepareReplay(FILE *queryFile, char *baseDir, char *entryFileName) {
+    FILE *copy = tmpfile();
+    if (copy == NULL)
+        return NULL;
+    char buffer[128];
+    while (fgets(buffer, 128, queryFile) != NULL)
+        fputs(buffer, copy);
+    rewind(queryFile);
+    rewind(copy);
+
+    Files files = Files_Create();
+    Files_SetBaseDir(files, baseDir);
+    Files_SetOutputDir(files, replayDir);
+    Files_SetQueryFile(files, copy);
+    if (!Files_OpenQueryOutputs(files, entryFileName, "replica.qry")) {
+        _closeQueryFiles(files);
+        Files_Destroy(files);
+        return NULL;
+    }
+    return files;
+}
+
+// Executa a consulta já aberta em 'files', guardando em 'version' a versão dos dados produzida ou
+// usada. Se a consulta altera a cidade, 'replay' recebe sua repetição, a ser terminada por
+// _finishWrite depois da resposta (o escritor continua exclusivo até lá). Retorna false (com os
+// arquivos fechados e o motivo em 'error') se a consulta não pôde ser executada
+static bool _runQuery(Files files, char *entryFileName, unsigned long *version, Files *replay, char **error) {
+    *replay = NULL;
+    if (isReadOnlyQuery(Files_GetQueryFile(files))) {
+        int replica = _pin();
+        processAndGenerateQuery(replicas[replica], files, ALL, NULL);
+        *version = City_GetVersion(replicas[replica]);
+        _unpin(replica);
+        return true;
+    }
+
+    *replay = _prepareReplay(Files_GetQueryFile(files), Files_GetBaseDir(files), entryFileName);
+    if (*replay == NULL) {
+        *error = "não foi possível preparar a repetição da consulta na réplica";
+        _closeQueryFiles(files);
+        return false;
+    }
+
+    pthread_mutex_lock(&writerMutex);
+    if (replicasDiverged) {
+        pthread_mutex_unlock(&writerMutex);
+        *error = "as réplicas divergiram; consultas com alterações estão desativadas";
+        _closeQueryFiles(*replay);
+        Files_Destroy(*replay);
+        *replay = NULL;
+        _closeQueryFiles(files);
+        return false;
+    }
+    int next = 1 - published;
+    processAndGenerateQuery(replicas[next], files, ALL, NULL);
+    *version = City_GetVersion(replicas[next]);
+    writeVersion = *version;
+    writeChecksum = _txtChecksum(files);
+    _publish(next);
+    return true;
+}
+
+// Repete o trabalho de escrita na réplica anterior, quando ela deixar de ser usada, confere se o
+// resultado é o mesmo e libera o próximo escritor
+static void _finishWrite(Files replay) {
+    int previous = 1 - published;
+    _waitUnpinned(previous);
+    Stats_SetPaused(true);
+    processAndGenerateQuery(replicas[previous], replay, ALL, NULL);
+    Stats_SetPaused(false);
+    if (City_GetVersion(replicas[previous]) != writeVersion || _txtChecksum(replay) != writeChecksum) {
+        fprintf(stderr, "ERRO: a repetição da consulta na réplica deu resultado diferente (versão %lu, "
+                        "esperada %lu); consultas com alterações serão recusadas\n",
+                        City_GetVersion(replicas[previous]), writeVersion);
+        replicasDiverged = true;
+    }
+    pthread_mutex_unlock(&writerMutex);
+    Files_Destroy(replay);
+}
+
+// Carrega em 'replica' os mesmos dados da cidade principal: relê as entradas de 'files' e refaz a
+// consulta inicial, se houver, com as saídas no diretório temporário
+static bool _loadReplica(City replica, Files files, char *baseDir, char *entryFileName, char *queryFileName) {
+    Files replicaFiles = Files_Create();
+    Files_SetOutputDir(replicaFiles, replayDir);
+    FILE *inputs[] = {Files_GetEntryFile(files), Files_GetPmFile(files), Files_GetEcFile(files), Files_GetViaFile(files)};
+    for (int i = 0; i < 4; i++) {
+        if (inputs[i] != NULL)
+            rewind(inputs[i]);
+    }
+    Files_SetEntryFile(replicaFiles, inputs[0]);
+    Files_SetPmFile(replicaFiles, inputs[1]);
+    Files_SetEcFile(replicaFiles, inputs[2]);
+    Files_SetViaFile(replicaFiles, inputs[3]);
+
+    FILE *svgFile = openFile(replayDir, "replica.svg", "w");
+    if (svgFile == NULL || (queryFileName != NULL
+            && !Files_OpenQueryFiles(replicaFiles, baseDir, entryFileName, queryFileName))) {
+        if (svgFile != NULL)
+            fclose(svgFile);
+        Files_Destroy(replicaFiles);
+        return false;
+    }
+    Files_SetOutputSVGFile(replicaFiles, svgFile);
+
+    Stats_SetPaused(true);
+    processAll(replica, replicaFiles);
+    Stats_SetPaused(false);
+    fclose(svgFile);
+    Files_Destroy(replicaFiles);
+    return true;
+}
+
+// Apaga o diretório temporário e as saídas das réplicas
+static void _removeReplayDir() {
+    DIR *dir = opendir(replayDir);
+    if (dir != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                char *path = joinPath(replayDir, entry->d_name);
+                unlink(path);
+                free(path);
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(replayDir);
+}
+
+static void _replyOk(FILE *response, Files files, unsigned long version) {
+    char path[256];
+    fprintf(response, "ok\n");
+    _txtPath(path, 256, files);
+    fprintf(response, "txt %s\n", path);
+    _outputPath(path, 256, Files_GetOutputDir(files), Files_GetQrySVGFileName(files));
+    fprintf(response, "svg %s\n", path);
+    fprintf(response, "versao %lu\n", version);
+    fprintf(response, ".\n");
+}
+
+static void _runAndReply(FILE *response, Files files, char *entryFileName) {
+    unsigned long version;
+    Files replay;
+    char *error;
+    if (!_runQuery(files, entryFileName, &version, &replay, &error)) {
+        fprintf(response, "erro %s\n", error);
+        return;
+    }
+    _replyOk(response, files, version);
+    if (replay != NULL) {
+        // O cliente não espera a repetição
+        fflush(response);
+        _finishWrite(replay);
+    }
+}
+
+// Executa um arquivo de consulta do diretório de entrada
+static void _runQueryFile(FILE *response, Files files, char *baseDir, char *entryFileName, char *qryFileName) {
+    if (!Files_OpenQueryFiles(files, baseDir, entryFileName, qryFileName)) {
+        fprintf(response, "erro não foi possível abrir '%s'\n", qryFileName);
+        return;
+    }
+    _runAndReply(response, files, entryFileName);
+}
+
+// Lê as linhas de consulta enviadas pelo cliente até "." e as executa como o arquivo <nome>.qry
+static bool _runInlineQuery(FILE *request, FILE *response, Files files, char *entryFileName, char *name) {
+    FILE *queryFile = tmpfile();
+    if (queryFile == NULL) {
+        fprintf(response, "erro não foi possível criar arquivo temporário\n");
+        return false;
+    }
+
+    char buffer[128];
+    bool finished = false;
+    while (fgets(buffer, 128, request) != NULL) {
+        if (strcmp(buffer, ".\n") == 0 || strcmp(buffer, ".\r\n") == 0 || strcmp(buffer, ".") == 0) {
+            finished = true;
+            break;
+        }
+        fputs(buffer, queryFile);
+    }
+    if (!finished) {
+        // Conexão encerrada antes do fim da consulta
+        fclose(queryFile);
+        return false;
+    }
+    rewind(queryFile);
+
+    char qryFileName[64];
+    snprintf(qryFileName, 64, "%s.qry", name);
+    Files_SetQueryFile(files, queryFile);
+    if (!Files_OpenQueryOutputs(files, entryFileName, qryFileName)) {
+        fclose(queryFile);
+        fprintf(response, "erro não foi possível criar as saídas de '%s'\n", name);
+        return true;
+    }
+    _runAndReply(response, files, entryFileName);
+    return true;
+}
+
+// Atende uma conexão até o cliente encerrá-la
+static void *_serveConnection(void *connectionVoid) {
+    Connection *connection = (Connection *) connectionVoid;
+
+    // Arquivos próprios da conexão, para que consultas simultâneas não compartilhem saídas
+    // Os polígonos das consultas enviadas pelo cliente também são lidos do diretório de entrada
+    Files files = Files_Create();
+    Files_SetBaseDir(files, connection->baseDir);
+    Files_SetOutputDir(files, connection->outputDir);
+
+    FILE *request = fdopen(connection->fd, "r");
+    FILE *response = fdopen(dup(connection->fd), "w");
+    if (request == NULL || response == NULL) {
+        perror("Erro ao abrir conexão");
+        if (request != NULL)
+            fclose(request);
+        else
+            close(connection->fd);
+        if (response != NULL)
+            fclose(response);
+    } else {
+        char buffer[128];
+        while (fgets(buffer, 128, request) != NULL) {
+            char command[16] = "", argument[64] = "";
+            sscanf(buffer, "%15s %63[^\r\n]", command, argument);
+
+            if (strcmp(command, "q") == 0 && argument[0] != '\0') {
+                _runQueryFile(response, files, connection->baseDir, connection->entryFileName, argument);
+            } else if (strcmp(command, "l") == 0 && argument[0] != '\0') {
+                if (!_runInlineQuery(request, response, files, connection->entryFileName, argument))
+                    break;
+            } else if (strcmp(command, "sai") == 0) {
+                // Parar de aceitar conexões; as que estão ativas terminam normalmente
+                pthread_mutex_lock(&activeMutex);
+                stopping = true;
+                pthread_mutex_unlock(&activeMutex);
+                shutdown(serverSocket, SHUT_RDWR);
+                fprintf(response, "ok\n.\n");
+                break;
+            } else if (command[0] != '\0') {
+                fprintf(response, "erro comando não reconhecido: '%s'\n", command);
+            }
+            fflush(response);
+        }
+        fclose(response);
+        fclose(request);
+    }
+
+    Files_Destroy(files);
+    free(connection);
+
+    pthread_mutex_lock(&activeMutex);
+    activeConnections--;
+    pthread_cond_signal(&activeCond);
+    pthread_mutex_unlock(&activeMutex);
+    return NULL;
+}
+
+bool startServer(City city, City replica, Files files, char *baseDir, char *entryFileName, char *queryFileName,
+                 char *socketPath) {
+    struct sockaddr_un address;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        printf("Caminho do socket muito longo: '%s'\n", socketPath);
+        return false;
+    }
+
+    if (mkdtemp(replayDir) == NULL) {
+        perror("Erro ao criar diretório temporário");
+        return false;
+    }
+    if (!_loadReplica(replica, files, baseDir, entryFileName, queryFileName)) {
+        printf("Erro ao carregar a réplica dos dados\n");
+        _removeReplayDir();
+        return false;
+    }
+    replicas[0] = city;
+    replicas[1] = replica;
+
+    serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverSocket < 0) {
+        perror("Erro ao criar socket");
+        _removeReplayDir();
+        return false;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+    unlink(socketPath);
+
+    if (bind(serverSocket, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(serverSocket, 16) < 0) {
+        perror("Erro ao abrir socket");
+        close(serverSocket);
+        _removeReplayDir();
+        return false;
+    }
+
+    // Um cliente que desconecta no meio da resposta não deve derrubar o servidor
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("-- MODO SERVIDOR (%s) --\n", socketPath);
+    fflush(stdout);
+
+    while (!_isStopping()) {
+        int fd = accept(serverSocket, NULL, NULL);
+        if (fd < 0) {
+            if (!_isStopping())
+                perror("Erro ao aceitar conexão");
+            continue;
+        }
+
+        Connection *connection = malloc(sizeof(Connection));
+        connection->fd = fd;
+        connection->baseDir = baseDir;
+        connection->entryFileName = entryFileName;
+        connection->outputDir = Files_GetOutputDir(files);
+
+        pthread_mutex_lock(&activeMutex);
+        activeConnections++;
+        pthread_mutex_unlock(&activeMutex);
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, _serveConnection, connection) != 0) {
+            perror("Erro ao criar thread");
+            close(fd);
+            free(connection);
+            pthread_mutex_lock(&activeMutex);
+            activeConnections--;
+            pthread_mutex_unlock(&activeMutex);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+
+    // Esperar as conexões ativas terminarem antes de liberar os dados
+    pthread_mutex_lock(&activeMutex);
+    while (activeConnections > 0)
+        pthread_cond_wait(&activeCond, &activeMutex);
+    pthread_mutex_unlock(&activeMutex);
+
+    close(serverSocket);
+    unlink(socketPath);
+    _removeReplayDir();
+    return true;
+}
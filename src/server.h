@@ -0,0 +1,26 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "modules/util/files.h"
+#include "commands.h"
+
+// Atende consultas sobre a cidade 'city', já carregada, por um socket de domínio Unix no caminho 'socketPath'.
+// 'replica' é uma cidade vazia, criada com as mesmas configurações, que recebe uma segunda cópia
+// dos dados (relendo as entradas de 'files' e a consulta 'queryFileName', se houver): trabalhos de
+// leitura rodam sobre a cópia publicada, mesmo durante um trabalho que altera a cidade, e este roda
+// na outra cópia e a publica ao terminar. Cada conexão envia comandos, um por linha:
+//   q <arq.qry>      executa o arquivo de consulta (relativo ao diretório de entrada)
+//   l <nome>         executa as linhas seguintes, até uma linha contendo apenas ".", como
+//                    se fossem o arquivo de consulta <nome>.qry
+//   sai              encerra o servidor
+// Cada comando é respondido com "ok" seguido das linhas "txt <caminho>" e "svg <caminho>" dos
+// arquivos gerados, "versao <n>" (versão dos dados após o trabalho) e uma linha ".", ou com
+// "erro <mensagem>"
+bool startServer(City city, City replica, Files files, char *baseDir, char *entryFileName, char *queryFileName,
+                 char *socketPath);
+
+#endif
@@ -0,0 +1,52 @@
+// Cliente mínimo do modo servidor do siguel, usado pelos testes: envia a entrada padrão pelo
+// socket e escreve as respostas na saída padrão até o servidor encerrar a conexão.
+//
+// Uso: client <socket>
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s <socket>\n", argv[0]);
+        return 1;
+    }
+
+    struct sockaddr_un address;
+    if (strlen(argv[1]) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Caminho do socket muito longo: '%s'\n", argv[1]);
+        return 1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, argv[1]);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *) &address, sizeof(address)) < 0) {
+        perror("Erro ao conectar");
+        return 1;
+    }
+
+    // O servidor atende as linhas em ordem, então o pedido inteiro pode ser enviado de uma vez
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+        if (write(fd, buffer, length) != (ssize_t) length) {
+            perror("Erro ao enviar");
+            close(fd);
+            return 1;
+        }
+    }
+    shutdown(fd, SHUT_WR);
+
+    ssize_t received;
+    while ((received = read(fd, buffer, sizeof(buffer))) > 0)
+        fwrite(buffer, 1, received, stdout);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#!/bin/sh
+# Teste do modo servidor: um trabalho de escrita que lê um polígono do diretório de entrada (catac)
+# é repetido na outra réplica, e a réplica publicada pela escrita seguinte não pode trazer de volta
+# a quadra removida.
+#
+# Uso (a partir de src/): sh tests/server_replay.sh
+
+SIGUEL=./siguel
+CLIENT=tests/client
+
+if [ ! -x "$SIGUEL" ] || [ ! -x "$CLIENT" ]; then
+    echo "Compile antes com 'make test'"
+    exit 1
+fi
+
+dir=$(mktemp -d /tmp/siguel-teste-XXXXXX)
+mkdir "$dir/saida"
+trap 'rm -rf "$dir"' EXIT
+
+cat > "$dir/cidade.geo" <<FIM
+nx 1000 1000 1000 1000 1000 1000 1000
+cq green black 2
+q b1.1 20 20 100 80
+q b1.2 200 20 100 80
+FIM
+
+# Envolve apenas a quadra b1.1
+cat > "$dir/pol.txt" <<FIM
+10 10
+130 10
+130 110
+10 110
+FIM
+
+$SIGUEL -e "$dir" -f cidade.geo -o "$dir/saida" -server "$dir/s.sock" > "$dir/servidor.log" 2>&1 &
+server=$!
+tries=0
+while [ ! -S "$dir/s.sock" ]; do
+    tries=$((tries + 1))
+    if [ $tries -gt 50 ] || ! kill -0 $server 2> /dev/null; then
+        echo "Falha: o servidor não iniciou"
+        cat "$dir/servidor.log"
+        exit 1
+    fi
+    sleep 0.1
+done
+
+# catac publica a versão 1; cbq roda na réplica onde catac foi repetido e a publica (versão 2)
+$CLIENT "$dir/s.sock" > "$dir/respostas.txt" <<FIM
+l remove
+catac pol.txt
+.
+l altera
+cbq 250 60 10 red
+.
+l consulta
+crd? b1.1
+crd? b1.2
+.
+sai
+FIM
+wait $server
+
+failed=0
+if [ "$(grep -c '^ok' "$dir/respostas.txt")" -ne 4 ]; then
+    echo "Falha: o servidor não respondeu 'ok' a todos os pedidos"
+    failed=1
+fi
+if grep -q "^ERRO" "$dir/servidor.log"; then
+    echo "Falha: as réplicas divergiram"
+    failed=1
+fi
+if [ "$(grep -c 'Elemento não encontrado' "$dir/saida/cidade-consulta.txt")" -ne 1 ] \
+        || ! grep -q "Quadra" "$dir/saida/cidade-consulta.txt"; then
+    echo "Falha: a réplica publicada não reflete o catac"
+    failed=1
+fi
+
+if [ $failed -ne 0 ]; then
+    cat "$dir/respostas.txt" "$dir/servidor.log" "$dir/saida/cidade-consulta.txt"
+    exit 1
+fi
+echo "ok: server_replay"